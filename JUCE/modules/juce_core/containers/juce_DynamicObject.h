@@ -46,6 +46,8 @@ public:
 
     using Ptr = ReferenceCountedObjectPtr<DynamicObject>;
 
+    JUCE_ALLOCATE_FROM_ARENA
+
     //==============================================================================
     /** Returns true if the object has a property with this name.
         Note that if the property is actually a method, this will return false.
@@ -416,6 +416,7 @@ public:
     {
         RefCountedArray (const Array<var>& a)  : array (a)  { incReferenceCount(); }
         RefCountedArray (Array<var>&& a)  : array (std::move (a)) { incReferenceCount(); }
+        JUCE_ALLOCATE_FROM_ARENA
         Array<var> array;
     };
 };
@@ -194,6 +194,14 @@
 #define JUCE_ENABLE_AUDIO_GUARD 0
 #endif
 
+/** Config: JUCE_ENABLE_ALLOCATION_ARENA
+	If enabled, String, HeapBlock, var array and DynamicObject allocations can be redirected into a
+	preallocated AllocationArena. This adds a small header to each of these allocations.
+*/
+#ifndef JUCE_ENABLE_ALLOCATION_ARENA
+#define JUCE_ENABLE_ALLOCATION_ARENA 0
+#endif
+
 //==============================================================================
 //==============================================================================
 
@@ -258,6 +266,7 @@ namespace juce
 #include "text/juce_StringRef.h"
 #include "logging/juce_Logger.h"
 #include "logging/juce_AudioThreadGuard.h"
+#include "memory/juce_AllocationArena.h"
 #include "memory/juce_LeakedObjectDetector.h"
 #include "memory/juce_ContainerDeletePolicy.h"
 #include "memory/juce_HeapBlock.h"
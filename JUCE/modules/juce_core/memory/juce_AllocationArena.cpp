@@ -0,0 +1,522 @@
+/*
+==============================================================================
+
+This file is part of the JUCE library.
+Copyright (c) 2017 - ROLI Ltd.
+
+JUCE is an open source library subject to commercial or open-source
+licensing.
+
+The code included in this file is provided under the terms of the ISC license
+http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+To use, copy, modify, and/or distribute this software for any purpose with or
+without fee is hereby granted provided that the above copyright notice and
+this permission notice appear in all copies.
+
+JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+DISCLAIMED.
+
+==============================================================================
+*/
+
+namespace juce
+{
+
+#if JUCE_ENABLE_ALLOCATION_ARENA
+
+/** The header in front of every allocation. The size is padded so that the data keeps the malloc alignment. */
+struct AllocationArena::Header
+{
+	enum
+	{
+		Alignment = 16
+	};
+
+	static size_t getPaddedSize(size_t numBytes) noexcept
+	{
+		return (numBytes + Alignment - 1) & ~(size_t)(Alignment - 1);
+	}
+
+	static Header* fromData(void* data) noexcept
+	{
+		return reinterpret_cast<Header*>(static_cast<char*>(data) - Alignment);
+	}
+
+	void* getData() noexcept
+	{
+		return reinterpret_cast<char*>(this) + Alignment;
+	}
+
+	/** nullptr if the memory was allocated on the heap. */
+	AllocationArena* owner;
+
+	/** The number of bytes that were requested. */
+	size_t numBytes;
+};
+
+static thread_local AllocationArena* currentAllocationArena = nullptr;
+
+AllocationArena::AllocationArena(size_t numBytes) :
+	storage(nullptr),
+	size(Header::getPaddedSize(numBytes)),
+	numReferences(0),
+	numLiveAllocations(0),
+	highWaterMark(0),
+	numHeapFallbacks(0),
+	numHeapFallbackBytes(0),
+	numPinnedResets(0)
+{
+	static_assert(sizeof(Header) <= Header::Alignment, "Header too big");
+
+	storage = static_cast<char*>(std::malloc(size));
+
+	// Touch every page now so that the first callback doesn't run into page faults
+	if (storage != nullptr)
+		memset(storage, 0, size);
+}
+
+AllocationArena::~AllocationArena()
+{
+	jassert(numLiveAllocations.load() == 0);
+
+	std::free(storage);
+}
+
+AllocationArena::ScopedActivation::ScopedActivation(AllocationArena* arenaToUse) noexcept :
+	arena(arenaToUse),
+	previousArena(currentAllocationArena)
+{
+	currentAllocationArena = arena;
+}
+
+AllocationArena::ScopedActivation::~ScopedActivation()
+{
+	currentAllocationArena = previousArena;
+
+	if (arena != nullptr && arena != previousArena)
+		arena->resetIfUnused();
+}
+
+AllocationArena* AllocationArena::getCurrentArena() noexcept
+{
+	return currentAllocationArena;
+}
+
+void* AllocationArena::allocate(size_t numBytes) noexcept
+{
+	auto arena = currentAllocationArena;
+
+	if (arena != nullptr)
+	{
+		if (auto data = arena->allocateFromArena(numBytes))
+			return data;
+
+		arena->registerHeapFallback(numBytes);
+	}
+
+	auto h = static_cast<Header*>(std::malloc(Header::Alignment + numBytes));
+
+	if (h == nullptr)
+		return nullptr;
+
+	h->owner = nullptr;
+	h->numBytes = numBytes;
+
+	return h->getData();
+}
+
+void* AllocationArena::allocateZeroed(size_t numElements, size_t elementSize) noexcept
+{
+	const size_t numBytes = numElements * elementSize;
+
+	auto data = allocate(numBytes);
+
+	if (data != nullptr)
+		memset(data, 0, numBytes);
+
+	return data;
+}
+
+void* AllocationArena::reallocate(void* data, size_t numBytes) noexcept
+{
+	if (data == nullptr)
+		return allocate(numBytes);
+
+	auto h = Header::fromData(data);
+	auto arena = currentAllocationArena;
+
+	if (h->owner == nullptr)
+	{
+		// Heap memory stays on the heap, otherwise a long living array would pin the arena
+		if (arena != nullptr)
+			arena->registerHeapFallback(numBytes);
+
+		auto newHeader = static_cast<Header*>(std::realloc(h, Header::Alignment + numBytes));
+
+		if (newHeader == nullptr)
+			return nullptr;
+
+		newHeader->numBytes = numBytes;
+		return newHeader->getData();
+	}
+
+	if (h->owner == arena && arena->isLastAllocation(h))
+	{
+		const size_t offset = static_cast<size_t>(reinterpret_cast<char*>(h) - arena->storage);
+		const size_t newPosition = offset + Header::Alignment + Header::getPaddedSize(numBytes);
+
+		if (newPosition <= arena->size)
+		{
+			arena->position = newPosition;
+
+			if (newPosition > arena->highWaterMark.load(std::memory_order_relaxed))
+				arena->highWaterMark.store(newPosition, std::memory_order_relaxed);
+
+			h->numBytes = numBytes;
+			return data;
+		}
+	}
+
+	auto newData = allocate(numBytes);
+
+	if (newData == nullptr)
+		return nullptr;
+
+	memcpy(newData, data, jmin(numBytes, h->numBytes));
+	deallocate(data);
+
+	return newData;
+}
+
+void AllocationArena::deallocate(void* data) noexcept
+{
+	if (data == nullptr)
+		return;
+
+	auto h = Header::fromData(data);
+
+	if (auto arena = h->owner)
+		arena->releaseAllocation(h);
+	else
+		std::free(h);
+}
+
+void* AllocationArena::allocateFromArena(size_t numBytes) noexcept
+{
+	if (storage == nullptr)
+		return nullptr;
+
+	const size_t numBytesToUse = Header::Alignment + Header::getPaddedSize(numBytes);
+
+	if (numBytesToUse > size - position)
+		return nullptr;
+
+	auto h = reinterpret_cast<Header*>(storage + position);
+	position += numBytesToUse;
+
+	if (position > highWaterMark.load(std::memory_order_relaxed))
+		highWaterMark.store(position, std::memory_order_relaxed);
+
+	h->owner = this;
+	h->numBytes = numBytes;
+
+	++numLiveAllocations;
+	incReferenceCount();
+
+	return h->getData();
+}
+
+bool AllocationArena::isLastAllocation(const Header* h) const noexcept
+{
+	auto end = reinterpret_cast<const char*>(h) + Header::Alignment + Header::getPaddedSize(h->numBytes);
+	return end == storage + position;
+}
+
+void AllocationArena::registerHeapFallback(size_t numBytes) noexcept
+{
+	numHeapFallbacks.fetch_add(1, std::memory_order_relaxed);
+	numHeapFallbackBytes.fetch_add(numBytes, std::memory_order_relaxed);
+}
+
+void AllocationArena::releaseAllocation(Header* h) noexcept
+{
+	// If the last allocation is freed while the arena is active, we can reuse the memory right away
+	if (currentAllocationArena == this && isLastAllocation(h))
+		position = static_cast<size_t>(reinterpret_cast<char*>(h) - storage);
+
+	--numLiveAllocations;
+	decReferenceCount();
+}
+
+void AllocationArena::resetIfUnused() noexcept
+{
+	if (numLiveAllocations.load() == 0)
+		position = 0;
+	else
+		numPinnedResets.fetch_add(1, std::memory_order_relaxed);
+}
+
+AllocationArena::Statistics AllocationArena::getStatistics() const noexcept
+{
+	Statistics s;
+
+	s.numBytes = size;
+	s.highWaterMark = highWaterMark.load();
+	s.numLiveAllocations = numLiveAllocations.load();
+	s.numHeapFallbacks = numHeapFallbacks.load();
+	s.numHeapFallbackBytes = numHeapFallbackBytes.load();
+	s.numPinnedResets = numPinnedResets.load();
+
+	return s;
+}
+
+void AllocationArena::resetStatistics() noexcept
+{
+	highWaterMark = 0;
+	numHeapFallbacks = 0;
+	numHeapFallbackBytes = 0;
+	numPinnedResets = 0;
+}
+
+String AllocationArena::Statistics::toString() const
+{
+	String s;
+
+	s << String((double)highWaterMark / 1024.0, 1) << "KB / " << String((double)numBytes / 1024.0, 1) << "KB peak";
+
+	if (numHeapFallbacks > 0)
+		s << ", " << String(numHeapFallbacks) << " heap fallbacks (" << String((double)numHeapFallbackBytes / 1024.0, 1) << "KB)";
+
+	if (numPinnedResets > 0)
+		s << ", pinned " << String(numPinnedResets) << "x";
+
+	return s;
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class AllocationArenaTests : public UnitTest
+{
+public:
+	AllocationArenaTests() : UnitTest("Allocation Arena", "Memory") {}
+
+	void runTest() override
+	{
+		beginTest("Allocate, reallocate and free");
+		{
+			AllocationArena::Ptr arena = new AllocationArena(4096);
+			void* first = nullptr;
+
+			{
+				AllocationArena::ScopedActivation sa(arena);
+
+				first = AllocationArena::allocate(100);
+				expect(first != nullptr);
+				expectEquals(arena->getStatistics().numLiveAllocations, 1);
+
+				// The last allocation grows in place
+				auto grown = AllocationArena::reallocate(first, 200);
+				expect(grown == first);
+
+				auto second = static_cast<char*>(AllocationArena::allocateZeroed(10, 4));
+
+				for (int i = 0; i < 40; i++)
+					expect(second[i] == 0);
+
+				expectEquals(arena->getStatistics().numLiveAllocations, 2);
+
+				// Not the last allocation anymore, so it has to be moved
+				memset(grown, 42, 200);
+				auto moved = static_cast<char*>(AllocationArena::reallocate(grown, 1000));
+				expect(moved != grown);
+				expect(moved[0] == 42 && moved[199] == 42);
+				expectEquals(arena->getStatistics().numLiveAllocations, 2);
+
+				AllocationArena::deallocate(moved);
+				AllocationArena::deallocate(second);
+				expectEquals(arena->getStatistics().numLiveAllocations, 0);
+			}
+
+			// The arena was reset, so the next allocation starts at the beginning again
+			{
+				AllocationArena::ScopedActivation sa(arena);
+
+				auto data = AllocationArena::allocate(16);
+				expect(data == first);
+				AllocationArena::deallocate(data);
+			}
+
+			auto stats = arena->getStatistics();
+			expect(stats.highWaterMark >= 1200);
+			expectEquals(stats.numHeapFallbacks, 0);
+			expectEquals(stats.numPinnedResets, 0);
+		}
+
+		beginTest("Heap fallback");
+		{
+			AllocationArena::Ptr arena = new AllocationArena(256);
+			AllocationArena::ScopedActivation sa(arena);
+
+			auto small = AllocationArena::allocate(64);
+			auto big = AllocationArena::allocate(1024);
+			expectEquals(arena->getStatistics().numLiveAllocations, 1);
+			expectEquals(arena->getStatistics().numHeapFallbacks, 1);
+
+			// Doesn't fit in the arena anymore
+			auto moved = AllocationArena::reallocate(small, 512);
+			expect(moved != small);
+			expectEquals(arena->getStatistics().numLiveAllocations, 0);
+
+			// Heap memory stays on the heap
+			auto bigger = AllocationArena::reallocate(big, 2048);
+			expectEquals(arena->getStatistics().numLiveAllocations, 0);
+
+			AllocationArena::deallocate(moved);
+			AllocationArena::deallocate(bigger);
+
+			auto stats = arena->getStatistics();
+			expectEquals(stats.numHeapFallbacks, 3);
+			expectEquals((int)stats.numHeapFallbackBytes, 1024 + 512 + 2048);
+			expect(stats.toString().contains("3 heap fallbacks"));
+
+			arena->resetStatistics();
+			stats = arena->getStatistics();
+			expectEquals(stats.numHeapFallbacks, 0);
+			expectEquals((int)stats.highWaterMark, 0);
+			expect(!stats.toString().contains("heap fallbacks"));
+		}
+
+		beginTest("Allocations without an active arena");
+		{
+			expect(AllocationArena::getCurrentArena() == nullptr);
+
+			auto data = AllocationArena::allocate(32);
+			expect(data != nullptr);
+			AllocationArena::deallocate(data);
+
+			AllocationArena::Ptr arena = new AllocationArena(1024);
+			AllocationArena::ScopedActivation sa(arena);
+
+			{
+				AllocationArena::ScopedActivation heapOnly(nullptr);
+
+				data = AllocationArena::allocate(32);
+				expectEquals(arena->getStatistics().numLiveAllocations, 0);
+				expectEquals(arena->getStatistics().numHeapFallbacks, 0);
+			}
+
+			expect(AllocationArena::getCurrentArena() == arena.get());
+
+			// Freeing heap memory while the arena is active
+			AllocationArena::deallocate(data);
+		}
+
+		beginTest("Pinning and freeing on another thread");
+		{
+			AllocationArena::Ptr arena = new AllocationArena(4096);
+			void* escaped = nullptr;
+
+			{
+				AllocationArena::ScopedActivation sa(arena);
+				escaped = AllocationArena::allocate(64);
+			}
+
+			expectEquals(arena->getStatistics().numPinnedResets, 1);
+			expectEquals(arena->getStatistics().numLiveAllocations, 1);
+
+			// The escaped allocation keeps the next activation from reusing its memory
+			{
+				AllocationArena::ScopedActivation sa(arena);
+
+				auto data = AllocationArena::allocate(64);
+				expect(data != escaped);
+				AllocationArena::deallocate(data);
+			}
+
+			expectEquals(arena->getStatistics().numPinnedResets, 2);
+
+			FreeThread t(escaped);
+			t.startThread();
+			expect(t.waitForThreadToExit(5000));
+			expectEquals(arena->getStatistics().numLiveAllocations, 0);
+
+			// The position is rewound at the end of the next activation
+			{
+				AllocationArena::ScopedActivation sa(arena);
+
+				auto data = AllocationArena::allocate(64);
+				expect(data != escaped);
+				AllocationArena::deallocate(data);
+			}
+
+			{
+				AllocationArena::ScopedActivation sa(arena);
+
+				auto data = AllocationArena::allocate(64);
+				expect(data == escaped);
+				AllocationArena::deallocate(data);
+			}
+
+			expectEquals(arena->getStatistics().numPinnedResets, 2);
+		}
+
+		beginTest("The arena outlives its owner");
+		{
+			void* escaped = nullptr;
+
+			{
+				AllocationArena::Ptr arena = new AllocationArena(1024);
+				AllocationArena::ScopedActivation sa(arena);
+				escaped = AllocationArena::allocate(32);
+				memset(escaped, 42, 32);
+			}
+
+			// The allocation holds a reference, so the storage is still valid and this deletes the arena
+			expect(static_cast<char*>(escaped)[31] == 42);
+			AllocationArena::deallocate(escaped);
+		}
+
+		beginTest("String and HeapBlock allocations");
+		{
+			AllocationArena::Ptr arena = new AllocationArena(8192);
+
+			{
+				AllocationArena::ScopedActivation sa(arena);
+
+				String s = String::repeatedString("abc", 100);
+				HeapBlock<float> block(256, true);
+
+				expect(arena->getStatistics().numLiveAllocations >= 2);
+				expectEquals(s.length(), 300);
+				expect(block[255] == 0.0f);
+			}
+
+			expectEquals(arena->getStatistics().numLiveAllocations, 0);
+			expectEquals(arena->getStatistics().numPinnedResets, 0);
+		}
+	}
+
+private:
+
+	struct FreeThread : public Thread
+	{
+		FreeThread(void* d) : Thread("AllocationArena free thread"), data(d) {}
+
+		void run() override
+		{
+			AllocationArena::deallocate(data);
+		}
+
+		void* data;
+	};
+};
+
+static AllocationArenaTests allocationArenaTests;
+
+#endif
+
+#endif
+
+}
@@ -0,0 +1,170 @@
+/*
+==============================================================================
+
+This file is part of the JUCE library.
+Copyright (c) 2017 - ROLI Ltd.
+
+JUCE is an open source library subject to commercial or open-source
+licensing.
+
+The code included in this file is provided under the terms of the ISC license
+http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+To use, copy, modify, and/or distribute this software for any purpose with or
+without fee is hereby granted provided that the above copyright notice and
+this permission notice appear in all copies.
+
+JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+DISCLAIMED.
+
+==============================================================================
+*/
+
+namespace juce
+{
+
+#if JUCE_ENABLE_ALLOCATION_ARENA
+
+template <class ObjectType> class ReferenceCountedObjectPtr;
+
+/** A preallocated chunk of memory that serves the String, HeapBlock, var array and
+	DynamicObject allocations of a thread while it is activated.
+
+	If you activate an arena with a ScopedActivation, every allocation of the mentioned
+	classes on the current thread will be taken from the arena with a simple bump pointer
+	instead of the global heap. When the ScopedActivation goes out of scope, the arena will
+	be reset if all its memory has been released again. If there are still objects alive
+	(eg. because a String was stored somewhere), the arena stays pinned until these are
+	deleted and will be reset after the next activation.
+
+	Be aware that a single escaping allocation pins the arena for as long as it lives: the
+	position is never rewound behind it, so every following activation bumps behind the
+	escaped object until the arena is full and all allocations fall back to the heap. If an
+	object is known to outlive the activation (eg. a String that is stored in a member), create
+	it with a ScopedActivation(nullptr) so it ends up on the heap. A growing numPinnedResets
+	in the Statistics is the symptom of this.
+
+	If the arena is full, the allocation falls back to the global heap. This is tracked
+	in the Statistics, so you can spot code paths that need a bigger arena.
+
+	Every allocation carries a small header that points to the arena (or nullptr for heap memory),
+	so it's safe to delete the objects on any thread at any time - the arena is reference counted
+	and stays alive until the last allocation was freed.
+
+	This needs JUCE_ENABLE_ALLOCATION_ARENA, otherwise the allocation macros will just call
+	the standard functions.
+*/
+class JUCE_API AllocationArena
+{
+public:
+
+	using Ptr = ReferenceCountedObjectPtr<AllocationArena>;
+
+	struct Statistics
+	{
+		/** Creates a summary like "2.1KB / 64KB peak, 3 heap fallbacks". */
+		String toString() const;
+
+		size_t numBytes = 0;
+		size_t highWaterMark = 0;
+		int numLiveAllocations = 0;
+		int numHeapFallbacks = 0;
+		size_t numHeapFallbackBytes = 0;
+		int numPinnedResets = 0;
+	};
+
+	/** Creates an arena with the given size. Create this on a non-realtime thread and keep it in a Ptr. */
+	AllocationArena(size_t numBytes);
+
+	~AllocationArena();
+
+	/** Activates the arena for the current thread until it goes out of scope.
+
+		You can pass in nullptr to temporarily route all allocations to the global heap (eg. for objects
+		that are supposed to live longer than the callback).
+	*/
+	struct ScopedActivation
+	{
+		ScopedActivation(AllocationArena* arenaToUse) noexcept;
+		~ScopedActivation();
+
+	private:
+
+		AllocationArena* arena;
+		AllocationArena* previousArena;
+
+		JUCE_DECLARE_NON_COPYABLE(ScopedActivation);
+	};
+
+	/** Returns the arena that is active on the current thread or nullptr. */
+	static AllocationArena* getCurrentArena() noexcept;
+
+	// ==============================================================================================
+
+	static void* allocate(size_t numBytes) noexcept;
+	static void* allocateZeroed(size_t numElements, size_t elementSize) noexcept;
+	static void* reallocate(void* data, size_t numBytes) noexcept;
+	static void deallocate(void* data) noexcept;
+
+	// ==============================================================================================
+
+	Statistics getStatistics() const noexcept;
+
+	void resetStatistics() noexcept;
+
+	size_t getSize() const noexcept { return size; }
+
+	void incReferenceCount() noexcept { ++numReferences; }
+	void decReferenceCount() noexcept { if (decReferenceCountWithoutDeleting()) delete this; }
+	bool decReferenceCountWithoutDeleting() noexcept { return --numReferences == 0; }
+
+private:
+
+	struct Header;
+
+	void* allocateFromArena(size_t numBytes) noexcept;
+	bool isLastAllocation(const Header* h) const noexcept;
+	void registerHeapFallback(size_t numBytes) noexcept;
+	void releaseAllocation(Header* h) noexcept;
+	void resetIfUnused() noexcept;
+
+	char* storage;
+	const size_t size;
+
+	// only accessed by the thread that has activated the arena
+	size_t position = 0;
+
+	std::atomic<int> numReferences;
+	std::atomic<int> numLiveAllocations;
+
+	std::atomic<size_t> highWaterMark;
+	std::atomic<int> numHeapFallbacks;
+	std::atomic<size_t> numHeapFallbackBytes;
+	std::atomic<int> numPinnedResets;
+
+	JUCE_DECLARE_NON_COPYABLE(AllocationArena);
+};
+
+#define JUCE_ARENA_MALLOC(numBytes) juce::AllocationArena::allocate(numBytes)
+#define JUCE_ARENA_CALLOC(numElements, elementSize) juce::AllocationArena::allocateZeroed(numElements, elementSize)
+#define JUCE_ARENA_REALLOC(data, numBytes) juce::AllocationArena::reallocate(data, numBytes)
+#define JUCE_ARENA_FREE(data) juce::AllocationArena::deallocate(data)
+
+/** Add this to a class declaration to create its instances inside the active AllocationArena. */
+#define JUCE_ALLOCATE_FROM_ARENA \
+	static void* operator new (size_t numBytes) { if (auto p = juce::AllocationArena::allocate(numBytes)) return p; throw std::bad_alloc(); } \
+	static void operator delete (void* p) noexcept { juce::AllocationArena::deallocate(p); } \
+	static void* operator new (size_t, void* p) noexcept { return p; } \
+	static void operator delete (void*, void*) noexcept {}
+
+#else
+
+#define JUCE_ARENA_MALLOC(numBytes) std::malloc(numBytes)
+#define JUCE_ARENA_CALLOC(numElements, elementSize) std::calloc(numElements, elementSize)
+#define JUCE_ARENA_REALLOC(data, numBytes) std::realloc(data, numBytes)
+#define JUCE_ARENA_FREE(data) std::free(data)
+#define JUCE_ALLOCATE_FROM_ARENA
+
+#endif
+
+}
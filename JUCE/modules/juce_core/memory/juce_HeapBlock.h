@@ -109,7 +109,7 @@ public:
     */
     template <typename SizeType>
     explicit HeapBlock (SizeType numElements)
-        : data (static_cast<ElementType*> (std::malloc (static_cast<size_t> (numElements) * sizeof (ElementType))))
+        : data (static_cast<ElementType*> (JUCE_ARENA_MALLOC (static_cast<size_t> (numElements) * sizeof (ElementType))))
     {
 		WARN_IF_AUDIO_THREAD(numElements > 0, IllegalAudioThreadOps::HeapBlockAllocation);
 
@@ -124,8 +124,8 @@ public:
     template <typename SizeType>
     HeapBlock (SizeType numElements, bool initialiseToZero)
         : data (static_cast<ElementType*> (initialiseToZero
-                                               ? std::calloc (static_cast<size_t> (numElements), sizeof (ElementType))
-                                               : std::malloc (static_cast<size_t> (numElements) * sizeof (ElementType))))
+                                               ? JUCE_ARENA_CALLOC (static_cast<size_t> (numElements), sizeof (ElementType))
+                                               : JUCE_ARENA_MALLOC (static_cast<size_t> (numElements) * sizeof (ElementType))))
     {
 		WARN_IF_AUDIO_THREAD(numElements > 0, IllegalAudioThreadOps::HeapBlockAllocation);
 
@@ -258,7 +258,7 @@ public:
 		WARN_IF_AUDIO_THREAD(newNumElements > 0 || data != nullptr, IllegalAudioThreadOps::HeapBlockAllocation);
 		
 		free();
-        data = static_cast<ElementType*> (std::malloc (static_cast<size_t> (newNumElements) * elementSize));
+        data = static_cast<ElementType*> (JUCE_ARENA_MALLOC (static_cast<size_t> (newNumElements) * elementSize));
         throwOnAllocationFailure();
     }
 
@@ -270,8 +270,8 @@ public:
     {
 		WARN_IF_AUDIO_THREAD(newNumElements > 0 || data != nullptr, IllegalAudioThreadOps::HeapBlockAllocation);
 
-        std::free (data);
-        data = static_cast<ElementType*> (std::calloc (static_cast<size_t> (newNumElements), elementSize));
+        JUCE_ARENA_FREE (data);
+        data = static_cast<ElementType*> (JUCE_ARENA_CALLOC (static_cast<size_t> (newNumElements), elementSize));
         throwOnAllocationFailure();
     }
 
@@ -286,8 +286,8 @@ public:
 
 		free();
         data = static_cast<ElementType*> (initialiseToZero
-                                             ? std::calloc (static_cast<size_t> (newNumElements), sizeof (ElementType))
-                                             : std::malloc (static_cast<size_t> (newNumElements) * sizeof (ElementType)));
+                                             ? JUCE_ARENA_CALLOC (static_cast<size_t> (newNumElements), sizeof (ElementType))
+                                             : JUCE_ARENA_MALLOC (static_cast<size_t> (newNumElements) * sizeof (ElementType)));
         throwOnAllocationFailure();
     }
 
@@ -301,8 +301,8 @@ public:
     {
 		WARN_IF_AUDIO_THREAD(newNumElements > 0 || data != nullptr, IllegalAudioThreadOps::HeapBlockAllocation);
 
-        data = static_cast<ElementType*> (data == nullptr ? std::malloc (static_cast<size_t> (newNumElements) * elementSize)
-                                                          : std::realloc (data, static_cast<size_t> (newNumElements) * elementSize));
+        data = static_cast<ElementType*> (data == nullptr ? JUCE_ARENA_MALLOC (static_cast<size_t> (newNumElements) * elementSize)
+                                                          : JUCE_ARENA_REALLOC (data, static_cast<size_t> (newNumElements) * elementSize));
         throwOnAllocationFailure();
     }
 
@@ -315,7 +315,7 @@ public:
 
 		if (data != nullptr)
 		{
-			std::free(data);
+			JUCE_ARENA_FREE(data);
 			data = nullptr;
 		}
     }
@@ -73,7 +73,11 @@ public:
 		WARN_IF_AUDIO_THREAD(numBytes > 0, IllegalAudioThreadOps::StringCreation);
 
         numBytes = (numBytes + 3) & ~(size_t) 3;
-        auto s = reinterpret_cast<StringHolder*> (new char [sizeof (StringHolder) - sizeof (CharType) + numBytes]);
+        auto s = static_cast<StringHolder*> (JUCE_ARENA_MALLOC (sizeof (StringHolder) - sizeof (CharType) + numBytes));
+
+        if (s == nullptr)
+            throw std::bad_alloc();
+
         s->refCount.value = 0;
         s->allocatedNumBytes = numBytes;
         return CharPointerType (s->text);
@@ -166,7 +170,7 @@ public:
     {
         if (b != (StringHolder*) &emptyString)
             if (--(b->refCount) == -1)
-                delete[] reinterpret_cast<char*> (b);
+                JUCE_ARENA_FREE (b);
     }
 
     static void release (const CharPointerType text) noexcept
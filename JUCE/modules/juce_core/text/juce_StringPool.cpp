@@ -94,6 +94,11 @@ static String addPooledString (Array<String>& strings, const NewStringType& newS
             end = halfway;
     }
 
+   #if JUCE_ENABLE_ALLOCATION_ARENA
+    // The pooled strings live forever, so they must not end up in an AllocationArena
+    const AllocationArena::ScopedActivation heapOnly (nullptr);
+   #endif
+
     strings.insert (start, newString);
     return strings.getReference (start);
 }
@@ -135,7 +140,13 @@ String StringPool::getPooledString (const String& newString)
 
     const ScopedLock sl (lock);
     garbageCollectIfNeeded();
+
+   #if JUCE_ENABLE_ALLOCATION_ARENA
+    // Don't share the buffer, it might live inside an arena
+    return addPooledString (strings, newString.getCharPointer());
+   #else
     return addPooledString (strings, newString);
+   #endif
 }
 
 void StringPool::garbageCollectIfNeeded()
@@ -57,6 +57,7 @@ viewUndoManager(new UndoManager())
 	if (!inUnitTestMode())
 	{
 		getAutoSaver().updateAutosaving();
+		getParallelRenderPool().setNumWorkerThreads((int)getSettingsObject().getSetting(HiseSettings::Other::NumParallelRenderThreads));
 	}
 	
 	clearPreset();
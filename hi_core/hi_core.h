@@ -231,6 +231,24 @@ If this is enabled, you can use expansion packs to add additional content to you
 #define ENABLE_SCRIPTING_BREAKPOINTS 0
 #endif
 
+/** Config: ENABLE_SCRIPTING_BYTECODE
+
+If enabled, the script callbacks will be compiled into a register based bytecode after parsing. By default they are executed by walking the syntax tree.
+*/
+#ifndef ENABLE_SCRIPTING_BYTECODE
+#define ENABLE_SCRIPTING_BYTECODE 0
+#endif
+
+/** Config: SCRIPTING_CALLBACK_ARENA_SIZE
+
+The size in kilobytes of the memory that is preallocated for every script callback. If the callback is executed on the audio thread, all String, Array and Object allocations will use this memory instead of the heap. This needs JUCE_ENABLE_ALLOCATION_ARENA, otherwise it will be ignored.
+
+If the callback stores a value that was created in the callback (eg. a String in a reg variable), the arena can't be reset until this value is overwritten, so the following callbacks will eventually run out of arena memory and fall back to the heap. The arena statistics of the callback show this as "pinned".
+*/
+#ifndef SCRIPTING_CALLBACK_ARENA_SIZE
+#define SCRIPTING_CALLBACK_ARENA_SIZE 64
+#endif
+
 /** Config: ENABLE_ALL_PEAK_METERS
 
 Set this to 0 to deactivate peak collection for any other processor than the main synth chain
@@ -633,7 +633,7 @@ void PoolHelpers::Reference::parseReferenceString(const MainController* mc, cons
 
 bool PoolBase::DataProvider::isEmbeddedResource(PoolReference r)
 {
-	return r.isEmbeddedReference() || hashCodes.contains(r.getHashCode());
+	return r.isEmbeddedReference() || chunkIndexes.contains(r.getHashCode());
 }
 
 hise::PoolReference PoolBase::DataProvider::getEmbeddedReference(PoolReference other)
@@ -663,30 +663,138 @@ juce::Result PoolBase::DataProvider::restorePool(InputStream* ownedInputStream)
 	jassert(metadata.isValid());
 	jassert(metadata.getType() == Identifier("PoolData"));
 
+	metadataOffset = input->getPosition();
+
+	buildIndex();
+	mapInput();
+
+	return Result::ok();
+}
+
+void PoolBase::DataProvider::buildIndex()
+{
 	static const Identifier hc("HashCode");
+	static const Identifier cs("ChunkStart");
+	static const Identifier ce("ChunkEnd");
+
+	chunks.clearQuick();
+	chunkIndexes.clear();
 
-	for (const auto& item : metadata)
+	chunks.ensureStorageAllocated(metadata.getNumChildren());
+
+	for (int i = 0; i < metadata.getNumChildren(); i++)
 	{
-		hashCodes.add(item.getProperty(hc));
+		auto item = metadata.getChild(i);
+
+		ChunkInfo info;
+		info.start = (int64)item.getProperty(cs);
+		info.end = (int64)item.getProperty(ce);
+		info.metadataIndex = i;
+
+		chunkIndexes.set((int64)item.getProperty(hc), chunks.size());
+		chunks.add(info);
 	}
+}
 
-	metadataOffset = input->getPosition();
+void PoolBase::DataProvider::mapInput()
+{
+	mappedFile = nullptr;
+	mappedData = nullptr;
+	mappedSize = 0;
 
-	return Result::ok();
+	if (auto mis = dynamic_cast<MemoryInputStream*>(input.get()))
+	{
+		// The data lives as long as the input stream, so we can just point into it
+		mappedData = static_cast<const char*>(mis->getData());
+		mappedSize = mis->getDataSize();
+	}
+	else if (auto fis = dynamic_cast<FileInputStream*>(input.get()))
+	{
+		mappedFile = sharedMappedFiles->getOrCreate(fis->getFile());
+
+		if (mappedFile != nullptr)
+		{
+			mappedData = mappedFile->getData();
+			mappedSize = mappedFile->getSize();
+
+			// we don't need the file handle anymore
+			input = nullptr;
+		}
+	}
+}
+
+const PoolBase::DataProvider::ChunkInfo* PoolBase::DataProvider::getChunkInfo(const String& referenceString) const
+{
+	const int64 hash = referenceString.hashCode64();
+
+	if (chunkIndexes.contains(hash))
+	{
+		auto& info = chunks.getReference(chunkIndexes[hash]);
+
+		// Check against hash collisions
+		if (metadata.getChild(info.metadataIndex).getProperty("ID").toString() == referenceString)
+			return &info;
+	}
+
+	// Fall back to the linear search if the hash code property is missing
+	auto item = metadata.getChildWithProperty("ID", referenceString);
+
+	if (item.isValid())
+	{
+		auto index = metadata.indexOf(item);
+
+		for (const auto& c : chunks)
+			if (c.metadataIndex == index)
+				return &c;
+	}
+
+	return nullptr;
+}
+
+PoolBase::DataProvider::MappedResourceFile::Ptr PoolBase::DataProvider::SharedMappedFiles::getOrCreate(const File& f)
+{
+	ScopedLock sl(lock);
+
+	for (int i = files.size() - 1; i >= 0; i--)
+	{
+		// Remove the mappings that aren't used by any instance anymore
+		if (files[i]->getReferenceCount() == 1)
+			files.remove(i);
+	}
+
+	for (auto mf : files)
+	{
+		if (mf->file == f)
+			return mf;
+	}
+
+	MappedResourceFile::Ptr newFile = new MappedResourceFile(f);
+
+	if (!newFile->isValid())
+		return nullptr;
+
+	files.add(newFile);
+	return newFile;
 }
 
 juce::MemoryInputStream* PoolBase::DataProvider::createInputStream(const String& referenceString)
 {
 	if (metadata.isValid())
 	{
-		auto item = metadata.getChildWithProperty("ID", referenceString);
-
-		if (item.isValid())
+		if (auto info = getChunkInfo(referenceString))
 		{
-			auto offset = (int64)item.getProperty("ChunkStart");
-			auto end = (int64)item.getProperty("ChunkEnd");
+			auto offset = info->start;
+			auto end = info->end;
 
-			if (input != nullptr && (input->getTotalLength() > offset + metadataOffset))
+			if (mappedData != nullptr)
+			{
+				if ((int64)mappedSize >= end + metadataOffset)
+				{
+					// Read directly from the mapped memory without copying
+					return new MemoryInputStream(mappedData + metadataOffset + offset, (size_t)(end - offset), false);
+				}
+			}
+			else if (input != nullptr && (input->getTotalLength() > offset + metadataOffset))
 			{
 				input->setPosition(offset + metadataOffset);
 
@@ -793,7 +901,12 @@ juce::Result PoolBase::DataProvider::writePool(OutputStream* ownedOutputStream,
 
 var PoolBase::DataProvider::createAdditionalData(PoolReference r)
 {
-	auto item = metadata.getChildWithProperty("ID", r.getReferenceString());
+	auto info = getChunkInfo(r.getReferenceString());
+
+	if (info == nullptr)
+		return var();
+
+	auto item = metadata.getChild(info->metadataIndex);
 
 	if (item.isValid())
 	{
@@ -397,14 +397,75 @@ public:
 
 		Array<PoolReference> getListOfAllEmbeddedReferences() const;
 
+		/** Returns true if the resources are read directly from memory (either the embedded binary data or a memory mapped file). */
+		bool isUsingMappedData() const noexcept { return mappedData != nullptr; }
+
 	private:
 
+		/** A read only memory mapped resource file. */
+		class MappedResourceFile : public ReferenceCountedObject
+		{
+		public:
+
+			using Ptr = ReferenceCountedObjectPtr<MappedResourceFile>;
+
+			MappedResourceFile(const File& f) :
+				file(f),
+				mapping(f, MemoryMappedFile::readOnly, false)
+			{}
+
+			bool isValid() const noexcept { return mapping.getData() != nullptr; }
+
+			const char* getData() const noexcept { return static_cast<const char*>(mapping.getData()); }
+			size_t getSize() const noexcept { return mapping.getSize(); }
+
+			const File file;
+
+		private:
+
+			MemoryMappedFile mapping;
+
+			JUCE_DECLARE_NON_COPYABLE(MappedResourceFile);
+		};
+
+		/** The list of mapped resource files that is shared between all plugin instances. */
+		struct SharedMappedFiles
+		{
+			/** Returns the mapping for the given file (or nullptr if it can't be mapped). */
+			MappedResourceFile::Ptr getOrCreate(const File& f);
+
+			CriticalSection lock;
+			ReferenceCountedArray<MappedResourceFile> files;
+		};
+
+		struct ChunkInfo
+		{
+			int64 start;
+			int64 end;
+			int metadataIndex;
+		};
+
+		/** Returns the chunk of the given ID or nullptr if it's not embedded. */
+		const ChunkInfo* getChunkInfo(const String& referenceString) const;
+
+		void buildIndex();
+		void mapInput();
+
 		ValueTree metadata;
 		int64 metadataOffset;
 
 		PoolBase* pool = nullptr;
 		ScopedPointer<InputStream> input;
-		Array<int64> hashCodes;
+
+		Array<ChunkInfo> chunks;
+
+		/** Maps the hash code of the ID to the index in chunks. */
+		HashMap<int64, int> chunkIndexes;
+
+		SharedResourcePointer<SharedMappedFiles> sharedMappedFiles;
+		MappedResourceFile::Ptr mappedFile;
+		const char* mappedData = nullptr;
+		size_t mappedSize = 0;
 
 		ScopedPointer<Compressor> compressor;
 	};
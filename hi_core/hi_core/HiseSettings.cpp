@@ -136,6 +136,7 @@ Array<juce::Identifier> HiseSettings::Other::getAllIds()
 	ids.add(EnableAutosave);
 	ids.add(AutosaveInterval);
 	ids.add(AudioThreadGuardEnabled);
+	ids.add(NumParallelRenderThreads);
 
 	return ids;
 }
@@ -403,6 +404,11 @@ Array<juce::Identifier> HiseSettings::Audio::getAllIds()
 		D("Watches for illegal calls in the audio thread. Use this during script development to catch allocations etc.");
 		P_();
 
+		P(HiseSettings::Other::NumParallelRenderThreads);
+		D("The number of additional realtime threads that render voices and child synths in parallel to the audio thread.");
+		D("If this is `0`, everything is rendered on the audio thread. Exported plugins use the `HISE_NUM_PARALLEL_RENDER_THREADS` preprocessor definition instead.");
+		P_();
+
 		P(HiseSettings::Documentation::DocRepository);
 		D("The folder of the `hise_documentation` repository. If you want to contribute to the documentation you can setup this folder.");
 		D("Otherwise it will use the cached version that was downloaded from the HISE doc server");
@@ -541,6 +547,16 @@ juce::StringArray HiseSettings::Data::getOptionsFor(const Identifier& id)
 	if (id == Compiler::VisualStudioVersion)
 		return { "Visual Studio 2015", "Visual Studio 2017" };
 
+	if (id == Other::NumParallelRenderThreads)
+	{
+		StringArray sa;
+
+		for (int i = 0; i < SystemStats::getNumCpus(); i++)
+			sa.add(String(i));
+
+		return sa;
+	}
+
 	if (id == Project::AAXCategoryFX)
 		return {
 			"AAX_ePlugInCategory_EQ",
@@ -703,6 +719,7 @@ var HiseSettings::Data::getDefaultSetting(const Identifier& id)
 	else if (id == Other::EnableAutosave)			return "Yes";
 	else if (id == Other::AutosaveInterval)			return 5;
 	else if (id == Other::AudioThreadGuardEnabled)  return "Yes";
+	else if (id == Other::NumParallelRenderThreads) return HISE_NUM_PARALLEL_RENDER_THREADS;
 	else if (id == Documentation::DocRepository)	return "";
 	else if (id == Documentation::RefreshOnStartup) return "Yes";
 	else if (id == Scripting::CodeFontSize)			return 17.0;
@@ -758,6 +775,9 @@ juce::Result HiseSettings::Data::checkInput(const Identifier& id, const var& new
 	if (id == Other::AutosaveInterval && !TestFunctions::isValidNumberBetween(newValue, { 1.0f, 30.0f }))
 		return Result::fail("The autosave interval must be between 1 and 30 minutes");
 
+	if (id == Other::NumParallelRenderThreads && !TestFunctions::isValidNumberBetween(newValue, { 0.0f, (float)(SystemStats::getNumCpus() - 1) }))
+		return Result::fail("The number of render threads must be between 0 and " + String(SystemStats::getNumCpus() - 1));
+
 	if (id == Project::Version)
 	{
 		const String version = newValue.toString();
@@ -849,6 +869,17 @@ void HiseSettings::Data::settingWasChanged(const Identifier& id, const var& newV
 		mc->getAutoSaver().updateAutosaving();
 	else if (id == Other::AudioThreadGuardEnabled)
 		mc->getKillStateHandler().enableAudioThreadGuard(newValue);
+	else if (id == Other::NumParallelRenderThreads)
+	{
+		LockHelpers::SafeLock sl(mc, LockHelpers::AudioLock);
+		mc->getParallelRenderPool().setNumWorkerThreads((int)newValue);
+
+		// The synths allocate their per-thread buffers in prepareToPlay()
+		auto chain = mc->getMainSynthChain();
+
+		if (chain->getSampleRate() > 0.0)
+			chain->prepareToPlay(chain->getSampleRate(), chain->getLargestBlockSize());
+	}
 
 	else if (id == Scripting::EnableDebugMode)
 		newValue ? mc->getDebugLogger().startLogging() : mc->getDebugLogger().stopLogging();
@@ -124,6 +124,7 @@ namespace Other
 DECLARE_ID(EnableAutosave);
 DECLARE_ID(AutosaveInterval);
 DECLARE_ID(AudioThreadGuardEnabled)
+DECLARE_ID(NumParallelRenderThreads);
 
 Array<Identifier> getAllIds();
 
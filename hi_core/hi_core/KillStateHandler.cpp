@@ -560,15 +560,28 @@ void MainController::KillStateHandler::setSampleLoadingThreadId(void* newId)
 	threadIds[(int)TargetThread::SampleLoadingThread] = newId;
 }
 
+bool MainController::KillStateHandler::isStreamingWorkerThread(void* threadId) const
+{
+	if (auto pool = mc->getSampleManager().getGlobalSampleThreadPool())
+		return pool->isLoadingThread(threadId);
+
+	return false;
+}
+
+bool MainController::KillStateHandler::isParallelRenderThread(void* threadId) const
+{
+	return mc->getParallelRenderPool().isWorkerThread(threadId);
+}
+
 MainController::KillStateHandler::TargetThread MainController::KillStateHandler::getCurrentThread() const
 {
 	jassert(threadIds[(int)TargetThread::SampleLoadingThread] != nullptr);
 
 	auto threadId = Thread::getCurrentThreadId();
 
-	if (audioThreads.contains(threadId))
+	if (audioThreads.contains(threadId) || isParallelRenderThread(threadId))
 		return TargetThread::AudioThread;
-	else if (threadId == threadIds[(int)TargetThread::SampleLoadingThread])
+	else if (threadId == threadIds[(int)TargetThread::SampleLoadingThread] || isStreamingWorkerThread(threadId))
 		return TargetThread::SampleLoadingThread;
 	else if (threadId == threadIds[(int)TargetThread::ScriptingThread])
 		return TargetThread::ScriptingThread;
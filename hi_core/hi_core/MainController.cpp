@@ -44,6 +44,7 @@ MainController::MainController() :
 
 	sampleManager(new SampleManager(this)),
 	javascriptThreadPool(new JavascriptThreadPool(this)),
+	parallelRenderPool(new ParallelRenderPool()),
 	expansionHandler(this),
 	allNotesOffFlag(false),
 	maxBufferSize(-1),
@@ -116,6 +117,7 @@ MainController::~MainController()
 
 	sampleManager = nullptr;
 	javascriptThreadPool = nullptr;
+	parallelRenderPool = nullptr;
 }
 
 
@@ -948,6 +948,12 @@ public:
 
 		bool checkForClearance() const noexcept;
 
+		/** Checks whether the thread is one of the additional streaming worker threads of the SampleThreadPool. */
+		bool isStreamingWorkerThread(void* threadId) const;
+
+		/** Checks whether the thread is one of the worker threads of the ParallelRenderPool. */
+		bool isParallelRenderThread(void* threadId) const;
+
 		struct LockStates
 		{
 			LockStates()
@@ -1046,6 +1052,19 @@ public:
 	JavascriptThreadPool& getJavascriptThreadPool() noexcept { return *javascriptThreadPool.get(); }
 	const JavascriptThreadPool& getJavascriptThreadPool() const noexcept { return *javascriptThreadPool.get(); }
 
+	/** Returns the thread pool that can be used to spread the rendering of the audio callback across multiple cores. */
+	ParallelRenderPool& getParallelRenderPool() noexcept { return *parallelRenderPool.get(); }
+	const ParallelRenderPool& getParallelRenderPool() const noexcept { return *parallelRenderPool.get(); }
+
+	/** Returns a counter that changes whenever a processor of this instance is added to a chain, removed or deleted.
+	*
+	*	You can use this to invalidate information about the processor tree that is cached for the audio thread.
+	*/
+	int getProcessorTreeVersion() const noexcept { return processorTreeVersion.load(); }
+
+	/** Increases the processor tree version. This is called by the Chain::Handler and the Processor destructor. */
+	void processorTreeChanged() noexcept { ++processorTreeVersion; }
+
 	PooledUIUpdater* getGlobalUIUpdater() { return &globalUIUpdater; }
 	const PooledUIUpdater* getGlobalUIUpdater() const { return &globalUIUpdater; }
 
@@ -1436,6 +1455,10 @@ private:
 
 	ScopedPointer<JavascriptThreadPool> javascriptThreadPool;
 
+	ScopedPointer<ParallelRenderPool> parallelRenderPool;
+
+	std::atomic<int> processorTreeVersion { 0 };
+
 	friend class UserPresetHandler;
     friend class PresetLoadingThread;
 	friend class DelayedRenderer;
@@ -0,0 +1,193 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+namespace hise { using namespace juce;
+
+ParallelRenderPool::Worker::Worker(ParallelRenderPool& parent_, int threadIndex_) :
+	Thread("Parallel Render Thread " + String(threadIndex_)),
+	parent(parent_),
+	threadIndex(threadIndex_)
+{
+
+}
+
+void ParallelRenderPool::Worker::run()
+{
+	ScopedNoDenormals snd;
+
+	while (!threadShouldExit())
+	{
+		wait(-1);
+
+		if (threadShouldExit())
+			break;
+
+		// The active counter must be increased before checking the running flag,
+		// otherwise the task could be finished and replaced while this thread is still
+		// picking up an item.
+		++parent.numActiveWorkers;
+
+		if (parent.running.load())
+			parent.processItems(threadIndex);
+
+		--parent.numActiveWorkers;
+	}
+}
+
+ParallelRenderPool::ParallelRenderPool(int numWorkerThreads)
+{
+	running.store(false);
+	busy.store(false);
+	nextItem.store(0);
+	numItemsDone.store(0);
+	numActiveWorkers.store(0);
+
+	setNumWorkerThreads(numWorkerThreads);
+}
+
+ParallelRenderPool::~ParallelRenderPool()
+{
+	setNumWorkerThreads(0);
+}
+
+void ParallelRenderPool::setNumWorkerThreads(int newNumWorkerThreads)
+{
+	jassert(!busy.load());
+
+	newNumWorkerThreads = jlimit<int>(0, jmax<int>(0, SystemStats::getNumCpus() - 1), newNumWorkerThreads);
+
+	if (newNumWorkerThreads == workers.size())
+		return;
+
+	for (auto w : workers)
+		w->signalThreadShouldExit();
+
+	for (auto w : workers)
+	{
+		w->notify();
+		w->stopThread(1000);
+	}
+
+	workers.clear();
+
+	for (int i = 0; i < newNumWorkerThreads; i++)
+	{
+		auto w = workers.add(new Worker(*this, i + 1));
+
+		// The workers render audio while the audio thread waits for them, so
+		// they need the same (realtime) priority as the audio thread
+		w->startThread(10);
+	}
+}
+
+bool ParallelRenderPool::isWorkerThread(Thread::ThreadID threadId) const noexcept
+{
+	if (threadId == nullptr)
+		return false;
+
+	for (auto w : workers)
+	{
+		if (w->getThreadId() == threadId)
+			return true;
+	}
+
+	return false;
+}
+
+void ParallelRenderPool::run(Task& t, int numItems)
+{
+	bool expected = false;
+
+	if (numItems < 2 || !isEnabled() || !busy.compare_exchange_strong(expected, true))
+	{
+		for (int i = 0; i < numItems; i++)
+			t.processItem(i, 0);
+
+		return;
+	}
+
+	currentTask = &t;
+	numItemsInTask = numItems;
+	numItemsDone.store(0);
+	nextItem.store(0);
+	running.store(true);
+
+	for (auto w : workers)
+		w->notify();
+
+	processItems(0);
+
+	// At this point every item has been picked up, so this only waits for the
+	// items that are currently rendered by the workers (at most one per worker).
+	waitUntil([this, numItems]() { return numItemsDone.load() >= numItems; });
+
+	running.store(false);
+
+	// Wait until every worker that woke up during this task has left processItems()
+	waitUntil([this]() { return numActiveWorkers.load() == 0; });
+
+	currentTask = nullptr;
+	numItemsInTask = 0;
+
+	busy.store(false);
+}
+
+template <typename ConditionType> void ParallelRenderPool::waitUntil(const ConditionType& isDone)
+{
+	for (int i = 0; i < NumSpinsBeforeYield; i++)
+	{
+		if (isDone())
+			return;
+	}
+
+	// A worker might share the CPU with the audio thread, so give it the time slice
+	// instead of spinning until the end of our own.
+	while (!isDone())
+		Thread::yield();
+}
+
+void ParallelRenderPool::processItems(int threadIndex)
+{
+	for (;;)
+	{
+		const int index = nextItem.fetch_add(1);
+
+		if (index >= numItemsInTask)
+			break;
+
+		currentTask->processItem(index, threadIndex);
+
+		++numItemsDone;
+	}
+}
+
+} // namespace hise
@@ -0,0 +1,144 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+#ifndef PARALLELRENDERPOOL_H_INCLUDED
+#define PARALLELRENDERPOOL_H_INCLUDED
+
+namespace hise {
+using namespace juce;
+
+/** The number of additional real time threads that help the audio thread rendering.
+*
+*	If this is zero (the default), everything will be rendered on the audio thread.
+*	You can change the amount at runtime with ParallelRenderPool::setNumWorkerThreads()
+*	(in HISE it's the NumParallelRenderThreads setting in the Other settings).
+*/
+#ifndef HISE_NUM_PARALLEL_RENDER_THREADS
+#define HISE_NUM_PARALLEL_RENDER_THREADS 0
+#endif
+
+/** A fork-join thread pool that distributes work items of the audio callback across multiple cores.
+*	@ingroup core
+*
+*	The audio thread calls run() with a Task and the number of items. It will then wake up the worker
+*	threads and process items itself until all items are done, so the call returns only when the
+*	whole task is finished. The items are not assigned to the threads in advance: every thread picks
+*	the next unprocessed item, so a thread that finishes early takes over the remaining work of the others.
+*
+*	The worker threads run with realtime priority. Since the calling thread processes every item that
+*	was not picked up by a worker yet, it only has to wait for the items that are currently rendered
+*	on a worker thread.
+*
+*	The pool can only process one task at a time. If run() is called while another task is running
+*	(eg. if a task that is already executed in parallel tries to use the pool), the items will be
+*	processed on the calling thread.
+*/
+class ParallelRenderPool
+{
+public:
+
+	/** Subclass this and pass it to run(). */
+	struct Task
+	{
+		virtual ~Task() {};
+
+		/** This will be called for every item. The thread index is zero for the calling thread and
+		*	1...numWorkerThreads for the worker threads, so you can use it to access per-thread data.
+		*/
+		virtual void processItem(int itemIndex, int threadIndex) = 0;
+	};
+
+	ParallelRenderPool(int numWorkerThreads=HISE_NUM_PARALLEL_RENDER_THREADS);
+
+	~ParallelRenderPool();
+
+	/** Changes the amount of worker threads. Call this only from the message thread while the audio is suspended. */
+	void setNumWorkerThreads(int newNumWorkerThreads);
+
+	/** Returns the number of threads that process a task including the thread that calls run(). */
+	int getNumThreads() const noexcept { return workers.size() + 1; }
+
+	/** Returns true if there are worker threads that can process a task. */
+	bool isEnabled() const noexcept { return !workers.isEmpty(); }
+
+	/** Checks whether the given thread is one of the worker threads. */
+	bool isWorkerThread(Thread::ThreadID threadId) const noexcept;
+
+	/** Processes all items of the task and returns when they are finished.
+	*
+	*	If the pool is disabled or busy, the items will be processed on the calling thread.
+	*/
+	void run(Task& t, int numItems);
+
+private:
+
+	class Worker : public Thread
+	{
+	public:
+
+		Worker(ParallelRenderPool& parent_, int threadIndex_);
+
+		void run() override;
+
+	private:
+
+		ParallelRenderPool& parent;
+		const int threadIndex;
+	};
+
+	enum
+	{
+		NumSpinsBeforeYield = 1024
+	};
+
+	void processItems(int threadIndex);
+
+	/** Spins for a short time and then yields until the condition is true. */
+	template <typename ConditionType> void waitUntil(const ConditionType& isDone);
+
+	Task* currentTask = nullptr;
+	int numItemsInTask = 0;
+
+	std::atomic<bool> running;
+	std::atomic<bool> busy;
+	std::atomic<int> nextItem;
+	std::atomic<int> numItemsDone;
+	std::atomic<int> numActiveWorkers;
+
+	OwnedArray<Worker> workers;
+
+	JUCE_DECLARE_NON_COPYABLE(ParallelRenderPool);
+};
+
+} // namespace hise
+
+#endif  // PARALLELRENDERPOOL_H_INCLUDED
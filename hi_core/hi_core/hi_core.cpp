@@ -64,6 +64,7 @@
 #include "MainControllerHelpers.cpp"
 #include "LockHelpers.cpp"
 #include "LockfreeDispatcher.cpp"
+#include "ParallelRenderPool.cpp"
 #include "MainController.cpp"
 #include "MainControllerSubClasses.cpp"
 #include "SampleManager.cpp"
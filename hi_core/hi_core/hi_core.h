@@ -93,6 +93,7 @@
 #include "GlobalScriptCompileBroadcaster.h"
 #include "MainControllerHelpers.h"
 #include "LockHelpers.h"
+#include "ParallelRenderPool.h"
 #include "MainController.h"
 #include "SampleExporter.h"
 #include "Console.h"
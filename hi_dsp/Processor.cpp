@@ -81,6 +81,8 @@ Processor::~Processor()
 {
 	WARN_IF_AUDIO_THREAD(true, MainController::KillStateHandler::ProcessorDestructor);
 
+	getMainController()->processorTreeChanged();
+
 	getMainController()->getMacroManager().removeMacroControlsFor(this);
 
 	removeAllChangeListeners();
@@ -501,6 +501,10 @@ public:
 
 		void notifyListeners(Listener::EventType t, Processor* p)
 		{
+			// The Cleared event doesn't pass a processor, but the destructors of the removed processors update the version
+			if (p != nullptr)
+				p->getMainController()->processorTreeChanged();
+
 			ScopedLock sl(listeners.getLock());
 
 			for (auto l : listeners)
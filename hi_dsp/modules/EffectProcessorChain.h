@@ -161,6 +161,21 @@ public:
 		return false;
 	}
 
+	/** Checks if there is any voice effect that will be rendered in renderVoice(). */
+	bool hasActiveVoiceEffects() const
+	{
+		if (isBypassed())
+			return false;
+
+		for (int i = 0; i < voiceEffects.size(); i++)
+		{
+			if (!voiceEffects[i]->isBypassed())
+				return true;
+		}
+
+		return false;
+	}
+
 	void killMasterEffects()
 	{
 		if (hasTailingMasterEffects())
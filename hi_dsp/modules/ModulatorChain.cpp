@@ -404,6 +404,25 @@ void ModulatorChain::ModChainWithBuffer::calculateMonophonicModulationValues(int
 
 
 
+void ModulatorChain::ModChainWithBuffer::calculateBatchedEnvelopeValues(const int* voiceIndexes, int numVoices, int startSample, int numSamples)
+{
+	if (c->isVoiceStartChain || !c->hasActivePolyMods() || !c->hasActivePolyEnvelopes())
+		return;
+
+	jassert(startSample % HISE_CONTROL_RATE_DOWNSAMPLING_FACTOR == 0);
+
+	const int startSample_cr = startSample / HISE_CONTROL_RATE_DOWNSAMPLING_FACTOR;
+	const int numSamples_cr = numSamples / HISE_CONTROL_RATE_DOWNSAMPLING_FACTOR;
+
+	ModIterator<EnvelopeModulator> iter(c);
+
+	while (auto mod = iter.next())
+	{
+		if (!mod->isInMonophonicMode())
+			mod->calculateVoicesBatched(voiceIndexes, numVoices, startSample_cr, numSamples_cr);
+	}
+}
+
 void ModulatorChain::ModChainWithBuffer::calculateModulationValuesForCurrentVoice(int voiceIndex, int startSample, int numSamples)
 {
 	if (c->isVoiceStartChain)
@@ -639,6 +658,14 @@ float ModulatorChain::ModChainWithBuffer::getOneModulationValue(int startSample)
 	return currentVoiceData[downsampledOffset];
 }
 
+const float* ModulatorChain::ModChainWithBuffer::getControlRateVoiceValues() const
+{
+	// If you set this, the values are already expanded. Use getReadPointerForVoiceValues() instead
+	jassert(!options.expandToAudioRate);
+
+	return currentVoiceData;
+}
+
 float* ModulatorChain::ModChainWithBuffer::getScratchBuffer()
 {
 	return modBuffer.scratchBuffer;
@@ -167,6 +167,14 @@ public:
 		*/
 		void calculateModulationValuesForCurrentVoice(int voiceIndex, int startSample, int numSamples);
 
+		/** Calculates the envelopes of all given voices in one pass.
+		*
+		*	Call this before calculateModulationValuesForCurrentVoice() with all voices that will be rendered in this
+		*	block. The envelopes that support this will then just copy the values when the voice is calculated.
+		*	The startSample / numSample arguments are supposed to be at audio rate.
+		*/
+		void calculateBatchedEnvelopeValues(const int* voiceIndexes, int numVoices, int startSample, int numSamples);
+
 		/** This multiplies the modulation values with the given AudioSampleBuffer. 
 		*
 		*	Make sure you've expanded the values before using this.
@@ -224,6 +232,13 @@ public:
 		/** Returns the first value in the modulation data or the constant value. */
 		float getOneModulationValue(int startSample) const;
 
+		/** Returns the unexpanded control rate values of the current voice or nullptr if the modulation is constant.
+		*
+		*	The pointer refers to the start of the block, so use startSample / HISE_CONTROL_RATE_DOWNSAMPLING_FACTOR as index.
+		*	This is the block wide version of getOneModulationValue() for processors that update their state in sub blocks.
+		*/
+		const float* getControlRateVoiceValues() const;
+
 		/** Returns the scratch buffer. The scratch buffer is a aligned float array that's most likely in the cache,
 		*   but using this is rather hacky, so don't use it if there's another option. 
 		*/
@@ -70,6 +70,8 @@ lastClockCounter(0),
 wasPlayingInLastBuffer(false),
 bypassState(false)
 {
+	clearVoiceLookup();
+
 	modChains += { this, "GainModulation", ModulatorChain::ModulationType::Normal, Modulation::Mode::GainMode};
 	modChains += { this, "PitchModulation", ModulatorChain::ModulationType::Normal, Modulation::Mode::PitchMode};
 
@@ -482,18 +484,96 @@ void ModulatorSynth::renderVoice(int startSample, int numThisTime)
     
 	clearPendingRemoveVoices();
 
+	calculateBatchedModulationValues(startSample, numThisTime);
+
+	if (shouldRenderVoicesInParallel())
+	{
+		renderVoicesInParallel(startSample, numThisTime);
+	}
+	else
+	{
+		for (auto v : activeVoices)
+		{
+			jassert(!v->isInactive());
+
+			calculateModulationValuesForVoice(v, startSample, numThisTime);
+
+			v->renderNextBlock(internalBuffer, startSample, numThisTime);
+		}
+	}
+
+	clearPendingRemoveVoices();
+};
+
+bool ModulatorSynth::shouldRenderVoicesInParallel() const
+{
+	if (!canRenderVoicesInParallel() || activeVoices.size() < 2)
+		return false;
+
+	// The voice effects calculate their modulation per voice, so they can't be rendered concurrently
+	if (effectChain->hasActiveVoiceEffects())
+		return false;
+
+	return getMainController()->getParallelRenderPool().isEnabled();
+}
+
+void ModulatorSynth::renderVoicesInParallel(int startSample, int numThisTime)
+{
+	auto& r = parallelVoiceRenderer;
+
+	r.numVoices = 0;
+	r.startSample = startSample;
+	r.numSamples = numThisTime;
+
+	// The modulators write into the buffers of this synth, so the modulation
+	// is calculated on the audio thread and stored in each voice.
 	for (auto v : activeVoices)
 	{
 		jassert(!v->isInactive());
 
 		calculateModulationValuesForVoice(v, startSample, numThisTime);
+		v->storeModulationValues(startSample, numThisTime);
 
-		v->renderNextBlock(internalBuffer, startSample, numThisTime);
+		r.voices[r.numVoices++] = v;
 	}
 
-	clearPendingRemoveVoices();
-};
+	getMainController()->getParallelRenderPool().run(r, r.numVoices);
+
+	// Sum the voices in the same order as the serial rendering so that the output is identical
+	for (int i = 0; i < r.numVoices; i++)
+	{
+		auto v = r.voices[i];
+
+		v->clearStoredModulationValues();
+		v->handleDeferredReset();
+		v->addToOutputBuffer(internalBuffer, startSample, numThisTime);
+	}
+}
+
+void ModulatorSynth::ParallelVoiceRenderer::processItem(int itemIndex, int threadIndex)
+{
+	voices[itemIndex]->setRenderThreadIndex(threadIndex);
+	voices[itemIndex]->renderIntoVoiceBuffer(startSample, numSamples);
+}
+
+void ModulatorSynth::calculateBatchedModulationValues(int startSample, int numThisTime)
+{
+#if HISE_ENABLE_BATCHED_ENVELOPES
+	if (!useBatchedEnvelopes || activeVoices.size() < 2)
+		return;
 
+	int voiceIndexes[NUM_POLYPHONIC_VOICES];
+	int numVoices = 0;
+
+	for (auto v : activeVoices)
+		voiceIndexes[numVoices++] = v->getVoiceIndex();
+
+	for (auto& mb : modChains)
+		mb.calculateBatchedEnvelopeValues(voiceIndexes, numVoices, startSample, numThisTime);
+#else
+	ignoreUnused(startSample, numThisTime);
+#endif
+}
 	
 void ModulatorSynth::calculateModulationValuesForVoice(ModulatorSynthVoice * v, int startSample, int numThisTime)
 {
@@ -776,6 +856,25 @@ void ModulatorSynth::startVoiceWithHiseEvent(ModulatorSynthVoice* voice, Synthes
 
 	activeVoices.insert(voice);
 
+	const int voiceIndex = voice->getVoiceIndex();
+	const int noteNumber = e.getNoteNumber();
+
+	startedVoices.setBit(voiceIndex, true);
+
+	auto& registeredNoteNumber = noteNumberForVoice[voiceIndex];
+
+	if (registeredNoteNumber != -1)
+	{
+		voicesForNoteNumber[registeredNoteNumber].setBit(voiceIndex, false);
+		registeredNoteNumber = -1;
+	}
+
+	if (isPositiveAndBelow(noteNumber, 128))
+	{
+		voicesForNoteNumber[noteNumber].setBit(voiceIndex, true);
+		registeredNoteNumber = noteNumber;
+	}
+
 	Synthesiser::startVoice(static_cast<SynthesiserVoice*>(voice), sound, e.getChannel(), e.getNoteNumber(), e.getFloatVelocity());
 
 	voice->saveStartUptimeDelta();
@@ -935,6 +1034,66 @@ void ModulatorSynth::flagVoiceAsRemoved(ModulatorSynthVoice* v)
 	jassert(v->isInactive());
 
 	pendingRemoveVoices.insert(v);
+
+	const int voiceIndex = v->getVoiceIndex();
+
+	if (isPositiveAndBelow(voiceIndex, NUM_POLYPHONIC_VOICES))
+	{
+		startedVoices.setBit(voiceIndex, false);
+
+		auto& noteNumber = noteNumberForVoice[voiceIndex];
+
+		if (noteNumber != -1)
+		{
+			voicesForNoteNumber[noteNumber].setBit(voiceIndex, false);
+			noteNumber = -1;
+		}
+	}
+}
+
+ModulatorSynthVoice* ModulatorSynth::getFirstInactiveVoice() const
+{
+	if (!useVoiceBitMasks)
+		return getFirstInactiveVoiceLinear();
+
+	const int index = startedVoices.findFirstClearedBit(voices.size());
+
+	if (index != -1)
+	{
+		auto v = static_cast<ModulatorSynthVoice*>(voices.getUnchecked(index));
+
+		jassert(v->getVoiceIndex() == index);
+
+		if (v->isInactive())
+			return v;
+	}
+
+	// The mask is either full or out of sync, so we need to search the slow way
+	return getFirstInactiveVoiceLinear();
+}
+
+ModulatorSynthVoice* ModulatorSynth::getFirstInactiveVoiceLinear() const
+{
+	for (auto v : voices)
+	{
+		auto mv = static_cast<ModulatorSynthVoice*>(v);
+
+		if (mv->isInactive())
+			return mv;
+	}
+
+	return nullptr;
+}
+
+void ModulatorSynth::clearVoiceLookup()
+{
+	startedVoices.clear();
+
+	for (auto& m : voicesForNoteNumber)
+		m.clear();
+
+	for (auto& n : noteNumberForVoice)
+		n = -1;
 }
 
 void ModulatorSynth::finaliseModChains()
@@ -1026,6 +1185,8 @@ bool ModulatorSynth::handleVoiceLimit(int numSoundsToBeStarted)
 
 	bool killedSomething = false;
 
+	// The voice to steal is the oldest one, which can't be looked up in a bit mask,
+	// so killLastVoice() still iterates over the active voices (not all voices).
 	while (numFreeVoices <= numSoundsToBeStarted)
 	{
 		const bool forceKill = numFreeVoices == 0;
@@ -1079,24 +1240,39 @@ void ModulatorSynth::noteOn(const HiseEvent &m)
 
 	for(auto sound: soundsToBeStarted)
 	{
-		ModulatorSynthVoice* v = nullptr;
-
         // If hitting a note that's still ringing, stop it first (it could be
         // still playing because of the sustain or sostenuto pedal).
-        for (int j = 0; j < voices.size(); j++)
-        {
-            ModulatorSynthVoice* const voice = static_cast<ModulatorSynthVoice*>(voices.getUnchecked (j));
+		if (!useVoiceBitMasks)
+		{
+			for (auto v : voices)
+			{
+				ModulatorSynthVoice* const voice = static_cast<ModulatorSynthVoice*>(v);
 
-            if (voice->getCurrentlyPlayingNote() == midiNoteNumber // Use the untransposed number for detecting repeated notes
-                    && (retriggerWithDifferentChannels || voice->isPlayingChannel (midiChannel)) 
+				if (voice->getCurrentlyPlayingNote() == midiNoteNumber // Use the untransposed number for detecting repeated notes
+					&& (retriggerWithDifferentChannels || voice->isPlayingChannel(midiChannel))
 					&& !(voice->getCurrentHiseEvent() == m))
-			{
-				handleRetriggeredNote(voice);
+				{
+					handleRetriggeredNote(voice);
+				}
 			}
-				
-			if(v == nullptr && voice->isInactive())
-				v = voice;
-        }
+		}
+		else if (isPositiveAndBelow(midiNoteNumber, 128))
+		{
+			// Only the voices that were started with this note number need to be checked
+			voicesForNoteNumber[midiNoteNumber].forEachSetBit([&](int voiceIndex)
+			{
+				ModulatorSynthVoice* const voice = static_cast<ModulatorSynthVoice*>(voices.getUnchecked(voiceIndex));
+
+				if (voice->getCurrentlyPlayingNote() == midiNoteNumber // Use the untransposed number for detecting repeated notes
+					&& (retriggerWithDifferentChannels || voice->isPlayingChannel(midiChannel))
+					&& !(voice->getCurrentHiseEvent() == m))
+				{
+					handleRetriggeredNote(voice);
+				}
+			});
+		}
+
+		ModulatorSynthVoice* v = getFirstInactiveVoice();
 
 		if( v != nullptr)
 		{
@@ -1288,13 +1464,13 @@ void ModulatorSynthVoice::applyGainModulation(int startSample, int numSamples, b
 {
 	if (copyLeftChannel)
 	{
-		if (auto modValues = getOwnerSynth()->getVoiceGainValues())
+		if (auto modValues = getGainValues())
 		{
 			FloatVectorOperations::multiply(voiceBuffer.getWritePointer(0, startSample), modValues + startSample, numSamples);
 		}
 		else
 		{
-			const float gainMod = getOwnerSynth()->getConstantGainModValue();
+			const float gainMod = getConstantGainValue();
 
 			if(gainMod != 1.0f)
 				FloatVectorOperations::multiply(voiceBuffer.getWritePointer(0, startSample), modValues + startSample, numSamples);
@@ -1304,14 +1480,14 @@ void ModulatorSynthVoice::applyGainModulation(int startSample, int numSamples, b
 	}
 	else
 	{
-		if (auto modValues = getOwnerSynth()->getVoiceGainValues())
+		if (auto modValues = getGainValues())
 		{
 			FloatVectorOperations::multiply(voiceBuffer.getWritePointer(0, startSample), modValues + startSample, numSamples);
 			FloatVectorOperations::multiply(voiceBuffer.getWritePointer(1, startSample), modValues + startSample, numSamples);
 		}
 		else
 		{
-			const float gainMod = getOwnerSynth()->getConstantGainModValue();
+			const float gainMod = getConstantGainValue();
 
 			if (gainMod != 1.0f)
 			{
@@ -1631,6 +1807,7 @@ void ModulatorSynth::deleteAllVoices()
     
 	activeVoices.clear();
 	pendingRemoveVoices.clear();
+	clearVoiceLookup();
 	lastStartedVoice = nullptr;
 	clearVoices();
 }
@@ -1648,6 +1825,7 @@ void ModulatorSynth::resetAllVoices()
         lastStartedVoice = nullptr;
         activeVoices.clearQuick();
         pendingRemoveVoices.clearQuick();
+        clearVoiceLookup();
         
     }
     
@@ -1736,33 +1914,108 @@ void ModulatorSynthVoice::renderNextBlock (AudioSampleBuffer& outputBuffer, int
 {
 	if (isActive)
     { 
-		calculateBlock(startSample, numSamples);
+		renderIntoVoiceBuffer(startSample, numSamples);
+		addToOutputBuffer(outputBuffer, startSample, numSamples);
+    }
+}
 
-		if (gainFader.isSmoothing())
-		{
-			applyEventVolumeFade(startSample, numSamples);
-		}
-		else if (eventGainFactor != 1.0f)
-		{
-			applyEventVolumeFactor(startSample, numSamples);
-		}
+void ModulatorSynthVoice::renderIntoVoiceBuffer(int startSample, int numSamples)
+{
+	calculateBlock(startSample, numSamples);
 
-		if(killThisVoice)
-		{
-			applyKillFadeout(startSample, numSamples);
-		}
+	if (gainFader.isSmoothing())
+	{
+		applyEventVolumeFade(startSample, numSamples);
+	}
+	else if (eventGainFactor != 1.0f)
+	{
+		applyEventVolumeFactor(startSample, numSamples);
+	}
 
-		const int maxChannelAmount = jmin<int>(voiceBuffer.getNumChannels(), outputBuffer.getNumChannels());
+	if(killThisVoice)
+	{
+		applyKillFadeout(startSample, numSamples);
+	}
+}
 
-		for (int i = 0; i < maxChannelAmount; i++)
-		{
-			FloatVectorOperations::add(outputBuffer.getWritePointer(i, startSample), voiceBuffer.getReadPointer(i, startSample), numSamples);
-		}
+void ModulatorSynthVoice::addToOutputBuffer(AudioSampleBuffer& outputBuffer, int startSample, int numSamples)
+{
+	const int maxChannelAmount = jmin<int>(voiceBuffer.getNumChannels(), outputBuffer.getNumChannels());
 
+	for (int i = 0; i < maxChannelAmount; i++)
+	{
+		FloatVectorOperations::add(outputBuffer.getWritePointer(i, startSample), voiceBuffer.getReadPointer(i, startSample), numSamples);
+	}
 
-		// checks if any envelopes are active and in their release state and calls stopNote until they are finished.
-		checkRelease();
-    }
+	// checks if any envelopes are active and in their release state and calls stopNote until they are finished.
+	checkRelease();
+
+	updateDisplayValues();
+}
+
+void ModulatorSynthVoice::storeModulationValues(int startSample, int numSamples)
+{
+	jassert(storedModulationValues.getNumSamples() >= startSample + numSamples);
+
+	if (auto pitchValues = ownerSynth->getPitchValuesForVoice())
+	{
+		FloatVectorOperations::copy(storedModulationValues.getWritePointer(0, startSample), pitchValues + startSample, numSamples);
+		hasStoredPitchValues = true;
+	}
+	else
+		hasStoredPitchValues = false;
+
+	if (auto gainValues = ownerSynth->getVoiceGainValues())
+	{
+		FloatVectorOperations::copy(storedModulationValues.getWritePointer(1, startSample), gainValues + startSample, numSamples);
+		hasStoredGainValues = true;
+	}
+	else
+		hasStoredGainValues = false;
+
+	storedConstantGainValue = ownerSynth->getConstantGainModValue();
+	useStoredModulationValues = true;
+}
+
+float* ModulatorSynthVoice::getPitchValues()
+{
+	if (useStoredModulationValues)
+		return hasStoredPitchValues ? storedModulationValues.getWritePointer(0) : nullptr;
+
+	return ownerSynth->getPitchValuesForVoice();
+}
+
+const float* ModulatorSynthVoice::getGainValues() const
+{
+	if (useStoredModulationValues)
+		return hasStoredGainValues ? storedModulationValues.getReadPointer(1) : nullptr;
+
+	return ownerSynth->getVoiceGainValues();
+}
+
+void ModulatorSynthVoice::resetVoiceAfterRendering()
+{
+	if (isRenderedInParallel())
+		resetPending = true;
+	else
+		resetVoice();
+}
+
+void ModulatorSynthVoice::handleDeferredReset()
+{
+	if (resetPending)
+	{
+		resetPending = false;
+		resetVoice();
+	}
+}
+
+float ModulatorSynthVoice::getConstantGainValue() const
+{
+	if (useStoredModulationValues)
+		return storedConstantGainValue;
+
+	return ownerSynth->getConstantGainModValue();
 }
 
 void ModulatorSynthVoice::setCurrentHiseEvent(const HiseEvent &m)
@@ -46,6 +46,89 @@ typedef HiseEventBuffer EVENT_BUFFER_TO_USE;
 
 using VoiceStack = UnorderedStack<ModulatorSynthVoice*>;
 
+/** A bit mask with one bit for every voice of a ModulatorSynth.
+*
+*	This is used for the constant time lookup of free voices and voices that play a certain note.
+*/
+class VoiceBitMask
+{
+public:
+
+	VoiceBitMask() noexcept { clear(); }
+
+	void clear() noexcept { memset(data, 0, sizeof(data)); }
+
+	void setBit(int voiceIndex, bool shouldBeSet) noexcept
+	{
+		jassert(isPositiveAndBelow(voiceIndex, NUM_POLYPHONIC_VOICES));
+
+		const uint32 mask = 1u << (voiceIndex & 31);
+
+		if (shouldBeSet)
+			data[voiceIndex >> 5] |= mask;
+		else
+			data[voiceIndex >> 5] &= ~mask;
+	}
+
+	bool operator[](int voiceIndex) const noexcept { return (data[voiceIndex >> 5] & (1u << (voiceIndex & 31))) != 0; }
+
+	/** Returns the index of the first cleared bit below numVoices or -1 if all bits are set. */
+	int findFirstClearedBit(int numVoices) const noexcept
+	{
+		for (int i = 0; i < NumWords; i++)
+		{
+			const uint32 freeBits = ~data[i];
+
+			if (freeBits != 0)
+			{
+				const int index = i * 32 + countTrailingZeros(freeBits);
+				return index < numVoices ? index : -1;
+			}
+		}
+
+		return -1;
+	}
+
+	/** Calls the function with the index of every set bit. 
+	*
+	*	This iterates over a copy, so you can change the mask in the function. */
+	template <typename F> void forEachSetBit(const F& f) const
+	{
+		uint32 copy[NumWords];
+		memcpy(copy, data, sizeof(data));
+
+		for (int i = 0; i < NumWords; i++)
+		{
+			uint32 bits = copy[i];
+
+			while (bits != 0)
+			{
+				f(i * 32 + countTrailingZeros(bits));
+				bits &= bits - 1;
+			}
+		}
+	}
+
+private:
+
+	static int countTrailingZeros(uint32 v) noexcept
+	{
+		jassert(v != 0);
+
+#if JUCE_MSVC
+		unsigned long index;
+		_BitScanForward(&index, v);
+		return (int)index;
+#else
+		return __builtin_ctz(v);
+#endif
+	}
+
+	enum { NumWords = (NUM_POLYPHONIC_VOICES + 31) / 32 };
+
+	uint32 data[NumWords];
+};
+
 /** The base class for all sound generators in HISE.
 	@ingroup dsp_base_classes
 
@@ -171,6 +254,22 @@ public:
 
 	void calculateModulationValuesForVoice(ModulatorSynthVoice * v, int startSample, int numThisTime);;
 
+	/** Calculates the envelopes of all active voices in one pass before the voices are rendered. */
+	void calculateBatchedModulationValues(int startSample, int numThisTime);
+
+	/** Override this and return true if the voices of this synth can be rendered on the worker threads of the ParallelRenderPool.
+	*
+	*	The calculateBlock() method of the voice must then be thread safe: it may only change the state of the voice itself
+	*	and must use ModulatorSynthVoice::getPitchValues() and getGainValues() instead of the methods of the ModulatorSynth.
+	*/
+	virtual bool canRenderVoicesInParallel() const { return false; }
+
+	/** Checks whether the active voices of this block should be rendered in parallel. 
+	*
+	*	Override this if the synth has features that can't be rendered concurrently (and call the base class method).
+	*/
+	virtual bool shouldRenderVoicesInParallel() const;
+
 	void clearPendingRemoveVoices();
 
 	/** This method is called to handle all modulatorchains after the voice rendering and handles the GUI metering. It assumes stereo mode.
@@ -378,6 +477,12 @@ public:
 
 	void setKillRetriggeredNote(bool shouldBeKilled) { shouldKillRetriggeredNote = shouldBeKilled; }
 
+	/** Enables the batched calculation of the envelopes. This is enabled by default if HISE_ENABLE_BATCHED_ENVELOPES is set. */
+	void setUseBatchedEnvelopes(bool shouldUseBatchedEnvelopes) { useBatchedEnvelopes = shouldUseBatchedEnvelopes; }
+
+	/** Enables the bit mask lookup of free and retriggered voices in noteOn(). If disabled, all voices are searched. */
+	void setUseVoiceBitMasks(bool shouldUseVoiceBitMasks) { useVoiceBitMasks = shouldUseVoiceBitMasks; }
+
 	/** specifies the behaviour when a note is started that is already ringing. By default, it is killed, but you can overwrite it to make something else. */
 	virtual void handleRetriggeredNote(ModulatorSynthVoice *voice);
 
@@ -470,12 +575,42 @@ public:
 	
 	void flagVoiceAsRemoved(ModulatorSynthVoice* v);
 
+	/** Returns the inactive voice with the lowest index using the voice bit mask. */
+	ModulatorSynthVoice* getFirstInactiveVoice() const;
+
+	/** Returns the inactive voice with the lowest index by searching all voices. */
+	ModulatorSynthVoice* getFirstInactiveVoiceLinear() const;
+
 	UnorderedStack<ModulatorSynthSound*> soundsToBeStarted;
 
 private:
 
 	VoiceStack pendingRemoveVoices;
 
+	void clearVoiceLookup();
+
+	// A bit is set for every voice between startVoiceWithHiseEvent() and flagVoiceAsRemoved()
+	VoiceBitMask startedVoices;
+
+	// The started voices for each (untransposed) note number, used for detecting retriggered notes
+	VoiceBitMask voicesForNoteNumber[128];
+	int noteNumberForVoice[NUM_POLYPHONIC_VOICES];
+
+	struct ParallelVoiceRenderer : public ParallelRenderPool::Task
+	{
+		void processItem(int itemIndex, int threadIndex) override;
+
+		ModulatorSynthVoice* voices[NUM_POLYPHONIC_VOICES];
+		int numVoices = 0;
+		int startSample = 0;
+		int numSamples = 0;
+	};
+
+	/** Calculates the modulation of all voices on the audio thread and renders them with the ParallelRenderPool. */
+	void renderVoicesInParallel(int startSample, int numThisTime);
+
+	ParallelVoiceRenderer parallelVoiceRenderer;
+
 protected:
 
 	
@@ -547,6 +682,10 @@ private:
 
 	bool shouldKillRetriggeredNote = true;
 
+	bool useBatchedEnvelopes = HISE_ENABLE_BATCHED_ENVELOPES;
+
+	bool useVoiceBitMasks = true;
+
 	std::atomic<double> synthTimerIntervals[4];
 	std::atomic<double> nextTimerCallbackTimes[4];
 
@@ -600,7 +739,8 @@ public:
 		startUptime(DBL_MAX),
 		killFadeLevel(1.0f),
 		killFadeFactor(0.5f),
-		isTailing(false)
+		isTailing(false),
+		storedModulationValues(2, 0)
 		
 	{
 		pitchFader.setValueWithoutSmoothing(1.0);
@@ -614,6 +754,13 @@ public:
 
 
 	virtual void calculateBlock(int startSample, int numSamples) = 0;
+
+	/** Override this and update the display values of the synth (eg. the playback position) if this is the last started voice.
+	*
+	*	This is called on the audio thread after the voice was rendered. Don't do this in calculateBlock(), it might run on a
+	*	worker thread of the ParallelRenderPool.
+	*/
+	virtual void updateDisplayValues() {}
 	
 	bool isPitchFadeActive() const noexcept
 	{
@@ -681,8 +828,57 @@ public:
 		SynthesiserVoice::setCurrentPlaybackSampleRate(sampleRate);
 
 		ProcessorHelpers::increaseBufferIfNeeded(voiceBuffer, samplesPerBlock);
+
+		if (ownerSynth->canRenderVoicesInParallel())
+			ProcessorHelpers::increaseBufferIfNeeded(storedModulationValues, samplesPerBlock);
 	}
 
+	/** Renders the voice into its internal buffer without adding it to the output.
+	*
+	*	This is the first part of renderNextBlock() and will be called on a worker thread if the synth renders its voices in parallel.
+	*/
+	void renderIntoVoiceBuffer(int startSample, int numSamples);
+
+	/** Adds the internal buffer to the output, checks the release and updates the display values. This is the second part of renderNextBlock(). */
+	void addToOutputBuffer(AudioSampleBuffer& outputBuffer, int startSample, int numSamples);
+
+	/** Copies the current gain and pitch modulation values of the owner synth so that the voice can be rendered on another thread.
+	*
+	*	The modulation values are calculated one voice after another into the buffers of the ModulatorSynth, so they would be
+	*	overwritten by the next voice before this voice is rendered.
+	*/
+	void storeModulationValues(int startSample, int numSamples);
+
+	/** Makes getPitchValues() and getGainValues() use the buffers of the ModulatorSynth again. */
+	void clearStoredModulationValues() noexcept 
+	{ 
+		useStoredModulationValues = false; 
+		renderThreadIndex = 0;
+	}
+
+	/** Returns true if the voice is currently rendered by the ParallelRenderPool. */
+	bool isRenderedInParallel() const noexcept { return useStoredModulationValues; }
+
+	/** The index of the ParallelRenderPool thread that renders this voice (zero if it's rendered on the audio thread). */
+	int getRenderThreadIndex() const noexcept { return renderThreadIndex; }
+
+	void setRenderThreadIndex(int newThreadIndex) noexcept { renderThreadIndex = newThreadIndex; }
+
+	/** Resets the voice or defers the reset until the parallel rendering is finished (resetVoice() changes the state of the synth). */
+	void resetVoiceAfterRendering();
+
+	/** Calls resetVoice() if resetVoiceAfterRendering() was called during the parallel rendering. */
+	void handleDeferredReset();
+
+	/** Returns the pitch values for this voice or nullptr if there is no pitch modulation. */
+	float* getPitchValues();
+
+	/** Returns the gain values for this voice or nullptr if the gain modulation is constant. */
+	const float* getGainValues() const;
+
+	/** Returns the constant gain modulation value for this voice. */
+	float getConstantGainValue() const;
+
 	virtual void setInactive()
 	{
 		// Call this only on non active notes!
@@ -891,6 +1087,14 @@ private:
 	
 	double startUptime;
 
+	AudioSampleBuffer storedModulationValues;
+	bool useStoredModulationValues = false;
+	bool hasStoredPitchValues = false;
+	bool hasStoredGainValues = false;
+	float storedConstantGainValue = 1.0f;
+	int renderThreadIndex = 0;
+	bool resetPending = false;
+
 	ModulatorSynth* const ownerSynth;
 
 	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ModulatorSynthVoice)
@@ -126,6 +126,150 @@ void ModulatorSynthChain::prepareToPlay(double newSampleRate, int samplesPerBloc
 	ModulatorSynth::prepareToPlay(newSampleRate, samplesPerBlock);
 
 	for (int i = 0; i < synths.size(); i++) synths[i]->prepareToPlay(newSampleRate, samplesPerBlock);
+
+	updateParallelRenderBuffer();
+}
+
+void ModulatorSynthChain::updateParallelRenderBuffer()
+{
+	if (!getMainController()->getParallelRenderPool().isEnabled())
+		return;
+
+	// Every child synth that is rendered in parallel needs its own output channels
+	const int numChannels = getMatrix().getNumSourceChannels();
+	const int numSamples = getLargestBlockSize();
+	const int numChannelsNeeded = numChannels * synths.size();
+
+	if (numSamples <= 0 || numChannels <= 0)
+		return;
+
+	LOCK_PROCESSING_CHAIN(this);
+
+	if (numChannelsNeeded > parallelRenderBuffer.getNumChannels() || numSamples > parallelRenderBuffer.getNumSamples())
+		parallelRenderBuffer.setSize(jmax(numChannelsNeeded, parallelRenderBuffer.getNumChannels()), numSamples);
+
+	parallelChildRenderer.synths.ensureStorageAllocated(synths.size());
+	parallelChildFlags.ensureStorageAllocated(synths.size());
+	maxNumParallelSynths = jmin(parallelRenderBuffer.getNumChannels() / numChannels, synths.size());
+}
+
+bool ModulatorSynthChain::canRenderChildSynthInParallel(const Processor* p)
+{
+	// Scripts can access other modules and the global state
+	if (dynamic_cast<const JavascriptProcessor*>(p) != nullptr)
+		return false;
+
+	// These create artificial events with the EventIdHandler of the MainController
+	if (dynamic_cast<const ScriptBaseMidiProcessor*>(p) != nullptr || dynamic_cast<const MidiPlayer*>(p) != nullptr)
+		return false;
+
+	for (int i = 0; i < p->getNumChildProcessors(); i++)
+	{
+		auto c = p->getChildProcessor(i);
+
+		if (c != nullptr && !canRenderChildSynthInParallel(c))
+			return false;
+	}
+
+	return true;
+}
+
+void ModulatorSynthChain::updateParallelChildFlags()
+{
+	const int version = getMainController()->getProcessorTreeVersion();
+
+	if (version == parallelChildFlagsVersion && parallelChildFlags.size() == synths.size())
+		return;
+
+	parallelChildFlagsVersion = version;
+	parallelChildFlags.clearQuick();
+
+	for (auto s : synths)
+		parallelChildFlags.add(!ProcessorHelpers::is<GlobalModulatorContainer>(s) && canRenderChildSynthInParallel(s));
+}
+
+void ModulatorSynthChain::renderChildSynths(int numSamples)
+{
+	auto& pool = getMainController()->getParallelRenderPool();
+	auto& r = parallelChildRenderer;
+
+	const int numChannels = internalBuffer.getNumChannels();
+	int maxNumSynths = 0;
+
+	if (pool.isEnabled() && numChannels <= NUM_MAX_CHANNELS && numSamples <= parallelRenderBuffer.getNumSamples())
+		maxNumSynths = jmin(maxNumParallelSynths, parallelRenderBuffer.getNumChannels() / jmax(1, numChannels));
+
+	r.synths.clearQuick();
+	r.outputBuffer = &parallelRenderBuffer;
+	r.eventBuffer = &eventBuffer;
+	r.numChannels = numChannels;
+	r.numSamples = numSamples;
+
+	if (maxNumSynths > 1)
+		updateParallelChildFlags();
+
+	// Consecutive synths that can be rendered in parallel are collected and rendered when the next synth
+	// has to be rendered on the audio thread. This keeps the rendering and summing order of the serial
+	// rendering (and the global modulator container in front of the synths that use its values).
+	for (int i = 0; i < synths.size(); i++)
+	{
+		auto s = synths[i];
+
+		if (s->isSoftBypassed())
+			continue;
+
+		if (maxNumSynths > 1 && parallelChildFlags[i])
+		{
+			r.synths.add(s);
+
+			if (r.synths.size() == maxNumSynths)
+				renderParallelChildSynths();
+		}
+		else
+		{
+			renderParallelChildSynths();
+			s->renderNextBlockWithModulators(internalBuffer, eventBuffer);
+		}
+	}
+
+	renderParallelChildSynths();
+}
+
+void ModulatorSynthChain::renderParallelChildSynths()
+{
+	auto& r = parallelChildRenderer;
+
+	if (r.synths.size() == 1)
+	{
+		r.synths[0]->renderNextBlockWithModulators(internalBuffer, eventBuffer);
+	}
+	else if (r.synths.size() > 1)
+	{
+		getMainController()->getParallelRenderPool().run(r, r.synths.size());
+
+		for (int i = 0; i < r.synths.size(); i++)
+		{
+			for (int c = 0; c < r.numChannels; c++)
+				FloatVectorOperations::add(internalBuffer.getWritePointer(c), parallelRenderBuffer.getReadPointer(i * r.numChannels + c), r.numSamples);
+		}
+	}
+
+	r.synths.clearQuick();
+}
+
+void ModulatorSynthChain::ParallelChildRenderer::processItem(int itemIndex, int /*threadIndex*/)
+{
+	float* channels[NUM_MAX_CHANNELS];
+
+	for (int c = 0; c < numChannels; c++)
+	{
+		channels[c] = outputBuffer->getWritePointer(itemIndex * numChannels + c);
+		FloatVectorOperations::clear(channels[c], numSamples);
+	}
+
+	AudioSampleBuffer output(channels, numChannels, numSamples);
+
+	synths[itemIndex]->renderNextBlockWithModulators(output, *eventBuffer);
 }
 
 void ModulatorSynthChain::numSourceChannelsChanged()
@@ -144,7 +288,7 @@ void ModulatorSynthChain::numSourceChannelsChanged()
 
 	ModulatorSynth::numSourceChannelsChanged();
 
-	
+	updateParallelRenderBuffer();
 }
 
 void ModulatorSynthChain::numDestinationChannelsChanged()
@@ -244,11 +388,7 @@ void ModulatorSynthChain::renderNextBlockWithModulators(AudioSampleBuffer &buffe
 	internalBuffer.setSize(getMatrix().getNumSourceChannels(), numSamples, true, false, true);
 
 	// Process the Synths and add store their output in the internal buffer
-	for (int i = 0; i < synths.size(); i++)
-    {
-        if (!synths[i]->isSoftBypassed())
-            synths[i]->renderNextBlockWithModulators(internalBuffer, eventBuffer);
-    }
+	renderChildSynths(numSamples);
 
 	HiseEventBuffer::Iterator eventIterator(eventBuffer);
 
@@ -549,6 +689,8 @@ void ModulatorSynthChain::ModulatorSynthChainHandler::add(Processor *newProcesso
 		synth->synths.insert(index, ms);
 	}
 
+	synth->updateParallelRenderBuffer();
+
 	notifyListeners(Listener::ProcessorAdded, newProcessor);
 }
 
@@ -234,11 +234,49 @@ public:
 
 private:
 
+	struct ParallelChildRenderer : public ParallelRenderPool::Task
+	{
+		void processItem(int itemIndex, int threadIndex) override;
+
+		Array<ModulatorSynth*> synths;
+		AudioSampleBuffer* outputBuffer = nullptr;
+		const HiseEventBuffer* eventBuffer = nullptr;
+		int numChannels = 0;
+		int numSamples = 0;
+	};
+
+	/** Checks if the processor and all its children can be rendered on another thread. */
+	static bool canRenderChildSynthInParallel(const Processor* p);
+
+	/** Checks the child synths again if a processor was added or removed since the last check. */
+	void updateParallelChildFlags();
+
+	/** Renders the child synths into the internal buffer.
+	*
+	*	If the ParallelRenderPool is enabled, consecutive child synths without scripts are rendered concurrently
+	*	into their own part of the parallelRenderBuffer and added to the internal buffer in their original order.
+	*/
+	void renderChildSynths(int numSamples);
+
+	/** Renders the collected child synths in parallel, adds them to the internal buffer and clears the list. */
+	void renderParallelChildSynths();
+
+	/** Allocates the buffer that stores the output of the child synths that are rendered in parallel. */
+	void updateParallelRenderBuffer();
+
 	HiseEvent::ChannelFilterData activeChannels;
 	ModulatorSynthChainHandler handler;
 	int numVoices;
 	float vuValue;
 	OwnedArray<ModulatorSynth> synths;
+
+	AudioSampleBuffer parallelRenderBuffer;
+	ParallelChildRenderer parallelChildRenderer;
+	int maxNumParallelSynths = 0;
+
+	// The result of canRenderChildSynthInParallel() for every child synth
+	Array<bool> parallelChildFlags;
+	int parallelChildFlagsVersion = -1;
 	ScopedPointer<FactoryType> modulatorSynthFactory;
 	ScopedPointer<FactoryType::Constrainer> constrainer;
 	String packageName;
@@ -347,6 +347,7 @@ void ModulatorSynthGroupVoice::calculateNoFMVoiceInternal(ModulatorSynth* childS
 		calculatePitchValuesForChildVoice(childSynth, childVoice, startSample, numSamples, voicePitchValues);
 
 		childVoice->calculateBlock(startSample, numSamples);
+		childVoice->updateDisplayValues();
 		
 		if (childVoice->shouldBeKilled())
 		{
@@ -482,6 +483,7 @@ void ModulatorSynthGroupVoice::calculateFMBlock(ModulatorSynthGroup * group, int
 	calculatePitchValuesForChildVoice(modSynth, modVoice, startSample, numSamples, voicePitchValues, false);
 
 	modVoice->calculateBlock(startSample, numSamples);
+	modVoice->updateDisplayValues();
 
 	if (modVoice->shouldBeKilled())
 	{
@@ -589,6 +591,7 @@ void ModulatorSynthGroupVoice::calculateFMCarrierInternal(ModulatorSynthGroup *
 		carrierSynth->overwritePitchValues(carrierPitchValues, startSample, numSamples);
 
 		carrierVoice->calculateBlock(startSample, numSamples);
+		carrierVoice->updateDisplayValues();
 
 		if (carrierVoice->shouldBeKilled())
 		{
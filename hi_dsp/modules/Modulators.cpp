@@ -550,6 +550,82 @@ EnvelopeModulator::EnvelopeModulator(MainController *mc, const String &id, int v
 	parameterNames.add("Retrigger");
 };
 
+void EnvelopeModulator::VoiceBatch::prepare(int maxNumVoices_, int samplesPerBlock)
+{
+	const int numSamplesToAllocate = samplesPerBlock / HISE_CONTROL_RATE_DOWNSAMPLING_FACTOR + 1;
+
+	if (maxNumVoices_ == maxNumVoices && numSamplesToAllocate <= maxNumSamples)
+		return;
+
+	maxNumVoices = maxNumVoices_;
+	maxNumSamples = numSamplesToAllocate;
+
+	data.calloc((size_t)(maxNumVoices * (6 + maxNumSamples)));
+
+	values = data.get();
+	previousValues = values + maxNumVoices;
+	bases = previousValues + maxNumVoices;
+	coefs = bases + maxNumVoices;
+	lowerLimits = coefs + maxNumVoices;
+	upperLimits = lowerLimits + maxNumVoices;
+	output = upperLimits + maxNumVoices;
+
+	voiceIndexes.calloc((size_t)maxNumVoices);
+	laneIndexes.malloc((size_t)maxNumVoices);
+
+	for (int i = 0; i < maxNumVoices; i++)
+		laneIndexes[i] = -1;
+
+	numVoices = 0;
+}
+
+bool EnvelopeModulator::VoiceBatch::begin(int startSample_, int numSamples_) noexcept
+{
+	for (int i = 0; i < numVoices; i++)
+		laneIndexes[voiceIndexes[i]] = -1;
+
+	numVoices = 0;
+	startSample = startSample_;
+	numSamples = numSamples_;
+
+	return numSamples_ <= maxNumSamples;
+}
+
+int EnvelopeModulator::VoiceBatch::addVoice(int voiceIndex, float value) noexcept
+{
+	jassert(isPositiveAndBelow(voiceIndex, maxNumVoices));
+	jassert(numVoices < maxNumVoices);
+
+	const int lane = numVoices++;
+
+	voiceIndexes[lane] = voiceIndex;
+	laneIndexes[voiceIndex] = lane;
+	values[lane] = value;
+
+	return lane;
+}
+
+bool EnvelopeModulator::VoiceBatch::copyValues(int voiceIndex, float* destination, int startSample_, int numSamples_) noexcept
+{
+	if (!isPositiveAndBelow(voiceIndex, maxNumVoices) || laneIndexes[voiceIndex] == -1)
+		return false;
+
+	const int lane = laneIndexes[voiceIndex];
+	laneIndexes[voiceIndex] = -1;
+
+	// The voice state was already advanced, so the voice must be rendered with the same range
+	jassert(startSample_ == startSample && numSamples_ == numSamples);
+	ignoreUnused(startSample_);
+
+	const float* src = output + lane;
+	const int numToCopy = jmin(numSamples_, numSamples);
+
+	for (int i = 0; i < numToCopy; i++)
+		destination[i] = src[i * numVoices];
+
+	return true;
+}
+
 #pragma warning( pop )
 
 Processor *VoiceStartModulatorFactoryType::createProcessor(int typeIndex, const String &id)
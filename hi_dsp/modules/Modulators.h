@@ -35,6 +35,11 @@
 
 namespace hise { using namespace juce;
 
+/** Set this to 0 to disable the batched calculation of envelope voices (see EnvelopeModulator::VoiceBatch). */
+#ifndef HISE_ENABLE_BATCHED_ENVELOPES
+#define HISE_ENABLE_BATCHED_ENVELOPES 1
+#endif
+
 #pragma warning( push )
 #pragma warning( disable: 4589 )
 
@@ -912,6 +917,17 @@ public:
 		polyManager.clearCurrentVoice();
 	}
 
+	/** Override this method if the envelope can calculate the values of multiple voices in one pass.
+	*
+	*	This will be called before the voices are rendered with the indexes of all active voices and the 
+	*	sample range at control rate. Use the voiceBatch member to store the voice values and pick them up
+	*	in calculateBlock() with VoiceBatch::copyValues().
+	*/
+	virtual void calculateVoicesBatched(const int* voiceIndexes, int numVoices, int startSample, int numSamples)
+	{
+		ignoreUnused(voiceIndexes, numVoices, startSample, numSamples);
+	}
+
 protected:
 
 	int getNumPressedKeys() const { return numPressedKeys; }
@@ -949,6 +965,130 @@ protected:
 		JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ModulatorState)
 	};
 
+	/** Calculates the values of multiple voices in one pass.
+	*
+	*	Most envelope stages are a simple recursion (value = base + value * coef) with different parameters
+	*	for each voice. This class stores the voice parameters as structure of arrays, so the inner loop iterates 
+	*	over the voices and can be vectorized by the compiler.
+	*
+	*	Every voice has a lower and an upper limit. If the new value reaches one of these limits, the sample will be
+	*	recalculated with the scalar state machine of the envelope, which can then change the stage and update the
+	*	parameters with setRecursion(). The limits can be conservative (the state machine will just be called more 
+	*	often), so the result is the same as the voice-by-voice calculation.
+	*/
+	class VoiceBatch
+	{
+	public:
+
+		/** Allocates the memory. Call this in the prepareToPlay method of your envelope. */
+		void prepare(int maxNumVoices_, int samplesPerBlock);
+
+		/** Starts a new batch for the given sample range (at control rate). 
+		*
+		*	Returns false if the batch wasn't prepared for this amount of samples. */
+		bool begin(int startSample_, int numSamples_) noexcept;
+
+		/** Adds the voice with the given start value and returns the lane index. */
+		int addVoice(int voiceIndex, float value) noexcept;
+
+		/** Sets the parameters of the recursion for the given lane. */
+		void setRecursion(int lane, float base, float coef, float lowerLimit, float upperLimit) noexcept
+		{
+			bases[lane] = base;
+			coefs[lane] = coef;
+			lowerLimits[lane] = lowerLimit;
+			upperLimits[lane] = upperLimit;
+		}
+
+		/** Keeps the current value of the lane. */
+		void setConstant(int lane) noexcept
+		{
+			setRecursion(lane, 0.0f, 1.0f, std::numeric_limits<float>::lowest(), std::numeric_limits<float>::max());
+		}
+
+		/** Calculates every sample of this lane with the state machine. Use this for stages that are not a simple recursion. */
+		void setScalar(int lane) noexcept
+		{
+			setRecursion(lane, 0.0f, 1.0f, std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest());
+		}
+
+		/** Calculates all samples of all lanes. 
+		*
+		*	The function must have the signature float(int lane, float previousValue) and will be called whenever
+		*	a value reaches one of the limits. It must return the value of the sample and update the recursion 
+		*	parameters of the lane.
+		*/
+		template <typename ScalarFunction> void process(ScalarFunction&& calculateScalarValue)
+		{
+			for (int i = 0; i < numSamples; i++)
+			{
+				float* out = output + i * numVoices;
+				int numLimitsReached = 0;
+
+				for (int l = 0; l < numVoices; l++)
+				{
+					const float previousValue = values[l];
+					const float v = bases[l] + previousValue * coefs[l];
+
+					previousValues[l] = previousValue;
+					values[l] = v;
+					out[l] = v;
+
+					numLimitsReached += (int)(v <= lowerLimits[l]) | (int)(v >= upperLimits[l]);
+				}
+
+				if (numLimitsReached == 0)
+					continue;
+
+				for (int l = 0; l < numVoices; l++)
+				{
+					if (values[l] <= lowerLimits[l] || values[l] >= upperLimits[l])
+					{
+						const float v = calculateScalarValue(l, previousValues[l]);
+
+						values[l] = v;
+						out[l] = v;
+					}
+				}
+			}
+		}
+
+		/** Copies the values of the voice into the destination and returns true if the voice was calculated in the current batch. 
+		*
+		*	The values can only be copied once, so the next call to calculateBlock() will calculate the voice again. */
+		bool copyValues(int voiceIndex, float* destination, int startSample_, int numSamples_) noexcept;
+
+		int getNumVoices() const noexcept { return numVoices; }
+
+		int getVoiceIndex(int lane) const noexcept { return voiceIndexes[lane]; }
+
+		float getValue(int lane) const noexcept { return values[lane]; }
+
+	private:
+
+		int maxNumVoices = 0;
+		int maxNumSamples = 0;
+
+		int numVoices = 0;
+		int startSample = 0;
+		int numSamples = 0;
+
+		HeapBlock<float> data;
+
+		float* values = nullptr;
+		float* previousValues = nullptr;
+		float* bases = nullptr;
+		float* coefs = nullptr;
+		float* lowerLimits = nullptr;
+		float* upperLimits = nullptr;
+
+		/** The calculated values interleaved by lane ([sample][lane]). */
+		float* output = nullptr;
+
+		HeapBlock<int> voiceIndexes;
+		HeapBlock<int> laneIndexes;
+	};
+
 	/** Overwrite this method and return a newly created ModulatorState of the desired subclass. It will be owned by the Modulator.	*/
 	virtual ModulatorState * createSubclassedState (int /*voiceIndex*/) const = 0;
 	
@@ -957,6 +1097,8 @@ protected:
 
 	ScopedPointer<ModulatorState> monophonicState;
 
+	VoiceBatch voiceBatch;
+
 	bool isMonophonic = false;
 	bool shouldRetrigger = true;
 
@@ -32,9 +32,16 @@
 
 #include "hi_lac.h"
 
+#if HLAC_USE_PREFETCH_HINTS && (JUCE_LINUX || JUCE_MAC || JUCE_IOS)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 #include "hlac/BitCompressors.cpp"
+#include "hlac/BitCompressorsSIMD.cpp"
 #include "hlac/CompressionHelpers.cpp"
 #include "hlac/SampleBuffer.cpp"
+#include "hlac/DecodedBlockCache.cpp"
 #include "hlac/HlacEncoder.cpp"
 #include "hlac/HlacDecoder.cpp"
 #include "hlac/HlacAudioFormatWriter.cpp"
@@ -113,10 +113,51 @@ If enabled, then the unit test suite will be compiled and added to all unit test
 #define HLAC_INCLUDE_TEST_SUITE 0
 #endif
 
+//=============================================================================
+/** Config: HLAC_USE_PREFETCH_HINTS
+
+If enabled, the memory mapped readers tell the OS which parts of the file will be read next,
+so that the data for multiple pending read operations can be fetched from disk concurrently.
+*/
+#ifndef HLAC_USE_PREFETCH_HINTS
+#define HLAC_USE_PREFETCH_HINTS 1
+#endif
+
+//=============================================================================
+/** Config: HLAC_USE_SIMD_DECODING
+
+If enabled, the decoder uses vectorized kernels (SSSE3 / AVX2) to unpack the compressed data.
+The instruction set is detected at runtime, so the binary still runs on older CPUs.
+*/
+#ifndef HLAC_USE_SIMD_DECODING
+#define HLAC_USE_SIMD_DECODING 1
+#endif
+
+//=============================================================================
+/** Config: HLAC_USE_DECODED_BLOCK_CACHE
+
+If enabled, the decoded blocks of compressed monoliths are stored in a cache that is shared between all readers,
+so that multiple voices playing the same sample don't decode the same data over and over again.
+*/
+#ifndef HLAC_USE_DECODED_BLOCK_CACHE
+#define HLAC_USE_DECODED_BLOCK_CACHE 1
+#endif
+
+//=============================================================================
+/** Config: HLAC_DECODED_BLOCK_CACHE_SIZE
+
+The initial size of the decoded block cache in megabytes. You can change it at runtime with
+DecodedBlockCache::getInstance().setMaximumSize().
+*/
+#ifndef HLAC_DECODED_BLOCK_CACHE_SIZE
+#define HLAC_DECODED_BLOCK_CACHE_SIZE 32
+#endif
+
 
 #include "hlac/BitCompressors.h"
 #include "hlac/CompressionHelpers.h"
 #include "hlac/SampleBuffer.h"
+#include "hlac/DecodedBlockCache.h"
 #include "hlac/HlacEncoder.h"
 #include "hlac/HlacDecoder.h"
 #include "hlac/HlacAudioFormatWriter.h"
@@ -122,6 +122,16 @@ void packArrayOfInt16(int16* d, int numValues, uint8 bitDepth)
 }
 
 
+/** Decodes as many values as possible with the SIMD kernels and advances the pointers to the remaining values. */
+static void unpackWithSIMD(int16*& destination, const uint8*& data, int& numValuesToDecompress, int bitDepth)
+{
+	const int numUnpacked = BitCompressors::SIMD::unpack(destination, data, numValuesToDecompress, bitDepth);
+
+	destination += numUnpacked;
+	data += numUnpacked * bitDepth / 8;
+	numValuesToDecompress -= numUnpacked;
+}
+
 void unpackArrayOfInt16(int16* d, int /*numValues*/, uint8 bitDepth)
 {
 	jassert(reinterpret_cast<uint64>(d) % 16 == 0);
@@ -226,6 +236,8 @@ bool BitCompressors::OneBit::decompress(int16* destination, const uint8* data, i
 	const uint8 masks[8] = { 0b00000001, 0b00000010, 0b00000100, 0b00001000,
 		0b00010000, 0b00100000, 0b01000000, 0b10000000 };
 
+	unpackWithSIMD(destination, data, numValuesToDecompress, 1);
+
 	while (numValuesToDecompress >= 8)
 	{
 		const uint8 byte = *data;
@@ -321,6 +333,8 @@ bool BitCompressors::TwoBit::decompress(int16* destination, const uint8* data, i
 	const uint8 signMasks[4] =  { 0b00000010, 0b00001000, 0b00100000, 0b10000000 };
 	const uint8 valueMasks[4] = { 0b00000001, 0b00000100, 0b00010000, 0b01000000 };
 
+	unpackWithSIMD(destination, data, numValuesToDecompress, 2);
+
 	while (numValuesToDecompress >= 4)
 	{
 		const uint8 byte = *data;
@@ -431,7 +445,7 @@ bool BitCompressors::FourBit::compress(uint8* destination, const int16* data, in
 
 bool BitCompressors::FourBit::decompress(int16* destination, const uint8* data, int numValuesToDecompress)
 {
-	
+	unpackWithSIMD(destination, data, numValuesToDecompress, 4);
 
 	const uint8 signMasks[2] =  { 0b00001000, 0b10000000 };
 	const uint8 valueMasks[2] = { 0b00000111, 0b01110000 };
@@ -543,6 +557,8 @@ bool BitCompressors::SixBit::compress(uint8* destination, const int16* data, int
 
 bool BitCompressors::SixBit::decompress(int16* destination, const uint8* data, int numValuesToDecompress)
 {
+	unpackWithSIMD(destination, data, numValuesToDecompress, 6);
+
 #if JUCE_IOS
 	while (numValuesToDecompress >= 8)
 	{
@@ -703,6 +719,8 @@ bool BitCompressors::EightBit::compress(uint8* destination, const int16* data, i
 
 bool BitCompressors::EightBit::decompress(int16* destination, const uint8* data, int numValuesToDecompress)
 {
+	unpackWithSIMD(destination, data, numValuesToDecompress, 8);
+
     while (--numValuesToDecompress >= 0)
 	{
 		const int8 value = *reinterpret_cast<const int8*>(data++);
@@ -790,6 +808,8 @@ bool BitCompressors::TenBit::compress(uint8* destination, const int16* data, int
 
 bool BitCompressors::TenBit::decompress(int16* destination, const uint8* data, int numValuesToDecompress)
 {
+	unpackWithSIMD(destination, data, numValuesToDecompress, 10);
+
 	while (numValuesToDecompress >= 8)
 	{
 		decompress10Bit(reinterpret_cast<uint16*>(destination), (void*)data);
@@ -884,6 +904,8 @@ bool BitCompressors::TwelveBit::decompress(int16* destination, const uint8* data
 
 #else
 
+	unpackWithSIMD(destination, data, numValuesToDecompress, 12);
+
 	int16* dst = destination;
 
 	while (numValuesToDecompress >= 4)
@@ -1002,6 +1024,8 @@ bool BitCompressors::FourteenBit::compress(uint8* destination, const int16* data
 
 bool BitCompressors::FourteenBit::decompress(int16* destination, const uint8* data, int numValuesToDecompress)
 {
+	unpackWithSIMD(destination, data, numValuesToDecompress, 14);
+
 	while (numValuesToDecompress >= 8)
 	{
 		decompress14Bit(destination, data);
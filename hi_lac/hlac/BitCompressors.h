@@ -205,6 +205,48 @@ struct BitCompressors
 		int getByteAmount(int numValuesToCompress) override;
 	};
 
+	/** Vectorized kernels for the decoder.
+	*
+	*	The decompress() methods of the compressors call these kernels for the bulk of the data and process 
+	*	the remaining values with the scalar code. The instruction set is detected at runtime and the kernels 
+	*	are compiled with function specific target attributes, so they don't require any compiler flags.
+	*/
+	struct SIMD
+	{
+		enum class InstructionSet
+		{
+			Scalar = 0,
+			SSSE3,
+			AVX2,
+			numInstructionSets
+		};
+
+		/** Returns the best instruction set that is supported by this CPU. */
+		static InstructionSet getAvailableInstructionSet();
+
+		/** Returns the instruction set that is currently used by the kernels. */
+		static InstructionSet getInstructionSet();
+
+		/** Changes the instruction set (this is used for benchmarking). It will be limited to the available instruction set. */
+		static void setInstructionSet(InstructionSet newInstructionSet);
+
+		static String getInstructionSetName(InstructionSet s);
+
+		/** Unpacks as many values as possible and returns the number of unpacked values. 
+		*
+		*	The returned number is always a multiple of 8, so the data pointer can be advanced by numUnpacked * bitDepth / 8.
+		*/
+		static int unpack(int16* destination, const uint8* data, int numValues, int bitDepth);
+
+		/** Interpolates the full values of a differential block (see CompressionHelpers::Diff::distributeFullSamples). 
+		*
+		*	Returns the number of processed value pairs. The results are identical to the scalar version. */
+		static int distributeFullSamples(int16* destination, const int16* fullValues, int numPairs);
+
+		/** Subtracts the error signal of a differential block and returns the number of processed error values (always a multiple of 12). */
+		static int addErrorSignal(int16* destination, const int16* errorValues, int numValues);
+	};
+
 	struct UnitTests;
 };
 
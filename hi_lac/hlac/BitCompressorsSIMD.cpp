@@ -0,0 +1,484 @@
+/*  ===========================================================================
+ *
+ *   This file is part of HISE.
+ *   Copyright 2016 Christoph Hart
+ *
+ *   HISE is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   HISE is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *   Commercial licenses for using HISE in an closed source project are
+ *   available on request. Please visit the project's website to get more
+ *   information about commercial licensing:
+ *
+ *   http://www.hise.audio/
+ *
+ *   HISE is based on the JUCE library,
+ *   which must be separately licensed for closed source applications:
+ *
+ *   http://www.juce.com
+ *
+ *   ===========================================================================
+ */
+
+
+#if HLAC_USE_SIMD_DECODING && JUCE_INTEL && !JUCE_IOS
+#define HLAC_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define HLAC_SIMD_X86 0
+#endif
+
+#if HLAC_SIMD_X86 && (JUCE_GCC || JUCE_CLANG)
+#define HLAC_TARGET(x) __attribute__((target(x)))
+#else
+#define HLAC_TARGET(x)
+#endif
+
+namespace hlac { using namespace juce; 
+
+#if HLAC_SIMD_X86
+
+namespace SIMDKernels
+{
+
+/** The shuffle masks and multipliers for the bit depths that are packed into 16 bit words (6, 10, 12, 14).
+*
+*	8 values are stored in bitDepth bytes and value i starts at bit i * bitDepth of the word stream 
+*	(big endian within each little endian word). Every lane picks the word that contains the first 
+*	bit of the value and the next word, shifts the value to the top with a multiplication by 2^offset and 
+*	then shifts it down to the bottom.
+*/
+struct PackedTable
+{
+	PackedTable(int bitDepth_) :
+		bitDepth(bitDepth_),
+		bias((int16)((1 << (bitDepth_ - 1)) - 1))
+	{
+		for (int i = 0; i < 8; i++)
+		{
+			const int bitPosition = i * bitDepth;
+			const int word = bitPosition / 16;
+			const int offset = bitPosition % 16;
+
+			const int hiByte = 2 * word;
+			const int loByte = 2 * word + 2;
+
+			hiShuffle[2 * i] = (uint8)hiByte;
+			hiShuffle[2 * i + 1] = (uint8)(hiByte + 1);
+			loShuffle[2 * i] = loByte < 16 ? (uint8)loByte : 0x80;
+			loShuffle[2 * i + 1] = loByte + 1 < 16 ? (uint8)(loByte + 1) : 0x80;
+
+			multipliers[i] = (uint16)(1 << offset);
+		}
+	}
+
+	static const PackedTable& get(int bitDepth)
+	{
+		static const PackedTable t6(6), t10(10), t12(12), t14(14);
+
+		switch (bitDepth)
+		{
+		case 6:  return t6;
+		case 10: return t10;
+		case 12: return t12;
+		default: jassert(bitDepth == 14); return t14;
+		}
+	}
+
+	const int bitDepth;
+	const int16 bias;
+
+	uint8 hiShuffle[16];
+	uint8 loShuffle[16];
+	uint16 multipliers[8];
+};
+
+HLAC_TARGET("ssse3") static int unpackPackedSSSE3(int16* destination, const uint8* data, int numValues, int bitDepth)
+{
+	const auto& t = PackedTable::get(bitDepth);
+
+	const __m128i hiShuffle = _mm_loadu_si128((const __m128i*)t.hiShuffle);
+	const __m128i loShuffle = _mm_loadu_si128((const __m128i*)t.loShuffle);
+	const __m128i multipliers = _mm_loadu_si128((const __m128i*)t.multipliers);
+	const __m128i shift = _mm_cvtsi32_si128(16 - bitDepth);
+	const __m128i bias = _mm_set1_epi16(t.bias);
+
+	// Every iteration reads 16 bytes but consumes only bitDepth bytes
+	int numBytesLeft = numValues * bitDepth / 8;
+	int numDone = 0;
+
+	while (numValues - numDone >= 8 && numBytesLeft >= 16)
+	{
+		const __m128i x = _mm_loadu_si128((const __m128i*)data);
+
+		const __m128i hi = _mm_mullo_epi16(_mm_shuffle_epi8(x, hiShuffle), multipliers);
+		const __m128i lo = _mm_mulhi_epu16(_mm_shuffle_epi8(x, loShuffle), multipliers);
+
+		__m128i v = _mm_srl_epi16(_mm_or_si128(hi, lo), shift);
+		v = _mm_sub_epi16(v, bias);
+
+		_mm_storeu_si128((__m128i*)(destination + numDone), v);
+
+		data += bitDepth;
+		numBytesLeft -= bitDepth;
+		numDone += 8;
+	}
+
+	return numDone;
+}
+
+HLAC_TARGET("avx2") static int unpackPackedAVX2(int16* destination, const uint8* data, int numValues, int bitDepth)
+{
+	const auto& t = PackedTable::get(bitDepth);
+
+	const __m256i hiShuffle = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)t.hiShuffle));
+	const __m256i loShuffle = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)t.loShuffle));
+	const __m256i multipliers = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)t.multipliers));
+	const __m128i shift = _mm_cvtsi32_si128(16 - bitDepth);
+	const __m256i bias = _mm256_set1_epi16(t.bias);
+
+	// Two blocks of 8 values are processed in the two 128 bit lanes
+	int numBytesLeft = numValues * bitDepth / 8;
+	int numDone = 0;
+
+	while (numValues - numDone >= 16 && numBytesLeft >= bitDepth + 16)
+	{
+		const __m128i x1 = _mm_loadu_si128((const __m128i*)data);
+		const __m128i x2 = _mm_loadu_si128((const __m128i*)(data + bitDepth));
+		const __m256i x = _mm256_inserti128_si256(_mm256_castsi128_si256(x1), x2, 1);
+
+		const __m256i hi = _mm256_mullo_epi16(_mm256_shuffle_epi8(x, hiShuffle), multipliers);
+		const __m256i lo = _mm256_mulhi_epu16(_mm256_shuffle_epi8(x, loShuffle), multipliers);
+
+		__m256i v = _mm256_srl_epi16(_mm256_or_si256(hi, lo), shift);
+		v = _mm256_sub_epi16(v, bias);
+
+		_mm256_storeu_si256((__m256i*)(destination + numDone), v);
+
+		data += 2 * bitDepth;
+		numBytesLeft -= 2 * bitDepth;
+		numDone += 16;
+	}
+
+	return numDone + unpackPackedSSSE3(destination + numDone, data, numValues - numDone, bitDepth);
+}
+
+/** Sign extends the 8 bit values. */
+static int unpackEightBitSSE2(int16* destination, const uint8* data, int numValues)
+{
+	int numDone = 0;
+
+	for (; numDone + 16 <= numValues; numDone += 16)
+	{
+		const __m128i x = _mm_loadu_si128((const __m128i*)(data + numDone));
+
+		const __m128i lo = _mm_srai_epi16(_mm_unpacklo_epi8(x, x), 8);
+		const __m128i hi = _mm_srai_epi16(_mm_unpackhi_epi8(x, x), 8);
+
+		_mm_storeu_si128((__m128i*)(destination + numDone), lo);
+		_mm_storeu_si128((__m128i*)(destination + numDone + 8), hi);
+	}
+
+	return numDone;
+}
+
+HLAC_TARGET("avx2") static int unpackEightBitAVX2(int16* destination, const uint8* data, int numValues)
+{
+	int numDone = 0;
+
+	for (; numDone + 16 <= numValues; numDone += 16)
+	{
+		const __m128i x = _mm_loadu_si128((const __m128i*)(data + numDone));
+		_mm256_storeu_si256((__m256i*)(destination + numDone), _mm256_cvtepi8_epi16(x));
+	}
+
+	return numDone;
+}
+
+/** Applies the sign bits of the sign-magnitude formats (1, 2, 4 bit). */
+static forcedinline __m128i applySign(__m128i value, __m128i signMask)
+{
+	return _mm_sub_epi16(_mm_xor_si128(value, signMask), signMask);
+}
+
+/** Unpacks 16 values from 8 bytes (every nibble contains a value with 3 bits and a sign bit). */
+static int unpackFourBitSSE2(int16* destination, const uint8* data, int numValues)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i valueMask = _mm_set1_epi16(0x07);
+	const __m128i lowSignBit = _mm_set1_epi16(0x08);
+	const __m128i highSignBit = _mm_set1_epi16(0x80);
+
+	int numDone = 0;
+
+	for (; numDone + 16 <= numValues; numDone += 16)
+	{
+		const __m128i x = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)data), zero);
+
+		const __m128i lowSign = _mm_cmpeq_epi16(_mm_and_si128(x, lowSignBit), lowSignBit);
+		const __m128i highSign = _mm_cmpeq_epi16(_mm_and_si128(x, highSignBit), highSignBit);
+
+		const __m128i low = applySign(_mm_and_si128(x, valueMask), lowSign);
+		const __m128i high = applySign(_mm_and_si128(_mm_srli_epi16(x, 4), valueMask), highSign);
+
+		_mm_storeu_si128((__m128i*)(destination + numDone), _mm_unpacklo_epi16(low, high));
+		_mm_storeu_si128((__m128i*)(destination + numDone + 8), _mm_unpackhi_epi16(low, high));
+
+		data += 8;
+	}
+
+	return numDone;
+}
+
+/** Unpacks 16 values from 4 bytes (every two bits contain a value bit and a sign bit). */
+HLAC_TARGET("ssse3") static int unpackTwoBitSSSE3(int16* destination, const uint8* data, int numValues)
+{
+	const uint8 z = 0x80;
+
+	const __m128i shuffle1 = _mm_setr_epi8(0, z, 0, z, 0, z, 0, z, 1, z, 1, z, 1, z, 1, z);
+	const __m128i shuffle2 = _mm_setr_epi8(2, z, 2, z, 2, z, 2, z, 3, z, 3, z, 3, z, 3, z);
+	const __m128i valueBits = _mm_setr_epi16(0x01, 0x04, 0x10, 0x40, 0x01, 0x04, 0x10, 0x40);
+	const __m128i signBits = _mm_setr_epi16(0x02, 0x08, 0x20, 0x80, 0x02, 0x08, 0x20, 0x80);
+
+	int numDone = 0;
+
+	for (; numDone + 16 <= numValues; numDone += 16)
+	{
+		const __m128i x = _mm_cvtsi32_si128((int)ByteOrder::littleEndianInt(data));
+
+		const __m128i a = _mm_shuffle_epi8(x, shuffle1);
+		const __m128i b = _mm_shuffle_epi8(x, shuffle2);
+
+		const __m128i va = _mm_srli_epi16(_mm_cmpeq_epi16(_mm_and_si128(a, valueBits), valueBits), 15);
+		const __m128i vb = _mm_srli_epi16(_mm_cmpeq_epi16(_mm_and_si128(b, valueBits), valueBits), 15);
+
+		const __m128i sa = _mm_cmpeq_epi16(_mm_and_si128(a, signBits), signBits);
+		const __m128i sb = _mm_cmpeq_epi16(_mm_and_si128(b, signBits), signBits);
+
+		_mm_storeu_si128((__m128i*)(destination + numDone), applySign(va, sa));
+		_mm_storeu_si128((__m128i*)(destination + numDone + 8), applySign(vb, sb));
+
+		data += 4;
+	}
+
+	return numDone;
+}
+
+/** Unpacks 16 values from 2 bytes. */
+HLAC_TARGET("ssse3") static int unpackOneBitSSSE3(int16* destination, const uint8* data, int numValues)
+{
+	const uint8 z = 0x80;
+
+	const __m128i shuffle1 = _mm_setr_epi8(0, z, 0, z, 0, z, 0, z, 0, z, 0, z, 0, z, 0, z);
+	const __m128i shuffle2 = _mm_setr_epi8(1, z, 1, z, 1, z, 1, z, 1, z, 1, z, 1, z, 1, z);
+	const __m128i bits = _mm_setr_epi16(0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80);
+
+	int numDone = 0;
+
+	for (; numDone + 16 <= numValues; numDone += 16)
+	{
+		const __m128i x = _mm_cvtsi32_si128((int)ByteOrder::littleEndianShort(data));
+
+		const __m128i a = _mm_and_si128(_mm_shuffle_epi8(x, shuffle1), bits);
+		const __m128i b = _mm_and_si128(_mm_shuffle_epi8(x, shuffle2), bits);
+
+		_mm_storeu_si128((__m128i*)(destination + numDone), _mm_srli_epi16(_mm_cmpeq_epi16(a, bits), 15));
+		_mm_storeu_si128((__m128i*)(destination + numDone + 8), _mm_srli_epi16(_mm_cmpeq_epi16(b, bits), 15));
+
+		data += 2;
+	}
+
+	return numDone;
+}
+
+/** Integer division by 4 and 2 with the same rounding (towards zero) as the scalar code. */
+static forcedinline __m128i divideBy4(__m128i x)
+{
+	return _mm_srai_epi32(_mm_add_epi32(x, _mm_and_si128(_mm_srai_epi32(x, 31), _mm_set1_epi32(3))), 2);
+}
+
+static forcedinline __m128i divideBy2(__m128i x)
+{
+	return _mm_srai_epi32(_mm_add_epi32(x, _mm_srli_epi32(x, 31)), 1);
+}
+
+static forcedinline __m128i signExtendLow(__m128i x)
+{
+	return _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+}
+
+static int distributeFullSamplesSSE2(int16* d, const int16* r, int numPairs)
+{
+	int i = 0;
+
+	for (; i + 4 <= numPairs; i += 4)
+	{
+		const __m128i a = signExtendLow(_mm_loadl_epi64((const __m128i*)(r + i)));
+		const __m128i b = signExtendLow(_mm_loadl_epi64((const __m128i*)(r + i + 1)));
+
+		const __m128i v2 = divideBy4(_mm_add_epi32(_mm_add_epi32(_mm_add_epi32(a, a), a), b));
+		const __m128i v3 = divideBy2(_mm_add_epi32(a, b));
+		const __m128i v4 = divideBy4(_mm_add_epi32(_mm_add_epi32(_mm_add_epi32(b, b), b), a));
+
+		// [a0..a3 v2_0..v2_3] and [v3_0..v3_3 v4_0..v4_3]
+		const __m128i p12 = _mm_packs_epi32(a, v2);
+		const __m128i p34 = _mm_packs_epi32(v3, v4);
+
+		const __m128i lo = _mm_unpacklo_epi16(p12, p34);
+		const __m128i hi = _mm_unpackhi_epi16(p12, p34);
+
+		_mm_storeu_si128((__m128i*)d, _mm_unpacklo_epi16(lo, hi));
+		_mm_storeu_si128((__m128i*)(d + 8), _mm_unpackhi_epi16(lo, hi));
+
+		d += 16;
+	}
+
+	return i;
+}
+
+HLAC_TARGET("ssse3") static int addErrorSignalSSSE3(int16* d, const int16* e, int numValues)
+{
+	const uint8 z = 0x80;
+
+	const __m128i mask = _mm_set_epi8(z, z, z, z, z, z, z, z, 5, 4, 3, 2, 1, 0, z, z);
+	const __m128i mask2 = _mm_set_epi8(5, 4, 3, 2, 1, 0, z, z, z, z, z, z, z, z, z, z);
+
+	int numDone = 0;
+
+	// The last load reads 13 values, and the scalar code needs at least 2 remaining values
+	while (numValues - numDone >= 14)
+	{
+		__m128i a1 = _mm_loadu_si128((const __m128i*)d);
+		__m128i a2 = _mm_loadu_si128((const __m128i*)(d + 8));
+
+		const __m128i b1 = _mm_loadl_epi64((const __m128i*)e);
+		const __m128i b2 = _mm_loadl_epi64((const __m128i*)(e + 3));
+		const __m128i b3 = _mm_loadl_epi64((const __m128i*)(e + 6));
+		const __m128i b4 = _mm_loadl_epi64((const __m128i*)(e + 9));
+
+		const __m128i ba = _mm_or_si128(_mm_shuffle_epi8(b1, mask), _mm_shuffle_epi8(b2, mask2));
+		const __m128i bb = _mm_or_si128(_mm_shuffle_epi8(b3, mask), _mm_shuffle_epi8(b4, mask2));
+
+		a1 = _mm_sub_epi16(a1, ba);
+		a2 = _mm_sub_epi16(a2, bb);
+
+		_mm_storeu_si128((__m128i*)d, a1);
+		_mm_storeu_si128((__m128i*)(d + 8), a2);
+
+		d += 16;
+		e += 12;
+		numDone += 12;
+	}
+
+	return numDone;
+}
+
+} // namespace SIMDKernels
+
+#endif
+
+static BitCompressors::SIMD::InstructionSet& getCurrentInstructionSet()
+{
+	static BitCompressors::SIMD::InstructionSet s = BitCompressors::SIMD::getAvailableInstructionSet();
+	return s;
+}
+
+BitCompressors::SIMD::InstructionSet BitCompressors::SIMD::getAvailableInstructionSet()
+{
+#if HLAC_SIMD_X86
+	if (SystemStats::hasAVX2())
+		return InstructionSet::AVX2;
+
+	if (SystemStats::hasSSSE3())
+		return InstructionSet::SSSE3;
+#endif
+
+	return InstructionSet::Scalar;
+}
+
+BitCompressors::SIMD::InstructionSet BitCompressors::SIMD::getInstructionSet()
+{
+	return getCurrentInstructionSet();
+}
+
+void BitCompressors::SIMD::setInstructionSet(InstructionSet newInstructionSet)
+{
+	getCurrentInstructionSet() = jmin(newInstructionSet, getAvailableInstructionSet());
+}
+
+String BitCompressors::SIMD::getInstructionSetName(InstructionSet s)
+{
+	switch (s)
+	{
+	case InstructionSet::Scalar:	return "Scalar";
+	case InstructionSet::SSSE3:		return "SSSE3";
+	case InstructionSet::AVX2:		return "AVX2";
+	default:						return {};
+	}
+}
+
+int BitCompressors::SIMD::unpack(int16* destination, const uint8* data, int numValues, int bitDepth)
+{
+#if HLAC_SIMD_X86
+	using namespace SIMDKernels;
+
+	const auto s = getInstructionSet();
+
+	if (s == InstructionSet::Scalar)
+		return 0;
+
+	const bool useAVX = s == InstructionSet::AVX2;
+
+	switch (bitDepth)
+	{
+	case 1:	 return unpackOneBitSSSE3(destination, data, numValues);
+	case 2:	 return unpackTwoBitSSSE3(destination, data, numValues);
+	case 4:	 return unpackFourBitSSE2(destination, data, numValues);
+	case 8:	 return useAVX ? unpackEightBitAVX2(destination, data, numValues) : 
+						     unpackEightBitSSE2(destination, data, numValues);
+	case 6:
+	case 10:
+	case 12:
+	case 14: return useAVX ? unpackPackedAVX2(destination, data, numValues, bitDepth) :
+						     unpackPackedSSSE3(destination, data, numValues, bitDepth);
+	default: return 0;
+	}
+#else
+	ignoreUnused(destination, data, numValues, bitDepth);
+	return 0;
+#endif
+}
+
+int BitCompressors::SIMD::distributeFullSamples(int16* destination, const int16* fullValues, int numPairs)
+{
+#if HLAC_SIMD_X86
+	if (getInstructionSet() != InstructionSet::Scalar)
+		return SIMDKernels::distributeFullSamplesSSE2(destination, fullValues, numPairs);
+#endif
+
+	ignoreUnused(destination, fullValues, numPairs);
+	return 0;
+}
+
+int BitCompressors::SIMD::addErrorSignal(int16* destination, const int16* errorValues, int numValues)
+{
+#if HLAC_SIMD_X86
+	if (getInstructionSet() != InstructionSet::Scalar)
+		return SIMDKernels::addErrorSignalSSSE3(destination, errorValues, numValues);
+#endif
+
+	ignoreUnused(destination, errorValues, numValues);
+	return 0;
+}
+
+} // namespace hlac
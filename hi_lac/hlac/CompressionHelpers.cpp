@@ -902,9 +902,14 @@ void CompressionHelpers::Diff::distributeFullSamples(AudioBufferInt16& dst, cons
 	int thisValue = 0;
 	int nextValue = 0;
 
+	int i = 0;
+
 #if !JUCE_WINDOWS
 
-	for (int i = 0; i < numSamples - 2; i++)
+	i = BitCompressors::SIMD::distributeFullSamples(d, r, numSamples - 2);
+	d += 4 * i;
+
+	for (; i < numSamples - 2; i++)
 	{
 		thisValue = (int)r[i];
 		nextValue = (int)r[i + 1];
@@ -919,9 +924,11 @@ void CompressionHelpers::Diff::distributeFullSamples(AudioBufferInt16& dst, cons
 
 #else
 
+	// The rounding of this path differs from the scalar code, but it must stay
+	// like this for the files that were encoded on Windows
 	if (SystemStats::hasSSE41())
 	{
-		for (int i = 0; i < numSamples - 9; i += 4)
+		for (; i < numSamples - 9; i += 4)
 		{
 			__m128i a = _mm_loadl_epi64((const __m128i*)(r + i));
 			__m128i b = _mm_loadl_epi64((const __m128i*)(r + i + 1));
@@ -975,7 +982,7 @@ void CompressionHelpers::Diff::distributeFullSamples(AudioBufferInt16& dst, cons
 		}
 	}
 
-	for (int i = numSamples - 9; i < numSamples - 2; i++)
+	for (; i < numSamples - 2; i++)
 	{
 		thisValue = (int)r[i];
 		nextValue = (int)r[i + 1];
@@ -1010,14 +1017,14 @@ void CompressionHelpers::Diff::addErrorSignal(AudioBufferInt16& dst, const uint1
 
 	int16* e = const_cast<int16*>(reinterpret_cast<const int16*>(errorSignalPacked));
 
-	int counter = 0;
+	const int numDone = BitCompressors::SIMD::addErrorSignal(d, e, numSamples);
 
-#if !JUCE_WINDOWS
+	d += numDone / 3 * 4;
+	e += numDone;
+	numSamples -= numDone;
 
 	while (numSamples > 2)
 	{
-		counter += 4;
-
 		d[1] -= e[0];
 		d[2] -= e[1];
 		d[3] -= e[2];
@@ -1030,52 +1037,6 @@ void CompressionHelpers::Diff::addErrorSignal(AudioBufferInt16& dst, const uint1
 
 	d[1] -= e[0];
 	d[2] -= e[1];
-
-#else
-
-	while (numSamples > 2)
-	{
-		// SSE 3.0 should be available everywhere by now...
-
-		counter += 16;
-
-		__m128i a1 = _mm_load_si128((__m128i*)d);
-		__m128i a2 = _mm_load_si128((__m128i*)(d+8));
-
-		__m128i b1 = _mm_loadl_epi64((__m128i*)e);
-		__m128i b2 = _mm_loadl_epi64((__m128i*)(e+3));
-		__m128i b3 = _mm_loadl_epi64((__m128i*)(e+6));
-		__m128i b4 = _mm_loadl_epi64((__m128i*)(e+9));
-
-		const uint8 z = 0x80;
-
-		const __m128i mask = _mm_set_epi8 (z, z, z, z, z, z, z, z, 5, 4, 3, 2, 1, 0, z, z);
-		const __m128i mask2 = _mm_set_epi8(5, 4, 3, 2, 1, 0, z, z, z, z, z, z, z, z, z, z);
-
-		__m128i ba = _mm_shuffle_epi8(b1, mask);
-		ba = _mm_or_si128(ba, _mm_shuffle_epi8(b2, mask2));
-
-		__m128i bb = _mm_shuffle_epi8(b3, mask);
-		bb = _mm_or_si128(bb, _mm_shuffle_epi8(b4, mask2));
-
-		a1 = _mm_sub_epi16(a1, ba);
-		a2 = _mm_sub_epi16(a2, bb);
-
-		_mm_store_si128((__m128i*)d, a1);
-		_mm_store_si128((__m128i*)(d+8), a2);
-
-		d += 16;
-		e += 12;
-
-		numSamples -= 12;
-
-	}
-
-	d[1] -= e[0];
-	d[2] -= e[1];
-
-
-#endif
 }
 
 uint64 CompressionHelpers::Misc::NumberOfSetBits(uint64 i)
@@ -1392,60 +1353,117 @@ bool HlacArchiver::extractSampleData(const DecompressData& data)
 
 #define WRITE_FLAG(x) writeFlag(fos, x)
 
-FileInputStream* HlacArchiver::writeTempFile(AudioFormatReader* reader, int bitDepth)
+/** Converts a HLAC monolith to a temporary FLAC file. 
+*
+*	The files are independent, so multiple jobs can run in parallel while the archive is written in the original order.
+*/
+class HlacArchiver::TempFileJob : public ThreadPoolJob
 {
-	FlacAudioFormat flacFormat;
+public:
 
-	StringPairArray metadata;
+	TempFileJob(Thread* thread_, const File& sourceFile_, const File& tempFile_, int bitDepth_) :
+		ThreadPoolJob("HLAC Archive Encoder"),
+		thread(thread_),
+		sourceFile(sourceFile_),
+		tempFile(tempFile_),
+		bitDepth(bitDepth_)
+	{
+		progress.store(0.0);
+	}
 
-	tmpFile.deleteFile();
-	FileOutputStream* tempOutput = new FileOutputStream(tmpFile);
+	~TempFileJob()
+	{
+		tempFile.deleteFile();
+	}
 
-	const int bufferSize = 8192 * 32;
+	JobStatus runJob() override
+	{
+		HiseLosslessAudioFormat haf;
+
+		FileInputStream* fis = new FileInputStream(sourceFile);
+
+		ScopedPointer<AudioFormatReader> reader = haf.createReaderFor(fis, true);
+
+		if (reader == nullptr)
+		{
+			errorMessage = "Can't read " + sourceFile.getFileName();
+			return jobHasFinished;
+		}
 
-	AudioSampleBuffer tempBuffer(reader->numChannels, bufferSize);
+		sampleRate = reader->sampleRate;
+		numChannels = (int)reader->numChannels;
+		lengthInSamples = reader->lengthInSamples;
 
-	ScopedPointer<AudioFormatWriter> writer = flacFormat.createWriterFor(tempOutput, reader->sampleRate, reader->numChannels, bitDepth, metadata, 9);
+		ok = writeTempFile(reader);
 
-	bool writeResult = true;
+		return jobHasFinished;
+	}
 
-	dynamic_cast<HiseLosslessAudioFormatReader*>(reader)->setTargetAudioDataType(AudioDataConverters::float32BE);
+	bool shouldAbort() const
+	{
+		return shouldExit() || thread->threadShouldExit();
+	}
 
-	for (int offsetInReader = 0; offsetInReader < reader->lengthInSamples; offsetInReader += bufferSize)
+	bool writeTempFile(AudioFormatReader* reader)
 	{
+		FlacAudioFormat flacFormat;
 
-		if (thread->threadShouldExit())
-		{
-			tempOutput->flush();
-			writer = nullptr;
-			tmpFile.deleteFile();
-			return nullptr;
-		}
-			
+		StringPairArray metadata;
 
-		double partProgress = (double)offsetInReader / (double)reader->lengthInSamples;
+		tempFile.deleteFile();
+		FileOutputStream* tempOutput = new FileOutputStream(tempFile);
 
-		if (progress != nullptr)
-			*progress = partProgress;
+		const int bufferSize = 8192 * 32;
 
-		const int numToRead = jmin<int>(bufferSize, (int)(reader->lengthInSamples - offsetInReader));
+		AudioSampleBuffer tempBuffer(reader->numChannels, bufferSize);
 
-		reader->read(&tempBuffer, 0, numToRead, offsetInReader, true, true);
+		ScopedPointer<AudioFormatWriter> writer = flacFormat.createWriterFor(tempOutput, reader->sampleRate, reader->numChannels, bitDepth, metadata, 9);
 
-		writeResult = writer->writeFromAudioSampleBuffer(tempBuffer, 0, numToRead);
+		dynamic_cast<HiseLosslessAudioFormatReader*>(reader)->setTargetAudioDataType(AudioDataConverters::float32BE);
 
-		if (!writeResult)
+		for (int offsetInReader = 0; offsetInReader < reader->lengthInSamples; offsetInReader += bufferSize)
 		{
-			listener->criticalErrorOccured("Error at writing from temp buffer at position " + String(offsetInReader) + ", chunk-length: " + String(numToRead));
-			return nullptr;
+			if (shouldAbort())
+			{
+				tempOutput->flush();
+				writer = nullptr;
+				tempFile.deleteFile();
+				return false;
+			}
+
+			progress.store((double)offsetInReader / (double)reader->lengthInSamples);
+
+			const int numToRead = jmin<int>(bufferSize, (int)(reader->lengthInSamples - offsetInReader));
+
+			reader->read(&tempBuffer, 0, numToRead, offsetInReader, true, true);
+
+			if (!writer->writeFromAudioSampleBuffer(tempBuffer, 0, numToRead))
+			{
+				errorMessage = "Error at writing from temp buffer at position " + String(offsetInReader) + ", chunk-length: " + String(numToRead);
+				return false;
+			}
 		}
+
+		tempOutput->flush();
+		writer = nullptr;
+
+		return true;
 	}
 
-	tempOutput->flush();
-	writer = nullptr;
+	Thread* thread;
+	const File sourceFile;
+	const File tempFile;
+	const int bitDepth;
 
-	return new FileInputStream(tmpFile);
-}
+	std::atomic<double> progress;
+
+	bool ok = false;
+	String errorMessage;
+
+	double sampleRate = 0.0;
+	int numChannels = 0;
+	int64 lengthInSamples = 0;
+};
 
 #define CHECK_FILE_WRITE_OP if (!ok) { listener->criticalErrorOccured("file write error at " + fos->getFile().getFileName()); return; }
 
@@ -1483,13 +1501,28 @@ void HlacArchiver::compressSampleData(const CompressData& data)
 		CHECK_FILE_WRITE_OP;
 		WRITE_FLAG(Flag::EndMetadata);
 
-		hlac::HiseLosslessAudioFormat haf;
+		deltaPerFile = (double)1 / (double)hlacFiles.size();
 
-		StringPairArray metadata;
+		// The jobs must be deleted after the pool
+		OwnedArray<TempFileJob> jobs;
 
-		tmpFile = targetFile.getSiblingFile("Temp.dat");
+		const int numThreads = data.numThreads > 0 ? data.numThreads : SystemStats::getNumCpus();
+		ThreadPool pool(numThreads);
 
-		deltaPerFile = (double)1 / (double)hlacFiles.size();
+		// Limit the amount of files that are converted in advance so that the temp files don't waste too much disk space
+		const int numFilesInAdvance = 2 * numThreads;
+
+		auto addJob = [&](int index)
+		{
+			if (isPositiveAndBelow(index, hlacFiles.size()))
+			{
+				auto tmpFile = targetFile.getSiblingFile("Temp" + String(index) + ".dat");
+				pool.addJob(jobs.add(new TempFileJob(thread, hlacFiles[index], tmpFile, bitDepth)), false);
+			}
+		};
+
+		for (int i = 0; i < numFilesInAdvance; i++)
+			addJob(i);
 
 		for (int i = 0; i < hlacFiles.size(); i++)
 		{
@@ -1500,18 +1533,35 @@ void HlacArchiver::compressSampleData(const CompressData& data)
 
 			auto sizeLeftInPart = data.partSize - fos->getPosition();
 
-			FileInputStream* fis = new FileInputStream(hlacFiles[i]);
-
-			ScopedPointer<AudioFormatReader> reader = haf.createReaderFor(fis, true);
-
 			const String name = hlacFiles[i].getFileName();
 
 			VERBOSE_LOG("  Writing monolith " + name);
 			STATUS_LOG("Compressing " + name);
 
-			VERBOSE_LOG("    Samplerate: " + String(reader->sampleRate, 1));
-			VERBOSE_LOG("    Channels: " + String(reader->numChannels));
-			VERBOSE_LOG("    Length: " + String(reader->lengthInSamples));
+			auto job = jobs[i];
+
+			while (!pool.waitForJobToFinish(job, 50))
+			{
+				if (thread->threadShouldExit())
+					return;
+
+				if (progress != nullptr)
+					*progress = job->progress.load();
+			}
+
+			addJob(i + numFilesInAdvance);
+
+			if (!job->ok)
+			{
+				if (job->errorMessage.isNotEmpty())
+					listener->criticalErrorOccured(job->errorMessage);
+
+				return;
+			}
+
+			VERBOSE_LOG("    Samplerate: " + String(job->sampleRate, 1));
+			VERBOSE_LOG("    Channels: " + String(job->numChannels));
+			VERBOSE_LOG("    Length: " + String(job->lengthInSamples));
 
 			WRITE_FLAG(Flag::BeginName);
 			ok = fos->writeString(name);
@@ -1523,12 +1573,7 @@ void HlacArchiver::compressSampleData(const CompressData& data)
 			CHECK_FILE_WRITE_OP;
 			WRITE_FLAG(Flag::EndTime);
 
-			
-
-			ScopedPointer<FileInputStream> tmpInput = writeTempFile(reader, bitDepth);
-
-			if (tmpInput == nullptr)
-				return;
+			ScopedPointer<FileInputStream> tmpInput = new FileInputStream(job->tempFile);
 
 			int64 bytesToWrite = jmin<int64>(tmpInput->getTotalLength(), sizeLeftInPart);
 
@@ -1580,14 +1625,14 @@ void HlacArchiver::compressSampleData(const CompressData& data)
 			fos->flush();
 
 			tmpInput = nullptr;
-			
+
+			// deletes the temp file
+			jobs.set(i, nullptr, true);
 		}
 
 		WRITE_FLAG(Flag::EndOfArchive);
 		fos->flush();
 		fos = nullptr;
-
-		tmpFile.deleteFile();
 	}
 #else
 
@@ -1781,6 +1826,23 @@ void CompressionHelpers::NormaliseMap::setNormalisationValues(int readOffset, in
 	getTableData()[index + 3] = ptr[3];
 }
 
+int CompressionHelpers::NormaliseMap::getNormalisationValues(int readOffset) const
+{
+	int normalisedValues = 0;
+
+	uint16 index = getIndexForSamplePosition(readOffset);
+
+	if ((index + 3) >= size())
+	{
+		jassertfalse;
+		return 0;
+	}
+
+	memcpy(&normalisedValues, getTableData() + index, sizeof(int));
+
+	return normalisedValues;
+}
+
 void CompressionHelpers::NormaliseMap::normalise(const float* src, int16* dst, int numSamples)
 {
 	if (normalisationMode == Mode::NoNormalisation)
@@ -84,6 +84,9 @@ struct CompressionHelpers
 		/** Sets 4 values at once. Used by the HLAC decoder. */
 		void setNormalisationValues(int readOffset, int normalisedValues);
 
+		/** Returns the 4 values that start at the given position. Used by the decoded block cache. */
+		int getNormalisationValues(int readOffset) const;
+
 		/** This applies normalisation. */
 		void normalise(const float* src, int16* dst, int numSamples);
 
@@ -388,6 +391,9 @@ struct HlacArchiver
 		int64 partSize = -1;
 		double* progress = nullptr;
 		double* totalProgress = nullptr;
+
+		/** The number of files that are converted in parallel. If this is -1, it uses every CPU core. */
+		int numThreads = -1;
 	};
 
 	struct DecompressData
@@ -433,7 +439,7 @@ struct HlacArchiver
 
 private:
 
-	FileInputStream* writeTempFile(AudioFormatReader* reader, int bitDepth=16);
+	class TempFileJob;
 
 	Listener* listener = nullptr;
 
@@ -454,8 +460,6 @@ private:
 	Thread* thread = nullptr;
 	
 	
-	File tmpFile;
-
 	double deltaPerFile = 0.1;
 	double fileProgress = 0.0;
 
@@ -0,0 +1,289 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+namespace hlac { using namespace juce;
+
+struct DecodedBlockCache::Slot
+{
+	/** Odd while the slot is being written. */
+	std::atomic<uint32> sequence;
+
+	/** 0 means the slot is empty. */
+	std::atomic<uint64> key;
+
+	std::atomic<uint32> lastAccess;
+
+	int normalisationValues;
+
+	int16 data[COMPRESSION_BLOCK_SIZE];
+};
+
+struct DecodedBlockCache::Storage
+{
+	static constexpr int NumSlotsPerSet = 8;
+
+	Storage(int numSets_) :
+		numSets(numSets_),
+		numUsedSlots(0)
+	{
+		// The slots only contain atomic integers and POD data, so zeroed memory is a valid empty state
+		slots.calloc(numSets * NumSlotsPerSet);
+	}
+
+	Slot* getSet(uint64 key) noexcept
+	{
+		// Fibonacci hashing spreads the consecutive block indexes over all sets
+		auto hash = (key * 0x9E3779B97F4A7C15ull) >> 32;
+		return slots + (int)(hash % (uint64)numSets) * NumSlotsPerSet;
+	}
+
+	int getNumSlots() const noexcept { return numSets * NumSlotsPerSet; }
+
+	const int numSets;
+	std::atomic<int> numUsedSlots;
+
+	HeapBlock<Slot> slots;
+};
+
+DecodedBlockCache::ScopedStorageAccess::ScopedStorageAccess(const DecodedBlockCache& parent_) :
+	parent(parent_)
+{
+	// Increment before loading the pointer so that swapStorage() can't delete it under our feet
+	++parent.numPendingAccesses;
+	storage = parent.currentStorage.load();
+}
+
+DecodedBlockCache::ScopedStorageAccess::~ScopedStorageAccess()
+{
+	--parent.numPendingAccesses;
+}
+
+DecodedBlockCache::DecodedBlockCache() :
+	currentStorage(nullptr),
+	numPendingAccesses(0),
+	accessCounter(0),
+	numHits(0),
+	numMisses(0)
+{
+	setMaximumSize((int64)HLAC_DECODED_BLOCK_CACHE_SIZE * 1024 * 1024);
+}
+
+DecodedBlockCache::~DecodedBlockCache()
+{
+	swapStorage(nullptr);
+}
+
+DecodedBlockCache& DecodedBlockCache::getInstance()
+{
+	static DecodedBlockCache instance;
+	return instance;
+}
+
+uint32 DecodedBlockCache::createReaderId()
+{
+	static std::atomic<uint32> nextId(1);
+	return nextId++;
+}
+
+uint64 DecodedBlockCache::createKey(uint32 readerId, int channelIndex, uint32 blockIndex) noexcept
+{
+	jassert(readerId != 0);
+
+	return ((uint64)readerId << 32) | ((uint64)blockIndex << 1) | (uint64)(channelIndex & 1);
+}
+
+bool DecodedBlockCache::read(uint64 key, int16* destination, int startSampleInBlock, int numSamples, int& normalisationValues)
+{
+	jassert(startSampleInBlock + numSamples <= COMPRESSION_BLOCK_SIZE);
+
+	ScopedStorageAccess sa(*this);
+
+	if (sa.storage == nullptr)
+		return false;
+
+	auto set = sa.storage->getSet(key);
+
+	for (int i = 0; i < Storage::NumSlotsPerSet; i++)
+	{
+		auto& s = set[i];
+
+		const auto sequenceBefore = s.sequence.load(std::memory_order_acquire);
+
+		if ((sequenceBefore & 1) != 0 || s.key.load(std::memory_order_relaxed) != key)
+			continue;
+
+		memcpy(destination, s.data + startSampleInBlock, sizeof(int16) * numSamples);
+		const auto values = s.normalisationValues;
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		// The slot was overwritten while we were copying
+		if (s.sequence.load(std::memory_order_relaxed) != sequenceBefore)
+			break;
+
+		s.lastAccess.store(++accessCounter, std::memory_order_relaxed);
+		normalisationValues = values;
+
+		++numHits;
+		return true;
+	}
+
+	++numMisses;
+	return false;
+}
+
+void DecodedBlockCache::write(uint64 key, const int16* source, int normalisationValues)
+{
+	ScopedStorageAccess sa(*this);
+
+	if (sa.storage == nullptr)
+		return;
+
+	auto set = sa.storage->getSet(key);
+
+	Slot* slotToUse = nullptr;
+	uint32 maxAge = 0;
+	const uint32 now = accessCounter.load(std::memory_order_relaxed);
+
+	for (int i = 0; i < Storage::NumSlotsPerSet; i++)
+	{
+		auto& s = set[i];
+		const auto thisKey = s.key.load(std::memory_order_relaxed);
+
+		// Another thread was faster
+		if (thisKey == key)
+			return;
+
+		if (thisKey == 0)
+		{
+			slotToUse = &s;
+			break;
+		}
+
+		// Compare the age instead of the raw value so that a wrapped counter doesn't mess up the order
+		const uint32 age = now - s.lastAccess.load(std::memory_order_relaxed);
+
+		if (slotToUse == nullptr || age > maxAge)
+		{
+			slotToUse = &s;
+			maxAge = age;
+		}
+	}
+
+	auto sequence = slotToUse->sequence.load(std::memory_order_relaxed);
+
+	// If someone else is currently writing into this slot, we just skip the write
+	if ((sequence & 1) != 0 || !slotToUse->sequence.compare_exchange_strong(sequence, sequence + 1, std::memory_order_acq_rel))
+		return;
+
+	std::atomic_thread_fence(std::memory_order_release);
+
+	if (slotToUse->key.exchange(key, std::memory_order_relaxed) == 0)
+		++sa.storage->numUsedSlots;
+
+	memcpy(slotToUse->data, source, sizeof(int16) * COMPRESSION_BLOCK_SIZE);
+	slotToUse->normalisationValues = normalisationValues;
+	slotToUse->lastAccess.store(++accessCounter, std::memory_order_relaxed);
+
+	slotToUse->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+void DecodedBlockCache::setMaximumSize(int64 numBytes)
+{
+	ScopedLock sl(resizeLock);
+
+	const int numSets = (int)jmin<int64>(std::numeric_limits<int>::max() / Storage::NumSlotsPerSet, numBytes / ((int64)sizeof(Slot) * Storage::NumSlotsPerSet));
+
+	maximumSize = numSets > 0 ? numBytes : 0;
+
+	swapStorage(numSets > 0 ? new Storage(numSets) : nullptr);
+}
+
+void DecodedBlockCache::clear()
+{
+	setMaximumSize(maximumSize);
+}
+
+DecodedBlockCache::Statistics DecodedBlockCache::getStatistics() const
+{
+	Statistics stats;
+
+	stats.numHits = numHits.load();
+	stats.numMisses = numMisses.load();
+
+	ScopedStorageAccess sa(*this);
+
+	if (sa.storage != nullptr)
+	{
+		stats.numSlots = sa.storage->getNumSlots();
+		stats.numUsedSlots = sa.storage->numUsedSlots.load();
+		stats.numBytesAllocated = (int64)stats.numSlots * sizeof(Slot);
+		stats.numBytesUsed = (int64)stats.numUsedSlots * sizeof(Slot);
+	}
+
+	return stats;
+}
+
+void DecodedBlockCache::resetStatistics()
+{
+	numHits = 0;
+	numMisses = 0;
+}
+
+void DecodedBlockCache::swapStorage(Storage* newStorage)
+{
+	ScopedPointer<Storage> oldStorage = currentStorage.exchange(newStorage);
+
+	// Wait until every pending read / write operation that might still use the old storage is finished
+	while (numPendingAccesses.load() > 0)
+		Thread::yield();
+}
+
+double DecodedBlockCache::Statistics::getHitRate() const
+{
+	const auto numTotal = numHits + numMisses;
+
+	return numTotal > 0 ? (double)numHits / (double)numTotal : 0.0;
+}
+
+String DecodedBlockCache::Statistics::toString() const
+{
+	String s;
+
+	s << "HLAC block cache: ";
+	s << String(getHitRate() * 100.0, 1) << "% hit rate (" << String(numHits) << " hits, " << String(numMisses) << " misses), ";
+	s << String((double)numBytesUsed / 1024.0 / 1024.0, 1) << " / " << String((double)numBytesAllocated / 1024.0 / 1024.0, 1) << "MB used";
+
+	return s;
+}
+
+} // namespace hlac
@@ -0,0 +1,136 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+#ifndef DECODEDBLOCKCACHE_H_INCLUDED
+#define DECODEDBLOCKCACHE_H_INCLUDED
+
+namespace hlac { using namespace juce;
+
+/** A process wide cache for decoded HLAC blocks.
+*
+*	If multiple voices play the same compressed sample, every streaming thread decodes the same blocks
+*	over and over again. This cache stores the decoded 16 bit data of a block (per channel) together
+*	with its normalisation values, so that subsequent reads of the same block are a simple memcpy.
+*
+*	The slots are organised in small sets with a LRU replacement inside each set. Reading is lock free:
+*	every slot has a sequence counter and a read that overlaps with a write is treated as a cache miss.
+*/
+class DecodedBlockCache
+{
+public:
+
+	struct Statistics
+	{
+		/** Returns the hit rate from 0.0 to 1.0. */
+		double getHitRate() const;
+
+		/** Creates a human readable summary that can be displayed in the sampler settings. */
+		String toString() const;
+
+		int64 numHits = 0;
+		int64 numMisses = 0;
+		int numUsedSlots = 0;
+		int numSlots = 0;
+		int64 numBytesUsed = 0;
+		int64 numBytesAllocated = 0;
+	};
+
+	~DecodedBlockCache();
+
+	/** Returns the cache that is shared by all HLAC readers of this process. */
+	static DecodedBlockCache& getInstance();
+
+	/** Creates a unique ID for a reader. The ID is part of the key, so blocks of different monoliths don't collide. */
+	static uint32 createReaderId();
+
+	/** Creates the key for the given block. */
+	static uint64 createKey(uint32 readerId, int channelIndex, uint32 blockIndex) noexcept;
+
+	/** Copies the given part of the block into the destination. Returns false if the block is not in the cache. */
+	bool read(uint64 key, int16* destination, int startSampleInBlock, int numSamples, int& normalisationValues);
+
+	/** Stores the decoded block. The source must contain COMPRESSION_BLOCK_SIZE samples. */
+	void write(uint64 key, const int16* source, int normalisationValues);
+
+	/** Resizes the cache. This drops all cached blocks and waits until every pending read is finished.
+	*
+	*	Use 0 to disable the cache.
+	*/
+	void setMaximumSize(int64 numBytes);
+
+	int64 getMaximumSize() const noexcept { return maximumSize; }
+
+	bool isEnabled() const noexcept { return maximumSize > 0; }
+
+	/** Removes all blocks from the cache. */
+	void clear();
+
+	Statistics getStatistics() const;
+
+	void resetStatistics();
+
+private:
+
+	DecodedBlockCache();
+
+	struct Slot;
+	struct Storage;
+
+	/** Keeps the storage alive while a read or write operation is pending. */
+	struct ScopedStorageAccess
+	{
+		ScopedStorageAccess(const DecodedBlockCache& parent_);
+		~ScopedStorageAccess();
+
+		const DecodedBlockCache& parent;
+		Storage* storage;
+	};
+
+	void swapStorage(Storage* newStorage);
+
+	std::atomic<Storage*> currentStorage;
+	mutable std::atomic<int> numPendingAccesses;
+
+	std::atomic<uint32> accessCounter;
+
+	std::atomic<int64> numHits;
+	std::atomic<int64> numMisses;
+
+	int64 maximumSize = 0;
+	CriticalSection resizeLock;
+
+	JUCE_DECLARE_NON_COPYABLE(DecodedBlockCache);
+};
+
+} // namespace hlac
+
+#endif  // DECODEDBLOCKCACHE_H_INCLUDED
@@ -294,6 +294,108 @@ bool HlacReaderCommon::fixedBufferRead(HiseSampleBuffer& buffer, int numDestChan
 	return true;
 }
 
+#if HLAC_USE_DECODED_BLOCK_CACHE
+
+bool HlacReaderCommon::cachedFixedBufferRead(HiseSampleBuffer& buffer, int numDestChannels, int startOffsetInBuffer, int64 startSampleInFile, int numSamples)
+{
+	if (!DecodedBlockCache::getInstance().isEnabled() || buffer.isFloatingPoint() || numSamples <= 0)
+	{
+		ScopedLock sl(readLock);
+		return fixedBufferRead(buffer, numDestChannels, startOffsetInBuffer, startSampleInFile, numSamples);
+	}
+
+	if (startOffsetInBuffer == 0)
+		return readBlocksWithCache(buffer, numDestChannels, startSampleInFile, numSamples);
+
+	HiseSampleBuffer offset(buffer, startOffsetInBuffer);
+	auto ok = readBlocksWithCache(offset, numDestChannels, startSampleInFile, numSamples);
+	buffer.copyNormalisationRanges(offset, startOffsetInBuffer);
+
+	return ok;
+}
+
+bool HlacReaderCommon::readBlocksWithCache(HiseSampleBuffer& destination, int numDestChannels, int64 startSampleInFile, int numSamples)
+{
+	auto& cache = DecodedBlockCache::getInstance();
+
+	const bool useNormalisation = header.getVersion() > 2;
+	const int numChannelsToRead = numDestChannels == 2 ? 2 : 1;
+
+	// This mirrors the normalisation handling of HlacDecoder::decode()
+	if (useNormalisation)
+	{
+		destination.allocateNormalisationTables((int)startSampleInFile);
+		destination.clearNormalisation({ 0, numSamples });
+	}
+
+	const int64 endSampleInFile = startSampleInFile + numSamples;
+	const int64 firstBlockStart = startSampleInFile - startSampleInFile % COMPRESSION_BLOCK_SIZE;
+
+	for (int64 blockStart = firstBlockStart; blockStart < endSampleInFile; blockStart += COMPRESSION_BLOCK_SIZE)
+	{
+		const auto blockIndex = (uint32)(blockStart / COMPRESSION_BLOCK_SIZE);
+		const auto readStart = jmax(blockStart, startSampleInFile);
+		const auto offsetInBlock = (int)(readStart - blockStart);
+		const auto offsetInDestination = (int)(readStart - startSampleInFile);
+		const auto numThisTime = (int)(jmin(blockStart + COMPRESSION_BLOCK_SIZE, endSampleInFile) - readStart);
+
+		int normalisationValues[2] = { 0, 0 };
+		bool found = true;
+
+		for (int c = 0; c < numChannelsToRead && found; c++)
+		{
+			auto dst = static_cast<int16*>(destination.getWritePointer(c, offsetInDestination));
+			found = cache.read(DecodedBlockCache::createKey(blockCacheId, c, blockIndex), dst, offsetInBlock, numThisTime, normalisationValues[c]);
+		}
+
+		if (!found)
+		{
+			ScopedLock sl(readLock);
+
+			decodeBlockIntoCache(numDestChannels, blockStart, normalisationValues);
+
+			for (int c = 0; c < numChannelsToRead; c++)
+			{
+				auto src = static_cast<const int16*>(blockBuffer.getReadPointer(c, offsetInBlock));
+				memcpy(destination.getWritePointer(c, offsetInDestination), src, sizeof(int16) * numThisTime);
+			}
+		}
+
+		if (useNormalisation)
+		{
+			for (int c = 0; c < numChannelsToRead; c++)
+				destination.getNormaliseMap(c).setNormalisationValues((int)(blockStart - firstBlockStart), normalisationValues[c]);
+		}
+	}
+
+	if (useNormalisation)
+		destination.flushNormalisationInfo({ 0, numSamples });
+
+	return true;
+}
+
+void HlacReaderCommon::decodeBlockIntoCache(int numDestChannels, int64 blockStart, int* normalisationValues)
+{
+	const int numChannelsToRead = numDestChannels == 2 ? 2 : 1;
+
+	if (blockBuffer.isFloatingPoint() || blockBuffer.getNumChannels() != numChannelsToRead)
+		blockBuffer = HiseSampleBuffer(false, numChannelsToRead, COMPRESSION_BLOCK_SIZE);
+
+	fixedBufferRead(blockBuffer, numDestChannels, 0, blockStart, COMPRESSION_BLOCK_SIZE);
+
+	const auto blockIndex = (uint32)(blockStart / COMPRESSION_BLOCK_SIZE);
+
+	for (int c = 0; c < numChannelsToRead; c++)
+	{
+		normalisationValues[c] = header.getVersion() > 2 ? blockBuffer.getNormaliseMap(c).getNormalisationValues(0) : 0;
+
+		auto src = static_cast<const int16*>(blockBuffer.getReadPointer(c));
+		DecodedBlockCache::getInstance().write(DecodedBlockCache::createKey(blockCacheId, c, blockIndex), src, normalisationValues[c]);
+	}
+}
+
+#endif
+
 void HiseLosslessAudioFormatReader::copySampleData(int* const* destSamples, int startOffsetInDestBuffer, int numDestChannels, const void* sourceData, int numChannels, int numSamples) noexcept
 {
 	jassert(numDestChannels == numDestChannels);
@@ -448,6 +550,55 @@ bool HlacMemoryMappedAudioFormatReader::mapSectionOfFile(Range<int64> samplesToM
 	}
 }
 
+void HlacMemoryMappedAudioFormatReader::prefetch(int64 startSampleInFile, int64 numSamples)
+{
+#if HLAC_USE_PREFETCH_HINTS && (JUCE_LINUX || JUCE_MAC || JUCE_IOS)
+	if (map == nullptr || numSamples <= 0 || startSampleInFile >= lengthInSamples)
+		return;
+
+	Range<int64> byteRange;
+
+	if (isMonolith)
+	{
+		const int64 start = dataChunkStart + startSampleInFile * bytesPerFrame;
+		byteRange = Range<int64>(start, start + numSamples * bytesPerFrame);
+	}
+	else
+	{
+		auto& header = internalReader.header;
+
+		const int64 endSample = startSampleInFile + numSamples;
+		const bool isLastBlock = endSample / COMPRESSION_BLOCK_SIZE >= (int64)header.getBlockAmount() - 1;
+
+		const int64 start = (int64)header.getOffsetForReadPosition(startSampleInFile, true);
+		const int64 end = isLastBlock ? getFile().getSize() : (int64)header.getOffsetForNextBlock(endSample, true);
+
+		if (end <= start)
+			return;
+
+		byteRange = Range<int64>(start, end);
+	}
+
+	const auto mappedRange = map->getRange();
+
+	byteRange = byteRange.getIntersectionWith(mappedRange);
+
+	if (byteRange.isEmpty())
+		return;
+
+	// madvise needs a page aligned address (the page size is 16K on Apple Silicon)
+	static const int64 pageSize = jmax<int64>(4096, (int64)sysconf(_SC_PAGESIZE));
+	const int64 offset = byteRange.getStart() - mappedRange.getStart();
+	const int64 alignedOffset = offset - (((int64)(pointer_sized_int)map->getData() + offset) % pageSize);
+
+	auto start = static_cast<char*>(map->getData()) + alignedOffset;
+
+	posix_madvise(start, (size_t)(byteRange.getLength() + offset - alignedOffset), POSIX_MADV_WILLNEED);
+#else
+	ignoreUnused(startSampleInFile, numSamples);
+#endif
+}
+
 void HlacMemoryMappedAudioFormatReader::setTargetAudioDataType(AudioDataConverters::DataFormat dataType)
 {
 	usesFloatingPointData = (dataType == AudioDataConverters::DataFormat::float32BE) ||
@@ -533,6 +684,8 @@ bool HlacSubSectionReader::readSamples(int** destSamples, int numDestChannels, i
 	clearSamplesBeyondAvailableLength(destSamples, numDestChannels, startOffsetInDestBuffer,
 		startSampleInFile, numSamples, length);
 
+	ScopedLock sl(internalReader->getReadLock());
+
 	if(memoryReader != nullptr)
 		return memoryReader->readSamples(destSamples, numDestChannels, startOffsetInDestBuffer, startSampleInFile + start, numSamples);
 	else
@@ -556,16 +709,23 @@ void HlacSubSectionReader::readIntoFixedBuffer(HiseSampleBuffer& buffer, int sta
 	{
 		if (memoryReader != nullptr)
 		{
+			// Reading from the memory mapped file doesn't change the state of the reader
 			memoryReader->copyFromMonolith(buffer, startSample, buffer.getNumChannels(), start + readerStartSample, numChannels, numSamples);
 		}
 		else
 		{
+			ScopedLock sl(internalReader->getReadLock());
 			normalReader->copyFromMonolith(buffer, startSample, buffer.getNumChannels(), start + readerStartSample, numChannels, numSamples);
 		}
 	}
 	else
 	{
+#if HLAC_USE_DECODED_BLOCK_CACHE
+		internalReader->cachedFixedBufferRead(buffer, numChannels, startSample, start + readerStartSample, numSamples);
+#else
+		ScopedLock sl(internalReader->getReadLock());
 		internalReader->fixedBufferRead(buffer, numChannels, startSample, start + readerStartSample, numSamples);
+#endif
 
 		if (buffer.getNumChannels() == 1 || numChannels == 1)
 		{
@@ -574,4 +734,10 @@ void HlacSubSectionReader::readIntoFixedBuffer(HiseSampleBuffer& buffer, int sta
 	}
 }
 
+void HlacSubSectionReader::prefetch(int64 readerStartSample, int numSamples)
+{
+	if (memoryReader != nullptr)
+		memoryReader->prefetch(start + readerStartSample, (int64)numSamples);
+}
+
 } // namespace hlac
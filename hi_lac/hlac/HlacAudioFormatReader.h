@@ -106,6 +106,10 @@ public:
 		useHeaderOffsetWhenSeeking = shouldUseHeaderOffset;
 	};
 
+	/** The decoder and the input stream are stateful, so if multiple threads are reading from the same
+	*	reader (eg. the streaming worker threads with a shared monolith), they need to lock this. */
+	CriticalSection& getReadLock() noexcept { return readLock; }
+
 private:
 
 	friend class HlacSubSectionReader;
@@ -114,7 +118,23 @@ private:
 
 	bool fixedBufferRead(HiseSampleBuffer& buffer, int numDestChannels, int startOffsetInBuffer, int64 startSampleInFile, int numSamples);
 
-	
+#if HLAC_USE_DECODED_BLOCK_CACHE
+
+	/** Same as fixedBufferRead(), but it fetches every block from the DecodedBlockCache and only decodes the missing blocks.
+	*
+	*	It only acquires the read lock if a block needs to be decoded. */
+	bool cachedFixedBufferRead(HiseSampleBuffer& buffer, int numDestChannels, int startOffsetInBuffer, int64 startSampleInFile, int numSamples);
+
+	bool readBlocksWithCache(HiseSampleBuffer& destination, int numDestChannels, int64 startSampleInFile, int numSamples);
+
+	/** Decodes a single block into the block buffer and adds it to the cache. */
+	void decodeBlockIntoCache(int numDestChannels, int64 blockStart, int* normalisationValues);
+
+	const uint32 blockCacheId = DecodedBlockCache::createReaderId();
+
+	HiseSampleBuffer blockBuffer;
+
+#endif
 
 	friend class HiseLosslessAudioFormatReader;
 	friend class HlacMemoryMappedAudioFormatReader;
@@ -124,10 +144,12 @@ private:
 	HlacDecoder decoder;
 	HiseLosslessHeader header;
 
-	bool usesFloatingPointData;
+	bool usesFloatingPointData = true;
 
 	bool useHeaderOffsetWhenSeeking = true;
 
+	CriticalSection readLock;
+
 };
 
 class HiseLosslessAudioFormatReader : public AudioFormatReader
@@ -179,6 +201,11 @@ public:
 
 	bool mapSectionOfFile(Range<int64> samplesToMap) override;
 
+	/** Tells the OS that the given sample range will be read soon. 
+	*
+	*	This doesn't block, but lets the OS read the pages of the mapped file asynchronously. */
+	void prefetch(int64 startSampleInFile, int64 numSamples);
+
 	void getSample(int64 /*sampleIndex*/, float* result) const noexcept override
 	{
 		// this should never be used
@@ -215,6 +242,9 @@ public:
 
 	void readIntoFixedBuffer(HiseSampleBuffer& buffer, int startSample, int numSamples, int64 readerStartSample);
 
+	/** Forwards the prefetch hint to the memory mapped reader (if it uses one). */
+	void prefetch(int64 readerStartSample, int numSamples);
+
 private:
 
 	bool isMonolith = false;
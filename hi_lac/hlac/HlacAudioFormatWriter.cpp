@@ -56,6 +56,8 @@ bool HiseLosslessAudioFormatWriter::flush()
 	if (tempWasFlushed)
 		return true;
 
+	encoder.flushPendingBlocks(*tempOutputStream, blockOffsets);
+
 	if (!writeHeader())
 		return false;
 
@@ -74,6 +76,11 @@ void HiseLosslessAudioFormatWriter::setOptions(HlacEncoder::CompressorOptions& n
 	encoder.setOptions(newOptions);
 }
 
+void HiseLosslessAudioFormatWriter::setThreadPool(ThreadPool* pool)
+{
+	encoder.setThreadPool(pool);
+}
+
 void HiseLosslessAudioFormatWriter::setEnableFullDynamics(bool shouldEnableFullDynamics)
 {
 	options.normalisationMode = shouldEnableFullDynamics ? 2 : 0;
@@ -58,6 +58,9 @@ public:
 
 	void setEnableFullDynamics(bool shouldEnableFullDynamics);
 
+	/** Encodes the blocks on the given thread pool (see HlacEncoder::setThreadPool()). The pool must outlive this writer. */
+	void setThreadPool(ThreadPool* pool);
+
 	bool write(const int** samplesToWrite, int numSamples) override;
 
 	double getCompressionRatioForLastFile() { return encoder.getCompressionRatio(); }
@@ -32,10 +32,34 @@
 
 namespace hlac { using namespace juce; 
 
-void HlacEncoder::compress(AudioSampleBuffer& source, OutputStream& output, uint32* blockOffsetData)
+class HlacEncoder::BlockJob : public ThreadPoolJob
 {
-	bool compressStereo = source.getNumChannels() == 2;
+public:
+
+	BlockJob(CompressorOptions options, int normaliseBitShiftAmount, AudioSampleBuffer& source, int offset, int numSamples) :
+		ThreadPoolJob("HLAC Block Encoder"),
+		block(source.getNumChannels(), numSamples)
+	{
+		for (int i = 0; i < source.getNumChannels(); i++)
+			block.copyFrom(i, 0, source, i, offset, numSamples);
+
+		encoder.setOptions(options);
+		encoder.currentNormaliseBitShiftAmount = normaliseBitShiftAmount;
+	}
+
+	JobStatus runJob() override
+	{
+		encoder.encodeBlockAt(block, 0, block.getNumSamples(), output);
+		return jobHasFinished;
+	}
+
+	AudioSampleBuffer block;
+	HlacEncoder encoder;
+	MemoryOutputStream output;
+};
 
+void HlacEncoder::compress(AudioSampleBuffer& source, OutputStream& output, uint32* blockOffsetData)
+{
 	if (options.normalisationMode == CompressionHelpers::NormaliseMap::Mode::StaticNormalisation)
 	{
 		auto maxLevel = source.getMagnitude(0, source.getNumSamples());
@@ -45,78 +69,96 @@ void HlacEncoder::compress(AudioSampleBuffer& source, OutputStream& output, uint
 	else
 		currentNormaliseBitShiftAmount = 0;
 
-	if (source.getNumSamples() == COMPRESSION_BLOCK_SIZE)
+	for (int offset = 0; offset < source.getNumSamples(); offset += COMPRESSION_BLOCK_SIZE)
 	{
-		blockOffsetData[blockIndex] = numBytesWritten;
-		++blockIndex;
+		const int numTodo = jmin<int>(COMPRESSION_BLOCK_SIZE, source.getNumSamples() - offset);
 
-		if (compressStereo)
+		if (pool != nullptr)
 		{
-			auto l = CompressionHelpers::getPart(source, 0, 0, COMPRESSION_BLOCK_SIZE);
-			auto r = CompressionHelpers::getPart(source, 1, 0, COMPRESSION_BLOCK_SIZE);
+			auto job = pendingBlocks.add(new BlockJob(options, currentNormaliseBitShiftAmount, source, offset, numTodo));
+			pool->addJob(job, false);
 
-			encodeBlock(l, output);
-			encodeBlock(r, output);
+			while (pendingBlocks.size() > maxNumPendingBlocks)
+				writeNextPendingBlock(output, blockOffsetData);
 		}
 		else
-			encodeBlock(source, output);
+		{
+			blockOffsetData[blockIndex] = numBytesWritten;
+			++blockIndex;
 
-		return;
+			encodeBlockAt(source, offset, numTodo, output);
+		}
 	}
+}
 
-	blockOffset = 0;
-	int32 numSamplesRemaining = source.getNumSamples();
+void HlacEncoder::setThreadPool(ThreadPool* newPool, int maxNumPendingBlocks_)
+{
+	// Call flushPendingBlocks() before changing the pool
+	jassert(pendingBlocks.isEmpty());
 
-	while (numSamplesRemaining >= COMPRESSION_BLOCK_SIZE)
-	{
-		blockOffsetData[blockIndex] = numBytesWritten;
-		++blockIndex;
+	pool = newPool;
 
-		uint32 numTodo = jmin<int>(COMPRESSION_BLOCK_SIZE, source.getNumSamples());
+	if (pool != nullptr)
+		maxNumPendingBlocks = maxNumPendingBlocks_ > 0 ? maxNumPendingBlocks_ : 4 * pool->getNumThreads();
+}
 
-		if (compressStereo)
-		{
-			auto l = CompressionHelpers::getPart(source, 0, blockOffset, numTodo);
-			auto r = CompressionHelpers::getPart(source, 1, blockOffset, numTodo);
+void HlacEncoder::flushPendingBlocks(OutputStream& output, uint32* blockOffsetData)
+{
+	while (!pendingBlocks.isEmpty())
+		writeNextPendingBlock(output, blockOffsetData);
+}
 
-			encodeBlock(l, output);
-			encodeBlock(r, output);
-		}
-		else
-		{
-			auto b = CompressionHelpers::getPart(source, blockOffset, numTodo);
-			
-			encodeBlock(b, output);
-		}
+void HlacEncoder::writeNextPendingBlock(OutputStream& output, uint32* blockOffsetData)
+{
+	auto job = pendingBlocks.getFirst();
 
-		blockOffset += numTodo;
+	pool->waitForJobToFinish(job, -1);
 
-		numSamplesRemaining -= numTodo;
-	}
+	blockOffsetData[blockIndex] = numBytesWritten;
+	++blockIndex;
 
-	if (source.getNumSamples() - blockOffset > 0)
-	{
-		blockOffsetData[blockIndex] = numBytesWritten;
-		++blockIndex;
+	output.write(job->output.getData(), job->output.getDataSize());
+
+	numBytesWritten += job->encoder.numBytesWritten;
+	numBytesUncompressed += job->encoder.numBytesUncompressed;
+	numTemplates += job->encoder.numTemplates;
+	numDeltas += job->encoder.numDeltas;
 
-		const int remaining = source.getNumSamples() - blockOffset;
+	pendingBlocks.remove(0);
+}
+
+void HlacEncoder::encodeBlockAt(AudioSampleBuffer& source, int offset, int numSamples, OutputStream& output)
+{
+	const bool compressStereo = source.getNumChannels() == 2;
+	const bool isLastBlock = numSamples < COMPRESSION_BLOCK_SIZE;
+
+	blockOffset = offset;
 
-		if (compressStereo)
+	if (compressStereo)
+	{
+		auto l = CompressionHelpers::getPart(source, 0, offset, numSamples);
+		auto r = CompressionHelpers::getPart(source, 1, offset, numSamples);
+
+		if (isLastBlock)
 		{
-			auto l = CompressionHelpers::getPart(source, 0, blockOffset, remaining);
 			encodeLastBlock(l, output);
-			auto r = CompressionHelpers::getPart(source, 1, blockOffset, remaining);
 			encodeLastBlock(r, output);
 		}
 		else
 		{
-			auto b = CompressionHelpers::getPart(source, blockOffset, remaining);
-			encodeLastBlock(b, output);
+			encodeBlock(l, output);
+			encodeBlock(r, output);
 		}
-
 	}
+	else
+	{
+		auto b = CompressionHelpers::getPart(source, offset, numSamples);
 
-	
+		if (isLastBlock)
+			encodeLastBlock(b, output);
+		else
+			encodeBlock(b, output);
+	}
 }
 
 void HlacEncoder::reset()
@@ -137,9 +179,20 @@ void HlacEncoder::reset()
 }
 
 
+HlacEncoder::HlacEncoder() :
+	currentCycle(0),
+	workBuffer(0)
+{
+	reset();
+}
+
 HlacEncoder::~HlacEncoder()
 {
+	// The blocks will be lost if you don't call flushPendingBlocks()
+	jassert(pendingBlocks.isEmpty());
 
+	for (auto job : pendingBlocks)
+		pool->removeJob(job, true, -1);
 }
 
 
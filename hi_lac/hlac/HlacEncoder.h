@@ -40,12 +40,7 @@ class HlacEncoder
 {
 public:
 
-	HlacEncoder():
-		currentCycle(0),
-		workBuffer(0)
-	{
-		reset();
-	};
+	HlacEncoder();
 
 	~HlacEncoder();
 
@@ -130,6 +125,21 @@ public:
 
 	void compress(AudioSampleBuffer& source, OutputStream& output, uint32* blockOffsetData);
 	
+	/** Encodes the blocks on the given thread pool.
+	*
+	*	If a thread pool is set, compress() copies the blocks and encodes them asynchronously. The blocks
+	*	are written to the output stream in their original order, so the result is the same as with the serial encoding.
+	*	Blocks from subsequent compress() calls are encoded in parallel too, so it also distributes multiple files.
+	*
+	*	If more than maxNumPendingBlocks are queued, compress() waits until the oldest block is written 
+	*	(the default is four blocks per thread). 
+	*	You need to call flushPendingBlocks() after the last compress() call.
+	*/
+	void setThreadPool(ThreadPool* newPool, int maxNumPendingBlocks=-1);
+
+	/** Waits until all blocks that are encoded on the thread pool are written to the output stream. */
+	void flushPendingBlocks(OutputStream& output, uint32* blockOffsetData);
+
 	void reset();
 
 	void setOptions(CompressorOptions& newOptions)
@@ -143,6 +153,12 @@ public:
 
 private:
 
+	class BlockJob;
+
+	void encodeBlockAt(AudioSampleBuffer& source, int offset, int numSamples, OutputStream& output);
+
+	void writeNextPendingBlock(OutputStream& output, uint32* blockOffsetData);
+
 	bool encodeBlock(AudioSampleBuffer& block, OutputStream& output);
 
 	bool encodeBlock(CompressionHelpers::AudioBufferInt16& block, OutputStream& output);
@@ -207,6 +223,10 @@ private:
 	uint64 readIndex = 0;
 
 	double decompressionSpeed = 0.0;
+
+	ThreadPool* pool = nullptr;
+	int maxNumPendingBlocks = 0;
+	OwnedArray<BlockJob> pendingBlocks;
 };
 
 } // namespace hlac
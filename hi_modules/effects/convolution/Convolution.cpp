@@ -72,6 +72,8 @@ loadingThread(*this)
 
 ConvolutionEffect::~ConvolutionEffect()
 {
+	SpinLock::ScopedLockType sl(swapLock);
+
 	convolverL = nullptr;
 	convolverR = nullptr;
 }
@@ -87,17 +89,19 @@ void ConvolutionEffect::createEngine(audiofft::ImplementationType fftType)
 		bool useBackground = convolverL != nullptr ? convolverL->isUsingBackgroundThread() : false;
 		bool reload = convolverL != nullptr;
 
-		convolverL = nullptr;
-		convolverR = nullptr;
+		ScopedPointer<NonUniformConvolver> newL = new NonUniformConvolver(fftType);
+		ScopedPointer<NonUniformConvolver> newR = new NonUniformConvolver(fftType);
 
-		convolverL = new MultithreadedConvolver(fftType);
-		convolverR = new MultithreadedConvolver(fftType);
+		newL->setUseBackgroundThread(useBackground);
+		newR->setUseBackgroundThread(useBackground);
 
-		convolverL->reset();
-		convolverR->reset();
+		{
+			// The statistics are read without the impulse lock, so we need to protect the pointer swap
+			SpinLock::ScopedLockType ssl(swapLock);
 
-		convolverL->setUseBackgroundThread(useBackground);
-		convolverR->setUseBackgroundThread(useBackground);
+			convolverL.swapWith(newL);
+			convolverR.swapWith(newR);
+		}
 
 		if (reload)
 			setImpulse();
@@ -498,6 +502,42 @@ void ConvolutionEffect::calcCutoff()
 	setImpulse();
 }
 
+NonUniformConvolver::Statistics ConvolutionEffect::getDeadlineStatistics() const
+{
+	// The counters are atomic, so we don't need the impulse lock that is held by the audio thread
+	SpinLock::ScopedLockType sl(swapLock);
+
+	NonUniformConvolver::Statistics s;
+
+	if (convolverL != nullptr)
+		s.merge(convolverL->getStatistics());
+
+	if (convolverR != nullptr)
+		s.merge(convolverR->getStatistics());
+
+	return s;
+}
+
+void ConvolutionEffect::reportMissedDeadlines()
+{
+	const auto s = getDeadlineStatistics();
+	const auto numMissed = s.getNumMissedDeadlines();
+
+	// The convolvers were recreated
+	if (numMissed < numReportedMissedDeadlines)
+		numReportedMissedDeadlines = 0;
+
+	const auto now = Time::getMillisecondCounter();
+
+	if (numMissed > numReportedMissedDeadlines && now - lastDeadlineReportTime > 2000)
+	{
+		numReportedMissedDeadlines = numMissed;
+		lastDeadlineReportTime = now;
+
+		debugError(this, "The tail rendering missed its deadline: " + s.toString());
+	}
+}
+
 
 
 void GainSmoother::processBlock(float** data, int numChannels, int numSamples)
@@ -589,6 +629,8 @@ void ConvolutionEffect::LoadingThread::run()
 			shouldRestart = false;
 		}
 
+		parent.reportMissedDeadlines();
+
 		wait(100);
 	}
 	
@@ -602,74 +644,108 @@ bool ConvolutionEffect::LoadingThread::reloadInternal()
 
 		parent.convolverL->reset();
 		parent.convolverR->reset();
+		parent.spectraCache->releaseUnusedSpectra();
 		return true;
 	}
 
 	auto pBuffer = *parent.getSampleBuffer();
 
-	AudioSampleBuffer copyBuffer(2, parent.getSampleBuffer()->getNumSamples());
-
-	copyBuffer.copyFrom(0, 0, pBuffer.getReadPointer(0), pBuffer.getNumSamples(), 1.0f);
-	copyBuffer.copyFrom(1, 0, pBuffer.getReadPointer(pBuffer.getNumChannels() >= 2 ? 1 : 0), pBuffer.getNumSamples(), 1.0f);
-
-	if (shouldRestart)
-		return false;
-
 	const auto offset = parent.getRange().getStart();
 	const auto irLength = parent.getRange().getLength();
 
 	if (irLength > 44100 * 20)
 		jassertfalse;
 
-	auto l = copyBuffer.getReadPointer(0, offset);
-	auto r = copyBuffer.getReadPointer(1, offset);
+	ImpulseResponseSpectra::Layout layout;
+	layout.headSize = nextPowerOfTwo(parent.getLargestBlockSize());
 
-	auto resampleRatio = parent.getResampleFactor();
+	ImpulseResponseSpectraCache::Key keys[2];
 
-	int resampledLength = roundToInt((double)irLength * resampleRatio);
-
-	AudioSampleBuffer scratchBuffer(2, resampledLength);
-
-	if (shouldRestart)
-		return false;
-
-	if (resampleRatio != 1.0)
+	for (int i = 0; i < 2; i++)
 	{
-		LagrangeInterpolator resampler;
-		resampler.process(1.0 / resampleRatio, l, scratchBuffer.getWritePointer(0), resampledLength);
-		resampler.reset();
-		resampler.process(1.0 / resampleRatio, r, scratchBuffer.getWritePointer(1), resampledLength);
+		auto& k = keys[i];
+
+		k.poolHash = parent.getFileName().hashCode64();
+		k.channelIndex = (i == 1 && pBuffer.getNumChannels() >= 2) ? 1 : 0;
+		k.contentHash = ImpulseResponseSpectraCache::Key::createContentHash(pBuffer.getReadPointer(k.channelIndex, offset), irLength);
+		k.range = parent.getRange();
+		k.sampleRate = parent.getSampleRate();
+		k.damping = parent.damping;
+		k.cutoffFrequency = parent.cutoffFrequency;
+		k.layout = layout;
+		k.fftType = parent.convolverL->getFFTType();
 	}
-	else
+
+	// If another convolution effect uses the same impulse response, we can skip the calculation
+	auto spectraL = parent.spectraCache->getSpectra(keys[0]);
+	auto spectraR = parent.spectraCache->getSpectra(keys[1]);
+
+	if (spectraL == nullptr || spectraR == nullptr)
 	{
-		FloatVectorOperations::copy(scratchBuffer.getWritePointer(0), l, irLength);
-		FloatVectorOperations::copy(scratchBuffer.getWritePointer(1), r, irLength);
-	}
+		AudioSampleBuffer copyBuffer(2, pBuffer.getNumSamples());
+
+		copyBuffer.copyFrom(0, 0, pBuffer.getReadPointer(0), pBuffer.getNumSamples(), 1.0f);
+		copyBuffer.copyFrom(1, 0, pBuffer.getReadPointer(keys[1].channelIndex), pBuffer.getNumSamples(), 1.0f);
+
+		if (shouldRestart)
+			return false;
+
+		auto l = copyBuffer.getReadPointer(0, offset);
+		auto r = copyBuffer.getReadPointer(1, offset);
+
+		auto resampleRatio = parent.getResampleFactor();
+
+		int resampledLength = roundToInt((double)irLength * resampleRatio);
 
-	if (shouldRestart)
-		return false;
+		AudioSampleBuffer scratchBuffer(2, resampledLength);
 
-	if (parent.damping != 1.0f)
-		applyExponentialFadeout(scratchBuffer, resampledLength, parent.damping);
+		if (shouldRestart)
+			return false;
 
-	if (shouldRestart)
-		return false;
+		if (resampleRatio != 1.0)
+		{
+			LagrangeInterpolator resampler;
+			resampler.process(1.0 / resampleRatio, l, scratchBuffer.getWritePointer(0), resampledLength);
+			resampler.reset();
+			resampler.process(1.0 / resampleRatio, r, scratchBuffer.getWritePointer(1), resampledLength);
+		}
+		else
+		{
+			FloatVectorOperations::copy(scratchBuffer.getWritePointer(0), l, irLength);
+			FloatVectorOperations::copy(scratchBuffer.getWritePointer(1), r, irLength);
+		}
+
+		if (shouldRestart)
+			return false;
 
-	if (parent.cutoffFrequency != 20000.0)
-		applyHighFrequencyDamping(scratchBuffer, resampledLength, parent.cutoffFrequency, parent.getSampleRate());
+		if (parent.damping != 1.0f)
+			applyExponentialFadeout(scratchBuffer, resampledLength, parent.damping);
 
-	if (shouldRestart)
-		return false;
+		if (shouldRestart)
+			return false;
 
-	const auto headSize = nextPowerOfTwo(parent.getLargestBlockSize());
-	const auto fullTailLength = nextPowerOfTwo(resampledLength - headSize);
+		if (parent.cutoffFrequency != 20000.0)
+			applyHighFrequencyDamping(scratchBuffer, resampledLength, parent.cutoffFrequency, parent.getSampleRate());
+
+		if (shouldRestart)
+			return false;
+
+		if (spectraL == nullptr)
+			spectraL = parent.spectraCache->createSpectra(keys[0], scratchBuffer.getReadPointer(0), resampledLength);
+
+		// A mono impulse response uses the same spectra for both channels
+		if (spectraR == nullptr)
+			spectraR = parent.spectraCache->getSpectra(keys[1]);
+
+		if (spectraR == nullptr)
+			spectraR = parent.spectraCache->createSpectra(keys[1], scratchBuffer.getReadPointer(1), resampledLength);
+	}
 
 	ScopedLock sl(parent.getImpulseLock());
 
-	parent.convolverL->reset();
-	parent.convolverR->reset();
-	parent.convolverL->init(headSize, jmin<int>(8192, fullTailLength), scratchBuffer.getReadPointer(0), resampledLength);
-	parent.convolverR->init(headSize, jmin<int>(8192, fullTailLength), scratchBuffer.getReadPointer(1), resampledLength);
+	parent.convolverL->setImpulseResponse(spectraL);
+	parent.convolverR->setImpulseResponse(spectraR);
+	parent.spectraCache->releaseUnusedSpectra();
 	parent.enableProcessing(parent.processingEnabled);
 
 	return true;
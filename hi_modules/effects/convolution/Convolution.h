@@ -103,122 +103,13 @@ private:
 	
 };
 
-class MultithreadedConvolver : public fftconvolver::TwoStageFFTConvolver
-{
-	class BackgroundThread : public Thread
-	{
-	public:
-
-		BackgroundThread(MultithreadedConvolver& parent_) :
-			Thread("Convolution Background Thread"),
-			parent(parent_)
-		{
-			
-		}
-
-		void run() override
-		{
-			while (!threadShouldExit())
-			{
-
-				if (active)
-				{
-					ScopedValueSetter<bool> svs(currentlyRendering, true);
-					parent.doBackgroundProcessing();
-					active = false;
-
-					if (threadShouldExit())
-						return;
-				}
-
-				wait(500);
-			}
-		};
-
-		void setSomethingTodo(bool shouldBeActive)
-		{
-			active = shouldBeActive;
-		}
-
-		bool isBusy() const { return currentlyRendering; }
-
-		bool currentlyRendering = false;
-		bool active = false;
-
-		MultithreadedConvolver& parent;
-	};
-
-
-public:
-
-	MultithreadedConvolver(audiofft::ImplementationType fftType) :
-		TwoStageFFTConvolver(fftType),
-		backgroundThread(*this)
-	{};
-
-	virtual ~MultithreadedConvolver()
-	{
-		backgroundThread.stopThread(1000);
-	};
-
-	void startBackgroundProcessing() override
-	{
-		if (useBackgroundThread)
-		{
-			backgroundThread.setSomethingTodo(true);
-			backgroundThread.notify();
-		}
-		else
-		{
-			doBackgroundProcessing();
-		}
-	}
-
-	void waitForBackgroundProcessing() override
-	{
-		if (useBackgroundThread)
-		{
-			while (backgroundThread.isBusy())
-				jassertfalse;
-		}
-	}
-
-	void setUseBackgroundThread(bool shouldBeUsingBackgroundThread)
-	{
-		if (useBackgroundThread != shouldBeUsingBackgroundThread)
-		{
-			useBackgroundThread = shouldBeUsingBackgroundThread;
-		
-			if (useBackgroundThread)
-				backgroundThread.startThread(9);
-			else
-			{
-				if(backgroundThread.isThreadRunning())
-					backgroundThread.stopThread(1000);
-			}
-				
-		}
-	}
-
-	bool isUsingBackgroundThread() const
-	{
-		return useBackgroundThread;
-	}
-
-private:
-
-	BackgroundThread backgroundThread;
-
-	bool useBackgroundThread = true;
-};
-
-
 /** @brief A convolution reverb using zero-latency convolution
 *	@ingroup effectTypes
 *
-*	This is a wrapper for the convolution engine found in WDL (the sole MIT licenced convolution engine available)
-*	It is not designed to replace real convolution reverbs (as the CPU usage for impulses > 0.6 seconds is unreasonable),
-*	but your early reflection impulses or other filter impulses will be thankful for this effect.
+*	The impulse response is split into non-uniform partitions (see NonUniformConvolver): the head is rendered
+*	on the audio thread and the bigger tail partitions can be rendered by a worker pool that is shared by all
+*	convolution effects. The transformed impulse responses are stored in a process wide cache, so multiple
+*	instances that load the same impulse response from the pool don't need to store it twice.
 */
 class ConvolutionEffect: public MasterEffectProcessor,
 						 public AudioSampleProcessor
@@ -306,7 +197,7 @@ public:
 		Latency, ///< you can change the latency (unused)
 		ImpulseLength, ///< the Impulse length (deprecated, use the SampleArea of the AudioSampleBufferComponent to change the impulse response)
 		ProcessInput, ///< if this attribute is set, the engine will fade out in a short time and reset itself.
-		UseBackgroundThread, ///< if true, then the tail of the impulse response will be rendered on a background thread to save cycles on the audio thread.
+		UseBackgroundThread, ///< if true, then the tail of the impulse response will be rendered by the shared worker threads to save cycles on the audio thread.
 		Predelay, ///< delays the reverb tail by the given amount in milliseconds
 		HiCut, ///< applies a low pass filter to the impulse response
 		Damping, ///< applies a fade-out to the impulse response
@@ -354,6 +245,9 @@ public:
 
 	const CriticalSection& getFileLock() const override { return unusedFileLock; }
 
+	/** Returns the number of tail blocks that were not rendered in time by the worker threads (for both channels). */
+	NonUniformConvolver::Statistics getDeadlineStatistics() const;
+
 private:
 
 	bool processingEnabled = true;
@@ -362,6 +256,7 @@ private:
 
 	void createEngine(audiofft::ImplementationType fftType);
 
+	/** Protects the convolver pointers when the deadline statistics are read on another thread. */
 	SpinLock swapLock;
 
 	LoadingThread loadingThread;
@@ -422,8 +317,10 @@ private:
 	
 	float predelayMs = 0.0f;
 
-	ScopedPointer<MultithreadedConvolver> convolverL;
-	ScopedPointer<MultithreadedConvolver> convolverR;
+	ScopedPointer<NonUniformConvolver> convolverL;
+	ScopedPointer<NonUniformConvolver> convolverR;
+
+	SharedResourcePointer<ImpulseResponseSpectraCache> spectraCache;
 
 	double cutoffFrequency = 20000.0;
 
@@ -437,6 +334,12 @@ private:
 	static void applyHighFrequencyDamping(AudioSampleBuffer& buffer, int numSamples, double cutoffFrequency, double sampleRate);
 
 	void calcCutoff();
+
+	/** Writes a warning to the console if the worker threads couldn't keep up with the tail rendering. */
+	void reportMissedDeadlines();
+
+	int64 numReportedMissedDeadlines = 0;
+	uint32 lastDeadlineReportTime = 0;
 };
 
 
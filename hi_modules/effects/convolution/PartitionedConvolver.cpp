@@ -0,0 +1,725 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+namespace hise { using namespace juce;
+
+bool ImpulseResponseSpectra::Layout::operator==(const Layout& other) const noexcept
+{
+	return headSize == other.headSize && numTiers == other.numTiers && tierRatio == other.tierRatio;
+}
+
+int ImpulseResponseSpectra::Layout::getBlockSize(int tierIndex) const noexcept
+{
+	int blockSize = headSize;
+
+	for (int i = 0; i < tierIndex; i++)
+		blockSize *= tierRatio;
+
+	return blockSize;
+}
+
+int ImpulseResponseSpectra::Layout::getTierOffset(int tierIndex) const noexcept
+{
+	return tierIndex == 0 ? 0 : 2 * getBlockSize(tierIndex);
+}
+
+ImpulseResponseSpectra::ImpulseResponseSpectra(const Layout& layout_, audiofft::ImplementationType fftType_, const float* ir, int numSamples) :
+	layout(layout_),
+	fftType(fftType_)
+{
+	jassert(isPowerOfTwo(layout.headSize));
+	jassert(isPowerOfTwo(layout.tierRatio) && layout.tierRatio > 1);
+
+	// Ignore zeros at the end of the impulse response because they only waste computation time
+	while (numSamples > 0 && std::abs(ir[numSamples - 1]) < 0.000001f)
+		--numSamples;
+
+	for (int i = 0; i <= layout.numTiers; i++)
+	{
+		const int offset = layout.getTierOffset(i);
+
+		if (offset >= numSamples)
+			break;
+
+		const int end = (i < layout.numTiers) ? jmin<int>(numSamples, layout.getTierOffset(i + 1)) : numSamples;
+		const int blockSize = layout.getBlockSize(i);
+		const size_t segmentSize = 2 * (size_t)blockSize;
+		const size_t complexSize = audiofft::AudioFFT::ComplexSize(segmentSize);
+
+		audiofft::AudioFFT fft(fftType);
+		fft.init(segmentSize);
+
+		fftconvolver::SampleBuffer fftBuffer(segmentSize);
+
+		auto t = new Tier();
+		t->blockSize = blockSize;
+		t->offset = offset;
+
+		for (int pos = offset; pos < end; pos += blockSize)
+		{
+			auto segment = new fftconvolver::SplitComplex(complexSize);
+
+			fftconvolver::CopyAndPad(fftBuffer, ir + pos, (size_t)jmin<int>(blockSize, end - pos));
+			fft.fft(fftBuffer.data(), segment->re(), segment->im());
+
+			t->segments.add(segment);
+			numBytes += (int64)(2 * complexSize * sizeof(float));
+		}
+
+		tiers.add(t);
+	}
+}
+
+// ==================================================================================================================
+
+bool ImpulseResponseSpectraCache::Key::operator==(const Key& other) const noexcept
+{
+	return poolHash == other.poolHash &&
+		   contentHash == other.contentHash &&
+		   range == other.range &&
+		   channelIndex == other.channelIndex &&
+		   sampleRate == other.sampleRate &&
+		   damping == other.damping &&
+		   cutoffFrequency == other.cutoffFrequency &&
+		   layout == other.layout &&
+		   fftType == other.fftType;
+}
+
+int64 ImpulseResponseSpectraCache::Key::createContentHash(const float* data, int numSamples) noexcept
+{
+	// FNV-1a over the raw sample bits
+	uint64 hash = 14695981039346656037ull;
+
+	for (int i = 0; i < numSamples; i++)
+	{
+		uint32 bits;
+		memcpy(&bits, data + i, sizeof(uint32));
+
+		hash = (hash ^ bits) * 1099511628211ull;
+	}
+
+	return (int64)hash;
+}
+
+ImpulseResponseSpectra::Ptr ImpulseResponseSpectraCache::getSpectra(const Key& key)
+{
+	ScopedLock sl(lock);
+
+	for (const auto& e : entries)
+	{
+		if (e.key == key)
+		{
+			numHits++;
+			return e.spectra;
+		}
+	}
+
+	return nullptr;
+}
+
+ImpulseResponseSpectra::Ptr ImpulseResponseSpectraCache::createSpectra(const Key& key, const float* ir, int numSamples)
+{
+	// The transformation takes a while, so we don't block the other loading threads
+	ImpulseResponseSpectra::Ptr newSpectra = new ImpulseResponseSpectra(key.layout, key.fftType, ir, numSamples);
+
+	ScopedLock sl(lock);
+
+	for (const auto& e : entries)
+	{
+		if (e.key == key)
+		{
+			numHits++;
+			return e.spectra;
+		}
+	}
+
+	numMisses++;
+
+	Entry e;
+	e.key = key;
+	e.spectra = newSpectra;
+
+	entries.add(e);
+
+	return newSpectra;
+}
+
+void ImpulseResponseSpectraCache::releaseUnusedSpectra()
+{
+	ScopedLock sl(lock);
+
+	for (int i = entries.size() - 1; i >= 0; i--)
+	{
+		if (entries.getReference(i).spectra->getReferenceCount() == 1)
+			entries.remove(i);
+	}
+}
+
+ImpulseResponseSpectraCache::Statistics ImpulseResponseSpectraCache::getStatistics() const
+{
+	ScopedLock sl(lock);
+
+	Statistics s;
+
+	s.numEntries = entries.size();
+	s.numHits = numHits;
+	s.numMisses = numMisses;
+
+	for (const auto& e : entries)
+		s.numBytes += e.spectra->getNumBytes();
+
+	return s;
+}
+
+String ImpulseResponseSpectraCache::Statistics::toString() const
+{
+	String s;
+
+	s << String(numEntries) << " impulse responses, ";
+	s << String((double)numBytes / 1024.0 / 1024.0, 1) << " MB, ";
+	s << String(numHits) << " shared / " << String(numMisses) << " calculated";
+
+	return s;
+}
+
+// ==================================================================================================================
+
+ConvolutionWorkerPool::Worker::Worker(ConvolutionWorkerPool& parent_, int priorityLevel_) :
+	Thread("Convolution Worker Thread " + String(priorityLevel_)),
+	priorityLevel(priorityLevel_),
+	idle(false),
+	parent(parent_)
+{
+
+}
+
+void ConvolutionWorkerPool::Worker::run()
+{
+	while (!threadShouldExit())
+	{
+		if (auto job = parent.popJob(priorityLevel))
+		{
+			runJob(job);
+			continue;
+		}
+
+		idle.store(true);
+
+		// Check again, a job that was added before the idle flag was set didn't wake us up
+		if (auto job = parent.popJob(priorityLevel))
+		{
+			idle.store(false);
+			runJob(job);
+			continue;
+		}
+
+		wait(500);
+		idle.store(false);
+	}
+}
+
+ConvolutionWorkerPool::ConvolutionWorkerPool(int numThreadsPerLevel)
+{
+	for (int level = 0; level < NumPriorityLevels; level++)
+	{
+		for (int i = 0; i < numThreadsPerLevel; i++)
+		{
+			auto w = new Worker(*this, level);
+			workers.add(w);
+			w->startThread(9 - 2 * level);
+		}
+	}
+}
+
+ConvolutionWorkerPool::~ConvolutionWorkerPool()
+{
+	for (auto w : workers)
+		w->signalThreadShouldExit();
+
+	for (auto w : workers)
+	{
+		w->notify();
+		w->stopThread(1000);
+	}
+}
+
+void ConvolutionWorkerPool::addJob(Job* job)
+{
+	jassert(isPositiveAndBelow(job->priority, (int)NumPriorityLevels));
+
+	job->state.store(Job::Queued);
+
+	bool wasAdded = false;
+
+	{
+		SpinLock::ScopedLockType sl(queueLock);
+
+		auto& q = queues[job->priority];
+
+		if (!workers.isEmpty() && q.numQueued < QueueSize)
+		{
+			q.jobs[(q.readIndex + q.numQueued) % QueueSize] = job;
+			q.numQueued++;
+			wasAdded = true;
+		}
+	}
+
+	if (!wasAdded)
+	{
+		finishJob(job);
+		return;
+	}
+
+	// Wake up an idle worker of the job's level or (if there is none) a less urgent one
+	for (int level = job->priority; level < NumPriorityLevels; level++)
+	{
+		for (auto w : workers)
+		{
+			if (w->priorityLevel == level && w->idle.load())
+			{
+				w->notify();
+				return;
+			}
+		}
+	}
+}
+
+ConvolutionWorkerPool::Deadline ConvolutionWorkerPool::finishJob(Job* job)
+{
+	int expected = Job::Queued;
+
+	if (job->state.compare_exchange_strong(expected, Job::Running))
+	{
+		runJob(job);
+		return Deadline::Missed;
+	}
+
+	if (job->state.load() != Job::Running)
+		return Deadline::Met;
+
+	waitForRunningJob(job);
+
+	return Deadline::Waited;
+}
+
+void ConvolutionWorkerPool::removeJob(Job* job)
+{
+	{
+		SpinLock::ScopedLockType sl(queueLock);
+
+		for (auto& q : queues)
+		{
+			for (int i = 0; i < q.numQueued; i++)
+			{
+				auto& j = q.jobs[(q.readIndex + i) % QueueSize];
+
+				if (j == job)
+					j = nullptr;
+			}
+		}
+
+		int expected = Job::Queued;
+		job->state.compare_exchange_strong(expected, Job::Idle);
+	}
+
+	waitForRunningJob(job);
+}
+
+void ConvolutionWorkerPool::runJob(Job* job)
+{
+	job->run();
+	job->state.store(Job::Finished);
+	job->finishEvent.signal();
+}
+
+void ConvolutionWorkerPool::waitForRunningJob(Job* job)
+{
+	for (int i = 0; i < NumSpinsBeforeWait; i++)
+	{
+		if (job->state.load() != Job::Running)
+			return;
+	}
+
+	// Yielding doesn't give the CPU to a worker with a lower priority, so we need to block here.
+	// The event might still be signaled from an earlier run, so we check the state again after the timeout.
+	while (job->state.load() == Job::Running)
+		job->finishEvent.wait(1);
+}
+
+ConvolutionWorkerPool::Job* ConvolutionWorkerPool::popJob(int maxPriorityLevel)
+{
+	SpinLock::ScopedLockType sl(queueLock);
+
+	for (int level = 0; level <= maxPriorityLevel; level++)
+	{
+		auto& q = queues[level];
+
+		while (q.numQueued > 0)
+		{
+			auto job = q.jobs[q.readIndex];
+
+			q.readIndex = (q.readIndex + 1) % QueueSize;
+			q.numQueued--;
+
+			if (job == nullptr)
+				continue;
+
+			// The audio thread might have rendered the job already
+			int expected = Job::Queued;
+
+			if (job->state.compare_exchange_strong(expected, Job::Running))
+				return job;
+		}
+	}
+
+	return nullptr;
+}
+
+// ==================================================================================================================
+
+/** A uniformly partitioned zero latency convolution (the same algorithm as fftconvolver::FFTConvolver),
+	but it uses the segments of the shared impulse response spectra.
+*/
+struct NonUniformConvolver::Stage
+{
+	Stage(const ImpulseResponseSpectra::Tier& tier_, audiofft::ImplementationType fftType) :
+		tier(tier_),
+		blockSize((size_t)tier_.blockSize),
+		fft(fftType)
+	{
+		const size_t segmentSize = 2 * blockSize;
+		const size_t complexSize = audiofft::AudioFFT::ComplexSize(segmentSize);
+
+		fft.init(segmentSize);
+		fftBuffer.resize(segmentSize);
+
+		for (int i = 0; i < tier.segments.size(); i++)
+			segments.add(new fftconvolver::SplitComplex(complexSize));
+
+		preMultiplied.resize(complexSize);
+		conv.resize(complexSize);
+		overlap.resize(blockSize);
+		inputBuffer.resize(blockSize);
+	}
+
+	void clear()
+	{
+		for (auto s : segments)
+			s->setZero();
+
+		preMultiplied.setZero();
+		conv.setZero();
+		overlap.setZero();
+		inputBuffer.setZero();
+
+		inputBufferFill = 0;
+		current = 0;
+	}
+
+	void process(const float* input, float* output, size_t numSamples)
+	{
+		const size_t numSegments = (size_t)segments.size();
+
+		size_t processed = 0;
+
+		while (processed < numSamples)
+		{
+			const bool inputBufferWasEmpty = inputBufferFill == 0;
+			const size_t numToProcess = jmin<size_t>(numSamples - processed, blockSize - inputBufferFill);
+			const size_t inputBufferPos = inputBufferFill;
+
+			memcpy(inputBuffer.data() + inputBufferPos, input + processed, numToProcess * sizeof(float));
+
+			fftconvolver::CopyAndPad(fftBuffer, inputBuffer.data(), blockSize);
+			fft.fft(fftBuffer.data(), segments.getUnchecked((int)current)->re(), segments.getUnchecked((int)current)->im());
+
+			// The older input blocks don't change until the current block is full, so we only need to multiply them once
+			if (inputBufferWasEmpty)
+			{
+				preMultiplied.setZero();
+
+				for (size_t i = 1; i < numSegments; i++)
+				{
+					const int audioIndex = (int)((current + i) % numSegments);
+					fftconvolver::ComplexMultiplyAccumulate(preMultiplied, *tier.segments.getUnchecked((int)i), *segments.getUnchecked(audioIndex));
+				}
+			}
+
+			conv.copyFrom(preMultiplied);
+			fftconvolver::ComplexMultiplyAccumulate(conv, *segments.getUnchecked((int)current), *tier.segments.getUnchecked(0));
+
+			fft.ifft(fftBuffer.data(), conv.re(), conv.im());
+
+			fftconvolver::Sum(output + processed, fftBuffer.data() + inputBufferPos, overlap.data() + inputBufferPos, numToProcess);
+
+			inputBufferFill += numToProcess;
+
+			if (inputBufferFill == blockSize)
+			{
+				inputBuffer.setZero();
+				inputBufferFill = 0;
+
+				memcpy(overlap.data(), fftBuffer.data() + blockSize, blockSize * sizeof(float));
+
+				current = (current > 0) ? (current - 1) : (numSegments - 1);
+			}
+
+			processed += numToProcess;
+		}
+	}
+
+	const ImpulseResponseSpectra::Tier& tier;
+	const size_t blockSize;
+
+	audiofft::AudioFFT fft;
+
+	OwnedArray<fftconvolver::SplitComplex> segments;
+	fftconvolver::SampleBuffer fftBuffer;
+	fftconvolver::SplitComplex preMultiplied;
+	fftconvolver::SplitComplex conv;
+	fftconvolver::SampleBuffer overlap;
+	fftconvolver::SampleBuffer inputBuffer;
+
+	size_t inputBufferFill = 0;
+	size_t current = 0;
+};
+
+/** A tier with a bigger block size that is rendered one block later as a job of the worker pool.
+*
+*	The tier starts at twice its block size in the impulse response, so the result of the input block
+*	that was completed at the last block boundary is needed at the next block boundary.
+*/
+struct NonUniformConvolver::TailTier : public ConvolutionWorkerPool::Job
+{
+	TailTier(const ImpulseResponseSpectra::Tier& tier, audiofft::ImplementationType fftType) :
+		stage(tier, fftType),
+		blockSize(tier.blockSize),
+		input((size_t)tier.blockSize),
+		jobInput((size_t)tier.blockSize),
+		jobOutput((size_t)tier.blockSize),
+		output((size_t)tier.blockSize)
+	{}
+
+	void run() override
+	{
+		stage.process(jobInput.data(), jobOutput.data(), (size_t)blockSize);
+	}
+
+	void clear()
+	{
+		stage.clear();
+		input.setZero();
+		jobInput.setZero();
+		jobOutput.setZero();
+		output.setZero();
+
+		numFilled = 0;
+	}
+
+	Stage stage;
+	const int blockSize;
+
+	fftconvolver::SampleBuffer input;
+	fftconvolver::SampleBuffer jobInput;
+	fftconvolver::SampleBuffer jobOutput;
+	fftconvolver::SampleBuffer output;
+
+	int numFilled = 0;
+};
+
+NonUniformConvolver::NonUniformConvolver(audiofft::ImplementationType fftType_) :
+	fftType(fftType_),
+	numJobs(0),
+	numLateJobs(0),
+	numMissedJobs(0),
+	maxDelayMs(0.0)
+{
+
+}
+
+NonUniformConvolver::~NonUniformConvolver()
+{
+	reset();
+}
+
+void NonUniformConvolver::setImpulseResponse(ImpulseResponseSpectra::Ptr newSpectra)
+{
+	reset();
+
+	spectra = newSpectra;
+
+	if (spectra == nullptr || spectra->getNumTiers() == 0)
+		return;
+
+	jassert(spectra->getFFTType() == fftType);
+
+	head = new Stage(spectra->getTier(0), fftType);
+
+	for (int i = 1; i < spectra->getNumTiers(); i++)
+	{
+		auto t = new TailTier(spectra->getTier(i), fftType);
+
+		// The bigger tiers have more time until their deadline, so they can wait for the smaller ones
+		t->priority = jmin<int>(i - 1, ConvolutionWorkerPool::NumPriorityLevels - 1);
+
+		tailTiers.add(t);
+	}
+}
+
+void NonUniformConvolver::process(const float* input, float* output, int numSamples)
+{
+	if (head == nullptr)
+	{
+		FloatVectorOperations::clear(output, numSamples);
+		return;
+	}
+
+	head->process(input, output, (size_t)numSamples);
+
+	for (auto t : tailTiers)
+	{
+		int processed = 0;
+
+		while (processed < numSamples)
+		{
+			const int numToProcess = jmin<int>(numSamples - processed, t->blockSize - t->numFilled);
+
+			FloatVectorOperations::copy(t->input.data() + t->numFilled, input + processed, numToProcess);
+			FloatVectorOperations::add(output + processed, t->output.data() + t->numFilled, numToProcess);
+
+			t->numFilled += numToProcess;
+			processed += numToProcess;
+
+			if (t->numFilled == t->blockSize)
+			{
+				// The block that was started at the last boundary is due now
+				finishJob(t);
+
+				fftconvolver::SampleBuffer::Swap(t->output, t->jobOutput);
+				fftconvolver::SampleBuffer::Swap(t->input, t->jobInput);
+				t->numFilled = 0;
+
+				if (useBackgroundThread)
+				{
+					numJobs.fetch_add(1, std::memory_order_relaxed);
+					pool->addJob(t);
+				}
+				else
+					t->run();
+			}
+		}
+	}
+}
+
+void NonUniformConvolver::reset()
+{
+	for (auto t : tailTiers)
+		pool->removeJob(t);
+
+	tailTiers.clear();
+	head = nullptr;
+	spectra = nullptr;
+}
+
+void NonUniformConvolver::cleanPipeline()
+{
+	// The results of the pending jobs will be cleared anyway, so there's no need to render them here
+	for (auto t : tailTiers)
+		pool->removeJob(t);
+
+	if (head != nullptr)
+		head->clear();
+
+	for (auto t : tailTiers)
+		t->clear();
+}
+
+void NonUniformConvolver::finishJob(TailTier* t)
+{
+	const auto start = Time::getHighResolutionTicks();
+	const auto result = ConvolutionWorkerPool::finishJob(t);
+
+	if (result == ConvolutionWorkerPool::Deadline::Met)
+		return;
+
+	if (result == ConvolutionWorkerPool::Deadline::Waited)
+		numLateJobs.fetch_add(1, std::memory_order_relaxed);
+	else
+		numMissedJobs.fetch_add(1, std::memory_order_relaxed);
+
+	const double delayMs = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start) * 1000.0;
+
+	if (delayMs > maxDelayMs.load(std::memory_order_relaxed))
+		maxDelayMs.store(delayMs, std::memory_order_relaxed);
+}
+
+NonUniformConvolver::Statistics NonUniformConvolver::getStatistics() const noexcept
+{
+	Statistics s;
+
+	s.numJobs = numJobs.load();
+	s.numLateJobs = numLateJobs.load();
+	s.numMissedJobs = numMissedJobs.load();
+	s.maxDelayMs = maxDelayMs.load();
+
+	return s;
+}
+
+void NonUniformConvolver::resetStatistics() noexcept
+{
+	numJobs = 0;
+	numLateJobs = 0;
+	numMissedJobs = 0;
+	maxDelayMs = 0.0;
+}
+
+void NonUniformConvolver::Statistics::merge(const Statistics& other) noexcept
+{
+	numJobs += other.numJobs;
+	numLateJobs += other.numLateJobs;
+	numMissedJobs += other.numMissedJobs;
+	maxDelayMs = jmax(maxDelayMs, other.maxDelayMs);
+}
+
+String NonUniformConvolver::Statistics::toString() const
+{
+	String s;
+
+	s << String(numJobs) << " tail blocks, " << String(numLateJobs) << " late, " << String(numMissedJobs) << " missed";
+
+	if (getNumMissedDeadlines() > 0)
+		s << " (max. " << String(maxDelayMs, 2) << "ms)";
+
+	return s;
+}
+
+} // namespace hise
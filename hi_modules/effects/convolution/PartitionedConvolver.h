@@ -0,0 +1,422 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+#ifndef PARTITIONEDCONVOLVER_H_INCLUDED
+#define PARTITIONEDCONVOLVER_H_INCLUDED
+
+namespace hise { using namespace juce;
+
+/** The number of partition tiers that follow the zero latency head of the impulse response.
+*
+*	Every tier uses a block size that is HISE_CONVOLUTION_TIER_RATIO times bigger than the block size
+*	of the previous tier. The last tier covers the rest of the impulse response.
+*/
+#ifndef HISE_CONVOLUTION_NUM_TIERS
+#define HISE_CONVOLUTION_NUM_TIERS 3
+#endif
+
+/** The ratio between the block sizes of two adjacent partition tiers. This must be a power of two. */
+#ifndef HISE_CONVOLUTION_TIER_RATIO
+#define HISE_CONVOLUTION_TIER_RATIO 4
+#endif
+
+/** The number of threads for each priority level of the ConvolutionWorkerPool.
+*
+*	The pool has three priority levels, so the default creates three threads that render the tail tiers
+*	of all convolution effects in the process.
+*/
+#ifndef HISE_NUM_CONVOLUTION_WORKER_THREADS
+#define HISE_NUM_CONVOLUTION_WORKER_THREADS 1
+#endif
+
+/** The FFT transformed partitions of an impulse response.
+*	@ingroup dsp
+*
+*	The impulse response is split into a head with the smallest block size and a number of tiers
+*	with increasing block sizes. A tier with the block size B starts at 2 * B, so there's always
+*	one block of time left to calculate its result in the background.
+*
+*	The spectra are immutable after creation, so they can be shared between all convolvers that
+*	use the same impulse response (see ImpulseResponseSpectraCache).
+*/
+class ImpulseResponseSpectra : public ReferenceCountedObject
+{
+public:
+
+	using Ptr = ReferenceCountedObjectPtr<ImpulseResponseSpectra>;
+
+	struct Layout
+	{
+		bool operator==(const Layout& other) const noexcept;
+
+		/** Returns the block size of the given tier. The head is tier 0. */
+		int getBlockSize(int tierIndex) const noexcept;
+
+		/** Returns the position of the first sample of the impulse response that the tier covers. */
+		int getTierOffset(int tierIndex) const noexcept;
+
+		/** The block size of the head. This must be a power of two and should be at least the audio buffer size. */
+		int headSize = 256;
+
+		int numTiers = HISE_CONVOLUTION_NUM_TIERS;
+		int tierRatio = HISE_CONVOLUTION_TIER_RATIO;
+	};
+
+	struct Tier
+	{
+		int blockSize;
+		int offset;
+
+		OwnedArray<fftconvolver::SplitComplex> segments;
+	};
+
+	/** Transforms the impulse response. This is rather expensive, so don't call it on the audio thread. */
+	ImpulseResponseSpectra(const Layout& layout, audiofft::ImplementationType fftType, const float* ir, int numSamples);
+
+	int getNumTiers() const noexcept { return tiers.size(); }
+
+	const Tier& getTier(int tierIndex) const noexcept { return *tiers[tierIndex]; }
+
+	const Layout& getLayout() const noexcept { return layout; }
+
+	audiofft::ImplementationType getFFTType() const noexcept { return fftType; }
+
+	/** Returns the amount of memory that is used by the spectra. */
+	int64 getNumBytes() const noexcept { return numBytes; }
+
+private:
+
+	const Layout layout;
+	const audiofft::ImplementationType fftType;
+
+	OwnedArray<Tier> tiers;
+	int64 numBytes = 0;
+
+	JUCE_DECLARE_NON_COPYABLE(ImpulseResponseSpectra);
+};
+
+/** A process wide cache for the transformed impulse responses.
+*
+*	Use this with a SharedResourcePointer. If multiple convolution effects load the same impulse response
+*	from the audio file pool, they will share the same spectra instead of storing and calculating them again.
+*	Entries that are not used by any convolver anymore are removed with releaseUnusedSpectra().
+*/
+class ImpulseResponseSpectraCache
+{
+public:
+
+	/** Identifies the spectra of one channel of a processed impulse response. */
+	struct Key
+	{
+		bool operator==(const Key& other) const noexcept;
+
+		/** Creates a hash of the sample data so that a reloaded pool entry doesn't reuse old spectra. */
+		static int64 createContentHash(const float* data, int numSamples) noexcept;
+
+		int64 poolHash = 0;
+		int64 contentHash = 0;
+		Range<int> range;
+		int channelIndex = 0;
+		double sampleRate = 0.0;
+		float damping = 1.0f;
+		double cutoffFrequency = 20000.0;
+		ImpulseResponseSpectra::Layout layout;
+		audiofft::ImplementationType fftType = audiofft::ImplementationType::BestAvailable;
+	};
+
+	struct Statistics
+	{
+		/** Creates a human readable summary. */
+		String toString() const;
+
+		int numEntries = 0;
+		int64 numBytes = 0;
+		int numHits = 0;
+		int numMisses = 0;
+	};
+
+	ImpulseResponseSpectraCache() {};
+
+	/** Returns the spectra for the key or nullptr if they are not in the cache. */
+	ImpulseResponseSpectra::Ptr getSpectra(const Key& key);
+
+	/** Creates the spectra from the processed impulse response and adds them to the cache.
+	*
+	*	If another thread has added spectra with the same key in the meantime, these will be returned instead.
+	*/
+	ImpulseResponseSpectra::Ptr createSpectra(const Key& key, const float* ir, int numSamples);
+
+	/** Removes all spectra that are not used by a convolver anymore. */
+	void releaseUnusedSpectra();
+
+	Statistics getStatistics() const;
+
+private:
+
+	struct Entry
+	{
+		Key key;
+		ImpulseResponseSpectra::Ptr spectra;
+	};
+
+	CriticalSection lock;
+	Array<Entry> entries;
+
+	int numHits = 0;
+	int numMisses = 0;
+
+	JUCE_DECLARE_NON_COPYABLE(ImpulseResponseSpectraCache);
+};
+
+/** A pool of worker threads that is shared by all convolution effects in the process.
+*
+*	Use this with a SharedResourcePointer. The audio thread adds a Job when a tail block is complete and
+*	calls finishJob() when it needs the result. If no worker has picked up the job until then, it will be
+*	rendered on the audio thread, so a busy pool never leads to a dropout in the convolution output.
+*
+*	Every job has a priority level with its own queue and threads. The threads of the less urgent levels
+*	run with a lower thread priority, so the big tail partitions that have a lot of time until their deadline
+*	don't delay the small ones. An idle worker also helps out with the jobs of the more urgent levels.
+*/
+class ConvolutionWorkerPool
+{
+public:
+
+	enum
+	{
+		NumPriorityLevels = 3
+	};
+
+	struct Job
+	{
+		enum State
+		{
+			Idle = 0,
+			Queued,
+			Running,
+			Finished
+		};
+
+		Job() : state(Idle) {};
+		virtual ~Job() {};
+
+		/** Overwrite this and render the job. */
+		virtual void run() = 0;
+
+		std::atomic<int> state;
+
+		/** The priority level from 0 (most urgent) to NumPriorityLevels - 1. */
+		int priority = 0;
+
+	private:
+
+		friend class ConvolutionWorkerPool;
+
+		/** Signaled by the worker when the job is finished. */
+		WaitableEvent finishEvent;
+	};
+
+	/** The result of finishJob(). */
+	enum class Deadline
+	{
+		Met,				///< the job was finished by a worker (or was not queued at all)
+		Waited,				///< the worker was still rendering the job, so the calling thread had to wait
+		Missed				///< no worker has picked up the job, so it was rendered on the calling thread
+	};
+
+	ConvolutionWorkerPool(int numThreadsPerLevel=HISE_NUM_CONVOLUTION_WORKER_THREADS);
+	~ConvolutionWorkerPool();
+
+	/** Adds the job to the queue and wakes up an idle worker.
+	*
+	*	This doesn't allocate and can be called from the audio thread. If the queue is full (or there are no
+	*	worker threads), it renders the job on the calling thread.
+	*/
+	void addJob(Job* job);
+
+	/** Makes sure that the job is finished when this returns.
+	*
+	*	If the job is still in the queue, it will be rendered on the calling thread, otherwise it waits
+	*	for the worker thread to finish it. The wait only spins for a short time and then blocks, so that
+	*	a worker with a lower thread priority can finish the job on the same CPU core.
+	*/
+	static Deadline finishJob(Job* job);
+
+	/** Removes the job from the queue and waits until it's not running anymore. Call this before you delete a job. */
+	void removeJob(Job* job);
+
+	int getNumThreads() const noexcept { return workers.size(); }
+
+private:
+
+	enum
+	{
+		QueueSize = 256,
+		NumSpinsBeforeWait = 256
+	};
+
+	class Worker : public Thread
+	{
+	public:
+
+		Worker(ConvolutionWorkerPool& parent_, int priorityLevel_);
+
+		void run() override;
+
+		const int priorityLevel;
+		std::atomic<bool> idle;
+
+	private:
+
+		ConvolutionWorkerPool& parent;
+	};
+
+	struct Queue
+	{
+		Job* jobs[QueueSize];
+		int readIndex = 0;
+		int numQueued = 0;
+	};
+
+	static void runJob(Job* job);
+
+	/** Waits until the job is not running anymore. */
+	static void waitForRunningJob(Job* job);
+
+	/** Returns the most urgent job up to the given priority level and sets it to running. */
+	Job* popJob(int maxPriorityLevel);
+
+	SpinLock queueLock;
+	Queue queues[NumPriorityLevels];
+
+	OwnedArray<Worker> workers;
+
+	JUCE_DECLARE_NON_COPYABLE(ConvolutionWorkerPool);
+};
+
+/** A zero latency convolution engine with non-uniform partitions.
+*	@ingroup dsp
+*
+*	The head of the impulse response is rendered directly on the audio thread with a small block size,
+*	the tiers with the bigger block sizes are rendered by the ConvolutionWorkerPool (or synchronously if
+*	the background thread is disabled). The transformed impulse response is not owned by the convolver,
+*	so multiple convolvers can use the same ImpulseResponseSpectra.
+*
+*	The bigger tiers have a lower priority level in the worker pool. Every tail block has a deadline (the
+*	next block boundary of its tier) and the convolver counts the blocks that were not finished in time,
+*	so you can check with getStatistics() whether the background rendering keeps up.
+*/
+class NonUniformConvolver
+{
+public:
+
+	struct Statistics
+	{
+		/** Creates a summary like "2400 tail blocks, 3 late, 1 missed (max. 0.4ms)". */
+		String toString() const;
+
+		/** Adds the numbers of another convolver (eg. the one for the other channel). */
+		void merge(const Statistics& other) noexcept;
+
+		/** Returns the number of blocks that were not finished by a worker in time. */
+		int64 getNumMissedDeadlines() const noexcept { return numLateJobs + numMissedJobs; }
+
+		/** The number of tail blocks that were rendered by the worker pool. */
+		int64 numJobs = 0;
+
+		/** The number of blocks where the audio thread had to wait for the worker. */
+		int64 numLateJobs = 0;
+
+		/** The number of blocks that were rendered on the audio thread because no worker picked them up. */
+		int64 numMissedJobs = 0;
+
+		/** The longest time in milliseconds that the audio thread has spent with a late or missed block. */
+		double maxDelayMs = 0.0;
+	};
+
+	NonUniformConvolver(audiofft::ImplementationType fftType_);
+	~NonUniformConvolver();
+
+	/** Sets the impulse response and allocates the buffers. Pass in nullptr to clear the impulse response. */
+	void setImpulseResponse(ImpulseResponseSpectra::Ptr newSpectra);
+
+	ImpulseResponseSpectra::Ptr getImpulseResponse() const noexcept { return spectra; }
+
+	/** Convolves the input and writes the result to the output (the arrays may not overlap). */
+	void process(const float* input, float* output, int numSamples);
+
+	/** Removes the impulse response and the buffers. */
+	void reset();
+
+	/** Clears the internal buffers so that it resets the convolution pipeline. */
+	void cleanPipeline();
+
+	void setUseBackgroundThread(bool shouldBeUsingBackgroundThread) noexcept { useBackgroundThread = shouldBeUsingBackgroundThread; }
+
+	bool isUsingBackgroundThread() const noexcept { return useBackgroundThread; }
+
+	audiofft::ImplementationType getFFTType() const noexcept { return fftType; }
+
+	Statistics getStatistics() const noexcept;
+
+	void resetStatistics() noexcept;
+
+private:
+
+	struct Stage;
+	struct TailTier;
+
+	/** Waits for the job of the tier and updates the deadline statistics. */
+	void finishJob(TailTier* t);
+
+	const audiofft::ImplementationType fftType;
+
+	SharedResourcePointer<ConvolutionWorkerPool> pool;
+
+	ImpulseResponseSpectra::Ptr spectra;
+
+	ScopedPointer<Stage> head;
+	OwnedArray<TailTier> tailTiers;
+
+	bool useBackgroundThread = false;
+
+	std::atomic<int64> numJobs;
+	std::atomic<int64> numLateJobs;
+	std::atomic<int64> numMissedJobs;
+	std::atomic<double> maxDelayMs;
+
+	JUCE_DECLARE_NON_COPYABLE(NonUniformConvolver);
+};
+
+} // namespace hise
+
+#endif  // PARTITIONEDCONVOLVER_H_INCLUDED
@@ -0,0 +1,255 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+
+#include "AppConfig.h"
+
+#if HI_RUN_UNIT_TESTS
+
+#include  "JuceHeader.h"
+
+using namespace hise;
+
+/** Compares the NonUniformConvolver against a direct convolution for different partition layouts and 
+*	buffer sizes and checks that a mono impulse response shares its spectra in the ImpulseResponseSpectraCache. */
+class PartitionedConvolverUnitTests : public UnitTest
+{
+public:
+
+	PartitionedConvolverUnitTests() :
+		UnitTest("Testing non-uniform partitioned convolution")
+	{}
+
+	void runTest() override
+	{
+		for (int i = 0; i < 2; i++)
+		{
+			const bool useBackgroundThread = i == 1;
+
+			testLayout(64, 1, 4, useBackgroundThread);
+			testLayout(64, 3, 4, useBackgroundThread);
+			testLayout(128, 2, 4, useBackgroundThread);
+			testLayout(256, 2, 2, useBackgroundThread);
+			testLayout(32, 4, 2, useBackgroundThread);
+		}
+
+		testSpectraCache();
+	}
+
+private:
+
+	void fillImpulseResponse(HeapBlock<float>& ir, int numSamples)
+	{
+		ir.calloc(numSamples);
+
+		// A decaying noise burst, so that the tail tiers don't dominate the output
+		for (int i = 0; i < numSamples; i++)
+			ir[i] = (r.nextFloat() * 2.0f - 1.0f) * std::exp(-4.0f * (float)i / (float)numSamples);
+	}
+
+	void fillInput(HeapBlock<float>& input, int numSamples)
+	{
+		input.calloc(numSamples);
+
+		for (int i = 0; i < numSamples; i++)
+			input[i] = r.nextFloat() - 0.5f;
+	}
+
+	void convolveDirectly(const float* input, int numInputSamples, const float* ir, int irLength, HeapBlock<float>& output)
+	{
+		output.calloc(numInputSamples);
+
+		for (int i = 0; i < numInputSamples; i++)
+		{
+			double sum = 0.0;
+
+			for (int j = 0; j <= jmin<int>(i, irLength - 1); j++)
+				sum += (double)ir[j] * (double)input[i - j];
+
+			output[i] = (float)sum;
+		}
+	}
+
+	/** Processes the input with a few odd buffer sizes (some of them bigger than the head) and checks the result. */
+	void processAndCompare(NonUniformConvolver& convolver, const float* input, const float* expected, int numSamples)
+	{
+		static const int bufferSizes[] = { 1, 17, 63, 128, 255, 511, 7, 300 };
+
+		HeapBlock<float> output;
+		output.calloc(numSamples);
+
+		int pos = 0;
+		int bufferIndex = 0;
+
+		while (pos < numSamples)
+		{
+			const int numThisTime = jmin<int>(numSamples - pos, bufferSizes[bufferIndex++ % numElementsInArray(bufferSizes)]);
+			convolver.process(input + pos, output + pos, numThisTime);
+			pos += numThisTime;
+		}
+
+		float peak = 0.0f;
+		float maxError = 0.0f;
+
+		for (int i = 0; i < numSamples; i++)
+		{
+			peak = jmax<float>(peak, std::abs(expected[i]));
+			maxError = jmax<float>(maxError, std::abs(expected[i] - output[i]));
+		}
+
+		expect(peak > 0.0f, "Silent reference");
+		expect(maxError <= 0.0001f * jmax<float>(1.0f, peak), "Max error: " + String(maxError) + ", peak: " + String(peak));
+	}
+
+	void testLayout(int headSize, int numTiers, int tierRatio, bool useBackgroundThread)
+	{
+		beginTest("Testing head size " + String(headSize) + ", " + String(numTiers) + " tiers with ratio " + String(tierRatio) +
+			      (useBackgroundThread ? " (background thread)" : ""));
+
+		ImpulseResponseSpectra::Layout layout;
+		layout.headSize = headSize;
+		layout.numTiers = numTiers;
+		layout.tierRatio = tierRatio;
+
+		// Make sure that the last tier has a few segments and the length is not a multiple of the block size
+		const int irLength = layout.getTierOffset(numTiers) + 3 * layout.getBlockSize(numTiers) + 17;
+		const int numSamples = irLength + 2 * layout.getBlockSize(numTiers);
+
+		HeapBlock<float> ir, input, expected;
+
+		fillImpulseResponse(ir, irLength);
+		fillInput(input, numSamples);
+		convolveDirectly(input, numSamples, ir, irLength, expected);
+
+		ImpulseResponseSpectra::Ptr spectra = new ImpulseResponseSpectra(layout, audiofft::ImplementationType::BestAvailable, ir, irLength);
+
+		expectEquals(spectra->getNumTiers(), numTiers + 1, "Tier amount");
+
+		NonUniformConvolver convolver(audiofft::ImplementationType::BestAvailable);
+		convolver.setUseBackgroundThread(useBackgroundThread);
+		convolver.setImpulseResponse(spectra);
+
+		processAndCompare(convolver, input, expected, numSamples);
+
+		if (useBackgroundThread)
+			expect(convolver.getStatistics().numJobs > 0, "No tail blocks were rendered in the background");
+
+		// The second run must not contain anything from the first run
+		convolver.cleanPipeline();
+		processAndCompare(convolver, input, expected, numSamples);
+	}
+
+	void testSpectraCache()
+	{
+		beginTest("Testing the spectra cache with a mono impulse response");
+
+		ImpulseResponseSpectraCache cache;
+
+		ImpulseResponseSpectra::Layout layout;
+		layout.headSize = 64;
+		layout.numTiers = 2;
+
+		const int irLength = 5000;
+		const int numSamples = 6000;
+
+		HeapBlock<float> ir, input, expected;
+
+		fillImpulseResponse(ir, irLength);
+		fillInput(input, numSamples);
+		convolveDirectly(input, numSamples, ir, irLength, expected);
+
+		// A mono impulse response uses the first channel for both keys (just like the ConvolutionEffect)
+		ImpulseResponseSpectraCache::Key keys[2];
+
+		for (auto& k : keys)
+		{
+			k.poolHash = String("{PROJECT_FOLDER}mono.wav").hashCode64();
+			k.channelIndex = 0;
+			k.contentHash = ImpulseResponseSpectraCache::Key::createContentHash(ir, irLength);
+			k.range = { 0, irLength };
+			k.sampleRate = 44100.0;
+			k.layout = layout;
+		}
+
+		expect(cache.getSpectra(keys[0]) == nullptr, "Empty cache returns spectra");
+
+		auto spectraL = cache.createSpectra(keys[0], ir, irLength);
+		auto spectraR = cache.getSpectra(keys[1]);
+
+		expect(spectraL != nullptr, "No spectra created");
+		expect(spectraL == spectraR, "Mono impulse response doesn't share the spectra");
+
+		// Another effect that loads the same impulse response
+		expect(cache.getSpectra(keys[0]) == spectraL, "Second effect doesn't use the cached spectra");
+
+		auto stats = cache.getStatistics();
+
+		expectEquals(stats.numEntries, 1, "Entry amount");
+		expectEquals(stats.numMisses, 1, "Misses");
+		expectEquals(stats.numHits, 2, "Hits");
+
+		auto stereoKey = keys[1];
+		stereoKey.channelIndex = 1;
+		expect(cache.getSpectra(stereoKey) == nullptr, "The second channel of a stereo file uses the mono spectra");
+
+		auto changedKey = keys[0];
+		changedKey.contentHash++;
+		expect(cache.getSpectra(changedKey) == nullptr, "A changed file uses the old spectra");
+
+		{
+			NonUniformConvolver convolverL(audiofft::ImplementationType::BestAvailable);
+			NonUniformConvolver convolverR(audiofft::ImplementationType::BestAvailable);
+
+			convolverL.setImpulseResponse(spectraL);
+			convolverR.setImpulseResponse(spectraR);
+			convolverR.setUseBackgroundThread(true);
+
+			processAndCompare(convolverL, input, expected, numSamples);
+			processAndCompare(convolverR, input, expected, numSamples);
+
+			spectraL = nullptr;
+			spectraR = nullptr;
+
+			cache.releaseUnusedSpectra();
+			expectEquals(cache.getStatistics().numEntries, 1, "Spectra were released while in use");
+		}
+
+		cache.releaseUnusedSpectra();
+		expectEquals(cache.getStatistics().numEntries, 0, "Unused spectra were not released");
+	}
+
+	Random r;
+};
+
+static PartitionedConvolverUnitTests partitionedConvolverUnitTests;
+
+#endif
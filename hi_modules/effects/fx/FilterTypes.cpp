@@ -33,6 +33,35 @@
 namespace hise {
 using namespace juce;
 
+const FilterCoefficientTable& FilterCoefficientTable::getInstance()
+{
+	static const FilterCoefficientTable table;
+	return table;
+}
+
+FilterCoefficientTable::FilterCoefficientTable()
+{
+	for (int i = 0; i < TableSize; i++)
+		data[i] = std::tan(double_Pi * (double)i / indexScale);
+
+	// Check the error in the middle of each segment and stop at the first one that
+	// isn't accurate enough (the error only grows towards nyquist).
+	int numAccurateSegments = 0;
+
+	for (int i = 0; i < TableSize - 2; i++)
+	{
+		const double exact = std::tan(double_Pi * ((double)i + 0.5) / indexScale);
+		const double interpolated = 0.5 * (data[i] + data[i + 1]);
+
+		if (exact > 0.0 && std::abs(interpolated - exact) / exact > HISE_FILTER_COEFFICIENT_TABLE_ACCURACY)
+			break;
+
+		numAccurateSegments = i + 1;
+	}
+
+	limit = (double)numAccurateSegments;
+}
+
 
 hise::MoogFilterSubType::MoogFilterSubType()
 {
@@ -170,6 +199,85 @@ void StaticBiquadSubType::reset(int numNewChannels)
 	}
 }
 
+IIRCoefficients StaticBiquadSubType::makeLowPass(double t, double q)
+{
+	const double n = 1.0 / t;
+	const double nSquared = n * n;
+	const double c1 = 1.0 / (1.0 + 1.0 / q * n + nSquared);
+
+	return IIRCoefficients(c1,
+		c1 * 2.0,
+		c1,
+		1.0,
+		c1 * 2.0 * (1.0 - nSquared),
+		c1 * (1.0 - 1.0 / q * n + nSquared));
+}
+
+IIRCoefficients StaticBiquadSubType::makeHighPass(double t, double q)
+{
+	const double n = t;
+	const double nSquared = n * n;
+	const double c1 = 1.0 / (1.0 + 1.0 / q * n + nSquared);
+
+	return IIRCoefficients(c1,
+		c1 * -2.0,
+		c1,
+		1.0,
+		c1 * 2.0 * (nSquared - 1.0),
+		c1 * (1.0 - 1.0 / q * n + nSquared));
+}
+
+IIRCoefficients StaticBiquadSubType::makeShelf(double t, double q, float gain, bool isHighShelf)
+{
+	// sin and cos of omega = 2 * pi * f / sampleRate from the half angle tangent
+	const double tSquared = t * t;
+	const double sino = 2.0 * t / (1.0 + tSquared);
+	const double coso = (1.0 - tSquared) / (1.0 + tSquared);
+
+	const double A = jmax(0.0f, std::sqrt(gain));
+	const double aminus1 = A - 1.0;
+	const double aplus1 = A + 1.0;
+	const double beta = sino * std::sqrt(A) / q;
+	const double aminus1TimesCoso = aminus1 * coso;
+
+	if (isHighShelf)
+	{
+		return IIRCoefficients(A * (aplus1 + aminus1TimesCoso + beta),
+			A * -2.0 * (aminus1 + aplus1 * coso),
+			A * (aplus1 + aminus1TimesCoso - beta),
+			aplus1 - aminus1TimesCoso + beta,
+			2.0 * (aminus1 - aplus1 * coso),
+			aplus1 - aminus1TimesCoso - beta);
+	}
+
+	return IIRCoefficients(A * (aplus1 - aminus1TimesCoso + beta),
+		A * 2.0 * (aminus1 - aplus1 * coso),
+		A * (aplus1 - aminus1TimesCoso - beta),
+		aplus1 + aminus1TimesCoso + beta,
+		-2.0 * (aminus1 + aplus1 * coso),
+		aplus1 + aminus1TimesCoso - beta);
+}
+
+IIRCoefficients StaticBiquadSubType::makePeak(double t, double q, float gain)
+{
+	const double tSquared = t * t;
+	const double sino = 2.0 * t / (1.0 + tSquared);
+	const double coso = (1.0 - tSquared) / (1.0 + tSquared);
+
+	const double A = jmax(0.0f, std::sqrt(gain));
+	const double alpha = 0.5 * sino / q;
+	const double c2 = -2.0 * coso;
+	const double alphaTimesA = alpha * A;
+	const double alphaOverA = alpha / A;
+
+	return IIRCoefficients(1.0 + alphaTimesA,
+		c2,
+		1.0 - alphaTimesA,
+		1.0 + alphaOverA,
+		c2,
+		1.0 - alphaOverA);
+}
+
 void StaticBiquadSubType::processSamples(AudioSampleBuffer& b, int startSample, int numSamples)
 {
 	int channelAmount = b.getNumChannels();
@@ -235,13 +343,33 @@ float PhaseAllpassSubType::InternalFilter::getNextSample(float input)
 
 void LadderSubType::processSamples(AudioSampleBuffer& b, int startSample, int numSamples)
 {
+	const float r = res;
+	const float c_ = cut;
+
 	for (int c = 0; c < b.getNumChannels(); c++)
 	{
+		float* d = b.getWritePointer(c, startSample);
+
+		// Keep the state in registers for the inner loop
+		float b0 = buf[c][0];
+		float b1 = buf[c][1];
+		float b2 = buf[c][2];
+		float b3 = buf[c][3];
+
 		for (int i = 0; i < numSamples; i++)
 		{
-			float* d = b.getWritePointer(c, i + startSample);
-			*d = processSample(*d, c);
+			const float in = d[i] - (b3 * r);
+			b0 = ((in - b0) * c_) + b0;
+			b1 = ((b0 - b1) * c_) + b1;
+			b2 = ((b1 - b2) * c_) + b2;
+			b3 = ((b2 - b3) * c_) + b3;
+			d[i] = 2.0f * b3;
 		}
+
+		buf[c][0] = b0;
+		buf[c][1] = b1;
+		buf[c][2] = b2;
+		buf[c][3] = b3;
 	}
 }
 
@@ -275,15 +403,10 @@ void StateVariableFilterSubType::updateCoefficients(double sampleRate, double fr
 
 	if (type == FilterType::ALLPASS)
 	{
-		// prewarp the cutoff (for bilinear-transform filters)
-		float wd = static_cast<float>(frequency * 2.0f * float_Pi);
-		float T = 1.0f / (float)sampleRate;
-		float wa = (2.0f / T) * tan(wd * T / 2.0f);
+		// prewarp the cutoff (for bilinear-transform filters) and calculate g (gain element of integrator)
+		gCoeff = (float)FilterCoefficientTable::getInstance().getPrewarpedCutoff(frequency, sampleRate);
 
-		// Calculate g (gain element of integrator)
-		gCoeff = wa * T / 2.0f;			// Calculate g (gain element of integrator)
-
-										// Calculate Zavalishin's R from Q (referred to as damping parameter)
+		// Calculate Zavalishin's R from Q (referred to as damping parameter)
 		RCoeff = 1.0f / (2.0f * (float)q);
 
 		x1 = (2.0f * RCoeff + gCoeff);
@@ -291,7 +414,7 @@ void StateVariableFilterSubType::updateCoefficients(double sampleRate, double fr
 	}
 	else
 	{
-		float g = (float)tan(double_Pi * frequency / sampleRate);
+		float g = (float)FilterCoefficientTable::getInstance().getPrewarpedCutoff(frequency, sampleRate);
 		//float damping = 1.0f / res;
 		//k = damping;
 		k = 1.0f - 0.99f * scaledQ;
@@ -303,6 +426,38 @@ void StateVariableFilterSubType::updateCoefficients(double sampleRate, double fr
 	}
 }
 
+template <int Mode> void StateVariableFilterSubType::processChannel(float* d, int c, int numSamples)
+{
+	// Keep the state in registers for the inner loop, the filter is updated every few samples
+	// with sample accurate modulation so the loop overhead matters
+	float s0 = v0z[c];
+	float s1 = z1_A[c];
+	float s2 = v2[c];
+
+	for (int i = 0; i < numSamples; i++)
+	{
+		const float v0 = d[i];
+		const float v3 = v0 + s0 - 2.0f * s2;
+		const float v1z = s1;
+		s1 += g1 * v3 - g2 * v1z;
+		s2 += g3 * v3 + g4 * v1z;
+		s0 = v0;
+
+		switch (Mode)
+		{
+		case LP:	d[i] = s2; break;
+		case BP:	d[i] = s1; break;
+		case HP:	d[i] = v0 - k * s1 - s2; break;
+		case NOTCH: d[i] = v0 - k * s1; break;
+		default:	break;
+		}
+	}
+
+	v0z[c] = s0;
+	z1_A[c] = s1;
+	v2[c] = s2;
+}
+
 void StateVariableFilterSubType::processSamples(AudioSampleBuffer& buffer, int startSample, int numSamples)
 {
 	auto numChannels = buffer.getNumChannels();
@@ -312,64 +467,21 @@ void StateVariableFilterSubType::processSamples(AudioSampleBuffer& buffer, int s
 	case LP:
 	{
 		for (int c = 0; c < numChannels; c++)
-		{
-			float* d = buffer.getWritePointer(c, startSample);
-
-			for (int i = 0; i < numSamples; i++)
-			{
-				float v0 = d[i];
-				float v1z = z1_A[c];
-				float v2z = v2[c];
-				float v3 = v0 + v0z[c] - 2.0f * v2z;
-				z1_A[c] += g1 * v3 - g2 * v1z;
-				v2[c] += g3 * v3 + g4 * v1z;
-				v0z[c] = v0;
-				d[i] = v2[c];
-			}
-		}
+			processChannel<LP>(buffer.getWritePointer(c, startSample), c, numSamples);
 
 		break;
 	}
 	case BP:
 	{
 		for (int c = 0; c < numChannels; c++)
-		{
-			float* d = buffer.getWritePointer(c, startSample);
-
-			for (int i = 0; i < numSamples; i++)
-			{
-				float v0 = d[i];
-				float v1z = z1_A[c];
-				float v2z = v2[c];
-				float v3 = v0 + v0z[c] - 2.0f * v2z;
-				z1_A[c] += g1 * v3 - g2 * v1z;
-				v2[c] += g3 * v3 + g4 * v1z;
-				v0z[c] = v0;
-				d[i] = z1_A[c];
-			}
-		}
+			processChannel<BP>(buffer.getWritePointer(c, startSample), c, numSamples);
 
 		break;
 	}
-
 	case HP:
 	{
 		for (int c = 0; c < numChannels; c++)
-		{
-			float* d = buffer.getWritePointer(c, startSample);
-
-			for (int i = 0; i < numSamples; i++)
-			{
-				float v0 = d[i];
-				float v1z = z1_A[c];
-				float v2z = v2[c];
-				float v3 = v0 + v0z[c] - 2.0f * v2z;
-				z1_A[c] += g1 * v3 - g2 * v1z;
-				v2[c] += g3 * v3 + g4 * v1z;
-				v0z[c] = v0;
-				d[i] = v0 - k * z1_A[c] - v2[c];
-			}
-		}
+			processChannel<HP>(buffer.getWritePointer(c, startSample), c, numSamples);
 
 		break;
 	}
@@ -399,21 +511,7 @@ void StateVariableFilterSubType::processSamples(AudioSampleBuffer& buffer, int s
 	case NOTCH:
 	{
 		for (int c = 0; c < numChannels; c++)
-		{
-			float* d = buffer.getWritePointer(c, startSample);
-
-			for (int i = 0; i < numSamples; i++)
-			{
-				float v0 = d[i];
-				float v1z = z1_A[c];
-				float v2z = v2[c];
-				float v3 = v0 + v0z[c] - 2.0f * v2z;
-				z1_A[c] += g1 * v3 - g2 * v1z;
-				v2[c] += g3 * v3 + g4 * v1z;
-				v0z[c] = v0;
-				d[i] = v0 - k * z1_A[c];
-			}
-		}
+			processChannel<NOTCH>(buffer.getWritePointer(c, startSample), c, numSamples);
 
 		break;
 	}
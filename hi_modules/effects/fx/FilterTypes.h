@@ -40,6 +40,15 @@ using namespace juce;
 #define MIN_FILTER_FREQ 20.0
 #endif
 
+/** The interval in samples at which a filter with dynamic modulation data recalculates its coefficients.
+*
+*	Must be a multiple of HISE_CONTROL_RATE_DOWNSAMPLING_FACTOR. Smaller values make fast filter envelopes
+*	smoother but will call the coefficient calculation more often.
+*/
+#ifndef HISE_FILTER_SUBBLOCK_SIZE
+#define HISE_FILTER_SUBBLOCK_SIZE 16
+#endif
+
 #define SET_FILTER_TYPE(x) static FilterHelpers::FilterSubType getFilterType() { return x; };
 
     
@@ -83,6 +92,73 @@ using namespace juce;
             return limit(FilterLimitValues::lowGain, FilterLimitValues::highGain, gain);
         }
     };
+
+/** Set this to 0 to calculate the filter coefficients with the exact trigonometric functions. */
+#ifndef HISE_USE_FILTER_COEFFICIENT_TABLE
+#define HISE_USE_FILTER_COEFFICIENT_TABLE 1
+#endif
+
+/** The number of table points between 0 and the nyquist frequency. */
+#ifndef HISE_FILTER_COEFFICIENT_TABLE_SIZE
+#define HISE_FILTER_COEFFICIENT_TABLE_SIZE 2048
+#endif
+
+/** The maximum relative error of the interpolated table values. Above the frequency where this is exceeded, the exact function is used. */
+#ifndef HISE_FILTER_COEFFICIENT_TABLE_ACCURACY
+#define HISE_FILTER_COEFFICIENT_TABLE_ACCURACY 1e-5
+#endif
+
+/** A lookup table for the prewarped cutoff tan(pi * frequency / sampleRate).
+*
+*	The coefficient calculations of the state variable filter and the biquad subtypes boil down to this value
+*	(the sin / cos of the shelf and peak filters can be derived from it), so a single interpolated table replaces
+*	the trigonometric calls while the Q and gain are still calculated exactly.
+*
+*	The table is indexed by the normalised frequency, so it can be shared across all filters and samplerates.
+*	When it's created, it checks the interpolation error and the lookup falls back to std::tan() above the
+*	frequency where it exceeds HISE_FILTER_COEFFICIENT_TABLE_ACCURACY (this is only the area close to nyquist).
+*/
+class FilterCoefficientTable
+{
+public:
+
+	/** Returns the shared table. The first call creates the table, so make sure you call this in prepareToPlay. */
+	static const FilterCoefficientTable& getInstance();
+
+	/** Returns tan(pi * frequency / sampleRate). */
+	double getPrewarpedCutoff(double frequency, double sampleRate) const noexcept
+	{
+		const double normalisedFrequency = frequency / sampleRate;
+
+#if HISE_USE_FILTER_COEFFICIENT_TABLE
+		const double pos = normalisedFrequency * indexScale;
+
+		if (pos >= 0.0 && pos < limit)
+		{
+			const int index = (int)pos;
+			const double alpha = pos - (double)index;
+
+			return data[index] + alpha * (data[index + 1] - data[index]);
+		}
+#endif
+
+		return std::tan(double_Pi * normalisedFrequency);
+	}
+
+	/** Returns the highest normalised frequency that will be calculated with the table. */
+	double getMaxNormalisedFrequency() const noexcept { return limit / indexScale; }
+
+private:
+
+	FilterCoefficientTable();
+
+	static constexpr int TableSize = HISE_FILTER_COEFFICIENT_TABLE_SIZE;
+	static constexpr double indexScale = (double)(HISE_FILTER_COEFFICIENT_TABLE_SIZE - 1) * 2.0;
+
+	double data[HISE_FILTER_COEFFICIENT_TABLE_SIZE];
+	double limit = 0.0;
+};
+
     
 
     
@@ -126,6 +202,20 @@ public:
 		double freqModValue = 1.0;
 		double gainModValue = 1.0;
 		double qModValue = 1.0;
+
+		/** Optional control rate modulation values for the whole block (the same offset that
+		*	ModChainWithBuffer::getOneModulationValue() uses). If one of these is set, the filter
+		*	updates its coefficients every HISE_FILTER_SUBBLOCK_SIZE samples and ignores the
+		*	respective constant mod value.
+		*/
+		const float* freqModData = nullptr;
+		const float* gainModData = nullptr;
+		const float* qModData = nullptr;
+
+		bool hasModulationData() const noexcept
+		{
+			return freqModData != nullptr || gainModData != nullptr || qModData != nullptr;
+		}
 	};
 };
 
@@ -168,7 +258,9 @@ public:
 		frequency.reset(newSampleRate / 64.0, 0.03);
 		q.reset(newSampleRate / 64.0, 0.03);
 		gain.reset(newSampleRate / 64.0, 0.03);
-		
+
+		// make sure the table isn't created in the audio callback
+		FilterCoefficientTable::getInstance();
 
 		reset();
 		clearCoefficients();
@@ -208,6 +300,12 @@ public:
 	
 	void render(FilterHelpers::RenderData& r)
 	{
+		if (r.hasModulationData())
+		{
+			renderWithModulationData(r);
+			return;
+		}
+
 		update(r);
 
 		if (numChannels != r.b.getNumChannels())
@@ -247,9 +345,15 @@ private:
 
 	void update(FilterHelpers::RenderData& renderData)
 	{
-		auto thisFreq = FilterLimits::limitFrequency(renderData.freqModValue * frequency.getNextValue());
-		auto thisGain = renderData.gainModValue * gain.getNextValue();
-		auto thisQ = FilterLimits::limitQ(q.getNextValue() * renderData.qModValue);
+		updateWithModValues(frequency.getNextValue(), q.getNextValue(), gain.getNextValue(),
+							renderData.freqModValue, renderData.qModValue, renderData.gainModValue);
+	}
+
+	void updateWithModValues(double baseFreq, double baseQ, double baseGain, double freqMod, double qMod, double gainMod)
+	{
+		auto thisFreq = FilterLimits::limitFrequency(freqMod * baseFreq);
+		auto thisGain = gainMod * baseGain;
+		auto thisQ = FilterLimits::limitQ(baseQ * qMod);
 
 		dirty |= compareAndSet(currentFreq, thisFreq);
 		dirty |= compareAndSet(currentGain, thisGain);
@@ -262,6 +366,46 @@ private:
 		}
 	}
 
+	/** Splits the block into sub blocks on a HISE_FILTER_SUBBLOCK_SIZE raster and updates the coefficients
+	*	with the modulation value at the start of each sub block.
+	*
+	*	The parameter smoothing still advances once per render call so the knob ramps behave the same.
+	*/
+	void renderWithModulationData(FilterHelpers::RenderData& r)
+	{
+		static_assert(HISE_FILTER_SUBBLOCK_SIZE % HISE_CONTROL_RATE_DOWNSAMPLING_FACTOR == 0,
+					  "HISE_FILTER_SUBBLOCK_SIZE must be a multiple of the control rate downsampling factor");
+
+		if (numChannels != r.b.getNumChannels())
+		{
+			setNumChannels(r.b.getNumChannels());
+		}
+
+		const double baseFreq = frequency.getNextValue();
+		const double baseQ = q.getNextValue();
+		const double baseGain = gain.getNextValue();
+
+		int startSample = r.startSample;
+		const int endSample = r.startSample + r.numSamples;
+
+		while (startSample < endSample)
+		{
+			const int numToNextUpdate = HISE_FILTER_SUBBLOCK_SIZE - (startSample % HISE_FILTER_SUBBLOCK_SIZE);
+			const int numThisTime = jmin<int>(numToNextUpdate, endSample - startSample);
+			const int controlRateIndex = startSample / HISE_CONTROL_RATE_DOWNSAMPLING_FACTOR;
+
+			const double freqMod = r.freqModData != nullptr ? (double)r.freqModData[controlRateIndex] : r.freqModValue;
+			const double qMod = r.qModData != nullptr ? (double)r.qModData[controlRateIndex] : r.qModValue;
+			const double gainMod = r.gainModData != nullptr ? (double)r.gainModData[controlRateIndex] : r.gainModValue;
+
+			updateWithModValues(baseFreq, baseQ, baseGain, freqMod, qMod, gainMod);
+
+			FilterSubType::processSamples(r.b, startSample, numThisTime);
+
+			startSample += numThisTime;
+		}
+	}
+
 	bool dirty = false;
 
 	double sampleRate = 44100.0;
@@ -453,6 +597,9 @@ public:
 		numFilterTypes
 	};
 
+	/** Calculates the coefficients with the FilterCoefficientTable. The result matches the IIRCoefficients::makeXXX() functions. */
+	static IIRCoefficients makeCoefficients(FilterType type, double sampleRate, double frequency, double q, double gain);
+
 protected:
 
 	void setType(int newType)
@@ -467,6 +614,12 @@ protected:
 
 private:
 
+	/** The IIRCoefficients::makeXXX() formulas using the prewarped cutoff t = tan(pi * f / sampleRate). */
+	static IIRCoefficients makeLowPass(double t, double q);
+	static IIRCoefficients makeHighPass(double t, double q);
+	static IIRCoefficients makeShelf(double t, double q, float gain, bool isHighShelf);
+	static IIRCoefficients makePeak(double t, double q, float gain);
+
 	int numChannels = NUM_MAX_CHANNELS;
 
 	IIRCoefficients currentCoefficients;
@@ -643,6 +796,8 @@ protected:
 
 private:
 
+	template <int Mode> void processChannel(float* d, int c, int numSamples);
+
 	FilterType type;
 
 	float v0z[NUM_MAX_CHANNELS];
@@ -484,7 +484,9 @@ void PolyFilterEffect::prepareToPlay(double sampleRate, int samplesPerBlock)
 	VoiceEffectProcessor::prepareToPlay(sampleRate, samplesPerBlock);
 
 	voiceFilters.setSampleRate(sampleRate);
-	
+
+	numFreqModValues = samplesPerBlock / HISE_CONTROL_RATE_DOWNSAMPLING_FACTOR + 1;
+	freqModValues.calloc(numFreqModValues);
 }
 
 void PolyFilterEffect::renderNextBlock(AudioSampleBuffer &b, int startSample, int numSamples)
@@ -595,10 +597,44 @@ void PolyFilterEffect::applyEffect(int voiceIndex, AudioSampleBuffer &b, int sta
 	r.gainModValue = (double)modChains[GainChain].getOneModulationValue(startSample);
 	r.qModValue = (double)modChains[ResonanceChain].getOneModulationValue(startSample);
 
+	auto freqData = modChains[FrequencyChain].getControlRateVoiceValues();
+	auto bipolarData = modChains[BipolarFrequencyChain].getControlRateVoiceValues();
+
+	if (freqData != nullptr || bipolarData != nullptr)
+		r.freqModData = calculateFrequencyModValues(freqData, bipolarData, startSample, numSamples);
+
+	r.gainModData = modChains[GainChain].getControlRateVoiceValues();
+	r.qModData = modChains[ResonanceChain].getControlRateVoiceValues();
+
     voiceFilters.setDisplayModValues(voiceIndex, (float)r.freqModValue, (float)r.gainModValue);
 	voiceFilters.renderPoly(r);
 }
 
+const float* PolyFilterEffect::calculateFrequencyModValues(const float* freqData, const float* bipolarData, int startSample, int numSamples)
+{
+	const int startSample_cr = startSample / HISE_CONTROL_RATE_DOWNSAMPLING_FACTOR;
+	const int endSample_cr = (startSample + numSamples - 1) / HISE_CONTROL_RATE_DOWNSAMPLING_FACTOR + 1;
+	const int numSamples_cr = endSample_cr - startSample_cr;
+
+	// The block is bigger than the one from prepareToPlay, so we fall back to the constant value
+	if (endSample_cr > numFreqModValues || numSamples_cr <= 0)
+		return nullptr;
+
+	auto d = freqModValues.get() + startSample_cr;
+
+	if (freqData != nullptr)
+		FloatVectorOperations::copy(d, freqData + startSample_cr, numSamples_cr);
+	else
+		FloatVectorOperations::fill(d, modChains[FrequencyChain].getConstantModulationValue(), numSamples_cr);
+
+	if (bipolarData != nullptr)
+		FloatVectorOperations::addWithMultiply(d, bipolarData + startSample_cr, bipolarIntensity, numSamples_cr);
+	else
+		FloatVectorOperations::add(d, bipolarIntensity * modChains[BipolarFrequencyChain].getConstantModulationValue(), numSamples_cr);
+
+	return freqModValues.get();
+}
+
 void PolyFilterEffect::startVoice(int voiceIndex, int noteNumber)
 {
 	VoiceEffectProcessor::startVoice(voiceIndex, noteNumber);
@@ -617,16 +653,7 @@ void PolyFilterEffect::startVoice(int voiceIndex, int noteNumber)
 
 void StaticBiquadSubType::updateCoefficients(double sampleRate, double frequency, double q, double gain)
 {
-	switch (biquadType)
-	{
-	case LowPass:		currentCoefficients = IIRCoefficients::makeLowPass(sampleRate, frequency); break;
-	case HighPass:		currentCoefficients = IIRCoefficients::makeHighPass(sampleRate, frequency); break;
-	case LowShelf:		currentCoefficients = IIRCoefficients::makeLowShelf(sampleRate, frequency, q, (float)gain); break;
-	case HighShelf:		currentCoefficients = IIRCoefficients::makeHighShelf(sampleRate, frequency, q, (float)gain); break;
-	case Peak:			currentCoefficients = IIRCoefficients::makePeakFilter(sampleRate, frequency, q, (float)gain); break;
-	case ResoLow:		currentCoefficients = FilterEffect::makeResoLowPass(sampleRate, frequency, q); break;
-	default:							jassertfalse; break;
-	}
+	currentCoefficients = makeCoefficients(biquadType, sampleRate, frequency, q, gain);
 
 	for (int i = 0; i < numChannels; i++)
 	{
@@ -634,5 +661,28 @@ void StaticBiquadSubType::updateCoefficients(double sampleRate, double frequency
 	}
 }
 
+IIRCoefficients StaticBiquadSubType::makeCoefficients(FilterType type, double sampleRate, double frequency, double q, double gain)
+{
+	auto& table = FilterCoefficientTable::getInstance();
+
+	const double t = table.getPrewarpedCutoff(frequency, sampleRate);
+
+	// The shelf and peak formulas clip the frequency at 2Hz
+	const double tShelf = frequency < 2.0 ? table.getPrewarpedCutoff(2.0, sampleRate) : t;
+
+	switch (type)
+	{
+	case LowPass:		return makeLowPass(t, 1.0 / std::sqrt(2.0));
+	case HighPass:		return makeHighPass(t, 1.0 / std::sqrt(2.0));
+	case LowShelf:		return makeShelf(tShelf, q, (float)gain, false);
+	case HighShelf:		return makeShelf(tShelf, q, (float)gain, true);
+	case Peak:			return makePeak(tShelf, q, (float)gain);
+	case ResoLow:		return makeLowPass(t, 3.0 * q); // same as FilterEffect::makeResoLowPass()
+	default:			jassertfalse; break;
+	}
+
+	return IIRCoefficients();
+}
+
 
 } // namespace hise
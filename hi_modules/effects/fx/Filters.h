@@ -195,7 +195,11 @@ public:
 
 private:
 
-	
+	/** Combines the control rate values of the frequency chains of the current voice for the sub block coefficient update. */
+	const float* calculateFrequencyModValues(const float* freqData, const float* bipolarData, int startSample, int numSamples);
+
+	HeapBlock<float> freqModValues;
+	int numFreqModValues = 0;
 
 	bool blockIsActive = false;
 	int polyWatchdog = 0;
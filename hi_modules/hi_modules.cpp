@@ -106,6 +106,7 @@ namespace wdl
 #include "effects/fx/Phaser.cpp"
 #include "effects/fx/GainCollector.cpp"
 #include "effects/convolution/AtkConvolution.cpp"
+#include "effects/convolution/PartitionedConvolver.cpp"
 #include "effects/convolution/Convolution.cpp"
 #include "effects/mda/mdaLimiter.cpp"
 #include "effects/mda/mdaDegrade.cpp"
@@ -292,7 +292,11 @@ void AhdsrEnvelope::calculateBlock(int startSample, int numSamples)
 
 	const bool isSustain = static_cast<AhdsrEnvelopeState*>(state)->current_state == AhdsrEnvelopeState::SUSTAIN;
 
-	if (isSustain)
+	if (!isMonophonic && voiceBatch.copyValues(voiceIndex, internalBuffer.getWritePointer(0, startSample), startSample, numSamples))
+	{
+		// The values were already calculated in calculateVoicesBatched()
+	}
+	else if (isSustain)
 	{
 		const float thisSustainValue = sustain * state->modValues[SustainLevelChain];
 		const float lastSustainValue = state->lastSustainValue;
@@ -345,6 +349,86 @@ void AhdsrEnvelope::calculateBlock(int startSample, int numSamples)
 #endif
 }
 
+void AhdsrEnvelope::calculateVoicesBatched(const int* voiceIndexes, int numVoices, int startSample, int numSamples)
+{
+	if (isMonophonic || !voiceBatch.begin(startSample, numSamples))
+		return;
+
+	for (int i = 0; i < numVoices; i++)
+	{
+		auto s = static_cast<AhdsrEnvelopeState*>(states[voiceIndexes[i]]);
+
+		// The sustain stage ramps to the new sustain level in calculateBlock()
+		if (s->current_state == AhdsrEnvelopeState::SUSTAIN)
+			continue;
+
+		updateBatchedVoice(voiceBatch.addVoice(voiceIndexes[i], s->current_value), s);
+	}
+
+	if (voiceBatch.getNumVoices() == 0)
+		return;
+
+	voiceBatch.process([this](int lane, float previousValue)
+	{
+		state = static_cast<AhdsrEnvelopeState*>(states[voiceBatch.getVoiceIndex(lane)]);
+		state->current_value = previousValue;
+
+		const float value = calculateNewValue(voiceBatch.getVoiceIndex(lane));
+
+		updateBatchedVoice(lane, state);
+		return value;
+	});
+
+	for (int i = 0; i < voiceBatch.getNumVoices(); i++)
+		static_cast<AhdsrEnvelopeState*>(states[voiceBatch.getVoiceIndex(i)])->current_value = voiceBatch.getValue(i);
+}
+
+void AhdsrEnvelope::updateBatchedVoice(int lane, const AhdsrEnvelopeState* s)
+{
+	const float lowest = std::numeric_limits<float>::lowest();
+	const float highest = std::numeric_limits<float>::max();
+	const float thisSustain = sustain * s->modValues[SustainLevelChain];
+
+	// The limits for the decay and release stage are a bit higher than the thresholds
+	// in calculateNewValue() so that the state machine will catch the transition.
+	switch (s->current_state)
+	{
+	case AhdsrEnvelopeState::ATTACK:
+		if (attack != 0.0f)
+		{
+			const float target = s->attackLevel > thisSustain ? s->attackLevel : thisSustain;
+			voiceBatch.setRecursion(lane, s->attackBase, s->attackCoef, lowest, target);
+			return;
+		}
+		break;
+	case AhdsrEnvelopeState::DECAY:
+		if (decay != 0.0f)
+		{
+			voiceBatch.setRecursion(lane, s->decayBase, s->decayCoef, thisSustain + 0.002f, highest);
+			return;
+		}
+		break;
+	case AhdsrEnvelopeState::SUSTAIN:
+		voiceBatch.setRecursion(lane, thisSustain, 0.0f, lowest, highest);
+		return;
+	case AhdsrEnvelopeState::RELEASE:
+		if (release != 0.0f)
+		{
+			voiceBatch.setRecursion(lane, s->releaseBase, s->releaseCoef, 0.002f, highest);
+			return;
+		}
+		break;
+	case AhdsrEnvelopeState::IDLE:
+		voiceBatch.setConstant(lane);
+		return;
+	default:
+		break;
+	}
+
+	// The hold and retrigger stages (and zero attack / decay times) are calculated by the state machine
+	voiceBatch.setScalar(lane);
+}
+
 void AhdsrEnvelope::reset(int voiceIndex)
 {
 	if (isMonophonic)
@@ -445,6 +529,8 @@ void AhdsrEnvelope::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
 	EnvelopeModulator::prepareToPlay(sampleRate, samplesPerBlock);
 
+	voiceBatch.prepare(polyManager.getVoiceAmount(), samplesPerBlock);
+
 	for (auto& mb : internalChains)
 		mb.prepareToPlay(sampleRate, samplesPerBlock);
 
@@ -116,6 +116,7 @@ public:
 	void reset(int voiceIndex) override;;
 
 	void calculateBlock(int startSample, int numSamples);;
+	void calculateVoicesBatched(const int* voiceIndexes, int numVoices, int startSample, int numSamples) override;
 
 	void handleHiseEvent(const HiseEvent &e) override;
 	
@@ -237,6 +238,9 @@ private:
 	float calcCoef(float rate, float targetRatio) const;
 
 	float calculateNewValue(int voiceIndex);
+
+	/** Sets the recursion parameters of the voice batch for the current stage of the given state. */
+	void updateBatchedVoice(int lane, const AhdsrEnvelopeState* s);
 	
 	void setAttackCurve(float newValue);
 	void setDecayCurve(float newValue);
@@ -301,6 +301,9 @@ void SimpleEnvelope::calculateBlock(int startSample, int numSamples)
 	else
 		state = static_cast<SimpleEnvelopeState*>(states[voiceIndex]);
 
+	if (!isMonophonic && voiceBatch.copyValues(voiceIndex, internalBuffer.getWritePointer(0, startSample), startSample, numSamples))
+		return;
+
 	if (state->current_state == SimpleEnvelopeState::SUSTAIN)
 	{
 		FloatVectorOperations::fill(internalBuffer.getWritePointer(0, startSample), 1.0f, numSamples);
@@ -327,6 +330,72 @@ void SimpleEnvelope::calculateBlock(int startSample, int numSamples)
 	}
 }
 
+void SimpleEnvelope::calculateVoicesBatched(const int* voiceIndexes, int numVoices, int startSample, int numSamples)
+{
+	if (isMonophonic || !voiceBatch.begin(startSample, numSamples))
+		return;
+
+	for (int i = 0; i < numVoices; i++)
+	{
+		auto s = static_cast<SimpleEnvelopeState*>(states[voiceIndexes[i]]);
+
+		// These stages are just filled with a constant value in calculateBlock()
+		if (s->current_state == SimpleEnvelopeState::SUSTAIN || s->current_state == SimpleEnvelopeState::IDLE)
+			continue;
+
+		updateBatchedVoice(voiceBatch.addVoice(voiceIndexes[i], s->current_value), s);
+	}
+
+	if (voiceBatch.getNumVoices() == 0)
+		return;
+
+	voiceBatch.process([this](int lane, float previousValue)
+	{
+		state = static_cast<SimpleEnvelopeState*>(states[voiceBatch.getVoiceIndex(lane)]);
+		state->current_value = previousValue;
+
+		const float value = linearMode ? calculateNewValue(voiceBatch.getVoiceIndex(lane)) : calculateNewExpValue();
+
+		updateBatchedVoice(lane, state);
+		return value;
+	});
+
+	for (int i = 0; i < voiceBatch.getNumVoices(); i++)
+		static_cast<SimpleEnvelopeState*>(states[voiceBatch.getVoiceIndex(i)])->current_value = voiceBatch.getValue(i);
+}
+
+void SimpleEnvelope::updateBatchedVoice(int lane, const SimpleEnvelopeState* s)
+{
+	const float lowest = std::numeric_limits<float>::lowest();
+	const float highest = std::numeric_limits<float>::max();
+
+	switch (s->current_state)
+	{
+	case SimpleEnvelopeState::ATTACK:
+		if (linearMode)
+			voiceBatch.setRecursion(lane, s->attackDelta, 1.0f, lowest, 1.0f);
+		else
+			voiceBatch.setRecursion(lane, s->expAttackBase, s->expAttackCoef, lowest, 1.0f);
+		break;
+	case SimpleEnvelopeState::RETRIGGER:
+		voiceBatch.setRecursion(lane, -0.005f, 1.0f, 0.0f, highest);
+		break;
+	case SimpleEnvelopeState::RELEASE:
+		if (linearMode)
+			voiceBatch.setRecursion(lane, -release_delta, 1.0f, 0.0f, highest);
+		else
+			voiceBatch.setRecursion(lane, expReleaseBase, expReleaseCoef, 0.0001f, highest);
+		break;
+	case SimpleEnvelopeState::SUSTAIN:
+	case SimpleEnvelopeState::IDLE:
+		voiceBatch.setConstant(lane);
+		break;
+	default:
+		voiceBatch.setScalar(lane);
+		break;
+	}
+}
+
 void SimpleEnvelope::handleHiseEvent(const HiseEvent &m)
 {
 	EnvelopeModulator::handleHiseEvent(m);
@@ -338,6 +407,8 @@ void SimpleEnvelope::handleHiseEvent(const HiseEvent &m)
 void SimpleEnvelope::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
 	EnvelopeModulator::prepareToPlay(sampleRate, samplesPerBlock);
+
+	voiceBatch.prepare(polyManager.getVoiceAmount(), samplesPerBlock);
 	
 	setInternalAttribute(Attack, attack);
 	setInternalAttribute(Release, release);
@@ -105,6 +105,7 @@ public:
 
 	void prepareToPlay(double sampleRate, int samplesPerBlock) override;
 	void calculateBlock(int startSample, int numSamples) override;
+	void calculateVoicesBatched(const int* voiceIndexes, int numVoices, int startSample, int numSamples) override;
 	void handleHiseEvent(const HiseEvent& m) override;
 	
 	ProcessorEditorBody *createEditor(ProcessorEditor *parentEditor)  override;
@@ -157,6 +158,9 @@ private:
 
 	void setAttackRate(float rate, SimpleEnvelopeState* state=nullptr);
 	void setReleaseRate(float rate);
+
+	/** Sets the recursion parameters of the voice batch for the current stage of the given state. */
+	void updateBatchedVoice(int lane, const SimpleEnvelopeState* s);
 	
 	/** @brief returns the envelope value. 
 	
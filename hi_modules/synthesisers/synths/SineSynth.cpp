@@ -126,7 +126,7 @@ void SineSynthVoice::calculateBlock(int startSample, int numSamples)
 	float *leftValues = voiceBuffer.getWritePointer(0, startSample);
 	const auto& sinTable = table.get();
 
-	if (auto voicePitchValues = getOwnerSynth()->getPitchValuesForVoice())
+	if (auto voicePitchValues = getPitchValues())
 	{
 		voicePitchValues += startSample;
 
@@ -168,13 +168,13 @@ void SineSynthVoice::calculateBlock(int startSample, int numSamples)
 		}
 	}
 
-	if (auto modValues = getOwnerSynth()->getVoiceGainValues())
+	if (auto modValues = getGainValues())
 	{
 		FloatVectorOperations::multiply(voiceBuffer.getWritePointer(0, startIndex), modValues + startIndex, samplesToCopy);
 	}
 	else
 	{
-		const float gainValue = getOwnerSynth()->getConstantGainModValue();
+		const float gainValue = getConstantGainValue();
 		FloatVectorOperations::multiply(voiceBuffer.getWritePointer(0, startIndex), gainValue, samplesToCopy);
 	}
 		
@@ -158,6 +158,9 @@ public:
 
 	SineSynth(MainController *mc, const String &id, int numVoices);;
 
+	/** The sine voices only read the lookup table and their own state, so they can be rendered on multiple threads. */
+	bool canRenderVoicesInParallel() const override { return true; }
+
 	void restoreFromValueTree(const ValueTree &v) override
 	{
 		ModulatorSynth::restoreFromValueTree(v);
@@ -64,6 +64,19 @@ WavetableSynth::WavetableSynth(MainController *mc, const String &id, int numVoic
 	{
 		pack->setValue(i, 1.0f, dontSendNotification);
 	}
+
+	FloatVectorOperations::fill(cachedGainValues, 1.0f, 128);
+	numCachedGainValues = 128;
+}
+
+void WavetableSynth::preVoiceRendering(int startSample, int numThisTime)
+{
+	ModulatorSynth::preVoiceRendering(startSample, numThisTime);
+
+	numCachedGainValues = jlimit<int>(1, 128, pack->getNumSliders());
+
+	for (int i = 0; i < numCachedGainValues; i++)
+		cachedGainValues[i] = pack->getValue(i);
 }
 
 void WavetableSynth::getWaveformTableValues(int /*displayIndex*/, float const** tableValues, int& numValues, float& normalizeValue)
@@ -127,27 +140,31 @@ void WavetableSynthVoice::calculateBlock(int startSample, int numSamples)
 	const int samplesToCopy = numSamples;
 
 	const float *voicePitchValues = getOwnerSynth()->getPitchValuesForVoice();
-		
-	if (auto tableValues = getTableModulationValues())
-	{
-		while (--numSamples >= 0)
-		{
-			// Get the two indexes for the table position
 
-			int index = (int)voiceUptime;
+	// Pick the band-limited table for the highest pitch in this block
+	const double maxPitchFactor = voicePitchValues != nullptr ? (double)FloatVectorOperations::findMaximum(voicePitchValues + startSample, numSamples) : 1.0;
+	const int mipmapLevel = currentSound->getMipmapLevel(uptimeDelta * maxPitchFactor);
+	const int levelSize = currentSound->getTableSize(mipmapLevel);
+	const double levelScale = (double)levelSize / (double)tableSize;
+	const double tableLength = (double)tableSize;
+	const float invMaximum = 1.0f / currentSound->getUnnormalizedMaximum();
 
-			const int i1 = index % (tableSize);
+	float* output = voiceBuffer.getWritePointer(0, startSample);
+	double phase = tablePhase;
+	double totalDelta = 0.0;
 
-			int i2 = i1 + 1;
+	if (auto tableValues = getTableModulationValues())
+	{
+		// The second channel is overwritten with the copy of the first one anyway, so we can use it for the gain values
+		float* gainValues = voiceBuffer.getWritePointer(1, startSample);
+		tableValues += startSample;
 
-			if (i2 >= tableSize)
-			{
-				const float tableModValue = tableValues[startSample];
-				currentTableIndex = roundToInt(tableModValue * 63);
-				i2 = 0;
-			}
+		// The tables of one level are stored consecutively
+		const float* levelData = currentSound->getWaveTableData(0, mipmapLevel);
 
-			const float tableModValue = tableValues[startSample];
+		for (int i = 0; i < numSamples; i++)
+		{
+			const float tableModValue = tableValues[i];
 			const float tableValue = jlimit<float>(0.0f, 1.0f, tableModValue) * 63.0f;
 
 			const int lowerTableIndex = (int)(tableValue);
@@ -155,89 +172,93 @@ void WavetableSynthVoice::calculateBlock(int startSample, int numSamples)
 			const float tableDelta = tableValue - (float)lowerTableIndex;
 			jassert(0.0f <= tableDelta && tableDelta <= 1.0f);
 
-			lowerTable = currentSound->getWaveTableData(lowerTableIndex);
-			upperTable = currentSound->getWaveTableData(upperTableIndex);
+			const float* lower = levelData + lowerTableIndex * levelSize;
+			const float* upper = levelData + upperTableIndex * levelSize;
 
-			float tableGainValue = tableGainInterpolator.interpolateLinear(currentSound->getUnnormalizedGainValue(lowerTableIndex), currentSound->getUnnormalizedGainValue(upperTableIndex), tableDelta);
+			const double pos = phase * levelScale;
+			int i1 = (int)pos;
+			const float alpha = (float)(pos - (double)i1);
 
-			tableGainValue *= getGainValue(tableModValue);
+			if (i1 >= levelSize)
+				i1 -= levelSize;
 
-			float u1 = upperTable[i1];
-			float u2 = upperTable[i2];
-
-			float l1 = lowerTable[i1];
-			float l2 = lowerTable[i2];
+			int i2 = i1 + 1;
 
-			const float alpha = float(voiceUptime) - (float)index;
-			//const float invAlpha = 1.0f - alpha;
+			if (i2 >= levelSize)
+				i2 = 0;
 
-			const float upperSample = tableGainInterpolator.interpolateLinear(u1, u2, alpha);
+			const float lowerSample = lower[i1] + alpha * (lower[i2] - lower[i1]);
+			const float upperSample = upper[i1] + alpha * (upper[i2] - upper[i1]);
 
-			const float lowerSample = tableGainInterpolator.interpolateLinear(l1, l2, alpha);
+			output[i] = lowerSample + tableDelta * (upperSample - lowerSample);
 
-			float sample = lowerTableIndex != upperTableIndex ? tableGainInterpolator.interpolateLinear(lowerSample, upperSample, tableDelta) : lowerSample;
+			const float lowerGain = currentSound->getUnnormalizedGainValue(lowerTableIndex);
+			const float upperGain = currentSound->getUnnormalizedGainValue(upperTableIndex);
 
-			sample *= tableGainValue;
+			gainValues[i] = (lowerGain + tableDelta * (upperGain - lowerGain)) * wavetableSynth->getCachedGainValue(tableModValue);
 
-			sample *= 1.0f / currentSound->getUnnormalizedMaximum();
+			jassert(voicePitchValues == nullptr || voicePitchValues[startSample + i] > 0.0f);
 
-			// Stereo mode assumed
-			voiceBuffer.setSample(0, startSample, sample);
+			const double delta = (uptimeDelta * (voicePitchValues == nullptr ? 1.0 : voicePitchValues[startSample + i]));
 
-			jassert(voicePitchValues == nullptr || voicePitchValues[startSample] > 0.0f);
+			phase += delta;
+			totalDelta += delta;
 
-			const double delta = (uptimeDelta * (voicePitchValues == nullptr ? 1.0 : voicePitchValues[startSample]));
+			if (phase >= tableLength)
+			{
+				phase = std::fmod(phase, tableLength);
+				currentTableIndex = roundToInt(tableValue);
+			}
+		}
 
-			voiceUptime += delta;
+		FloatVectorOperations::multiply(output, gainValues, numSamples);
+		FloatVectorOperations::multiply(output, invMaximum, numSamples);
 
-			++startSample;
-		}
+		lastTableModValue = tableValues[numSamples - 1];
 	}
 	else
 	{
-		const float tableModValue = static_cast<WavetableSynth*>(getOwnerSynth())->getConstantTableModValue();
-		currentTableIndex = roundToInt(tableModValue * 63);
-		lowerTable = currentSound->getWaveTableData(currentTableIndex);
-		float tableGainValue = currentSound->getUnnormalizedGainValue(currentTableIndex);
+		lastTableModValue = -1.0f;
 
-		while (--numSamples >= 0)
-		{
-			// Get the two indexes for the table position
+		const float tableModValue = wavetableSynth->getConstantTableModValue();
+		currentTableIndex = roundToInt(jlimit<float>(0.0f, 1.0f, tableModValue) * 63.0f);
 
-			int index = (int)voiceUptime;
+		const float* table = currentSound->getWaveTableData(currentTableIndex, mipmapLevel);
+		const float tableGainValue = currentSound->getUnnormalizedGainValue(currentTableIndex) * invMaximum;
+
+		for (int i = 0; i < numSamples; i++)
+		{
+			const double pos = phase * levelScale;
+			int i1 = (int)pos;
+			const float alpha = (float)(pos - (double)i1);
 
-			const int i1 = index % (tableSize);
+			if (i1 >= levelSize)
+				i1 -= levelSize;
 
 			int i2 = i1 + 1;
 
-			if (i2 >= tableSize)
-			{
+			if (i2 >= levelSize)
 				i2 = 0;
-			}
-
-			float u1 = upperTable[i1];
-			float u2 = upperTable[i2];
 
-			const float alpha = float(voiceUptime) - (float)index;
+			output[i] = table[i1] + alpha * (table[i2] - table[i1]);
 
-			float sample = tableGainInterpolator.interpolateLinear(u1, u2, alpha);
+			jassert(voicePitchValues == nullptr || voicePitchValues[startSample + i] > 0.0f);
 
-			sample *= tableGainValue;
+			const double delta = (uptimeDelta * (voicePitchValues == nullptr ? 1.0 : voicePitchValues[startSample + i]));
 
-			sample *= 1.0f / currentSound->getUnnormalizedMaximum();
+			phase += delta;
+			totalDelta += delta;
 
-			// Stereo mode assumed
-			voiceBuffer.setSample(0, startSample, sample);
-
-			jassert(voicePitchValues == nullptr || voicePitchValues[startSample] > 0.0f);
-
-			const double delta = (uptimeDelta * (voicePitchValues == nullptr ? 1.0 : voicePitchValues[startSample]));
-
-			voiceUptime += delta;
-			++startSample;
+			if (phase >= tableLength)
+				phase = std::fmod(phase, tableLength);
 		}
+
+		FloatVectorOperations::multiply(output, tableGainValue, numSamples);
 	}
 
+	tablePhase = phase;
+	voiceUptime += totalDelta;
+
 	if (auto modValues = getOwnerSynth()->getVoiceGainValues())
 	{
 		FloatVectorOperations::multiply(voiceBuffer.getWritePointer(0, startIndex), modValues + startIndex, samplesToCopy);
@@ -252,9 +273,18 @@ void WavetableSynthVoice::calculateBlock(int startSample, int numSamples)
 	}
 
 	getOwnerSynth()->effectChain->renderVoice(voiceIndex, voiceBuffer, startIndex, samplesToCopy);
+}
+
+void WavetableSynthVoice::updateDisplayValues()
+{
+	if (getOwnerSynth()->getLastStartedVoice() != this)
+		return;
 
-	if (getOwnerSynth()->getLastStartedVoice() == this)
-		static_cast<WavetableSynth*>(getOwnerSynth())->triggerWaveformUpdate();
+	// Only update the slider pack display once per block
+	if (lastTableModValue >= 0.0f)
+		wavetableSynth->getGainValueFromTable(lastTableModValue);
+
+	wavetableSynth->triggerWaveformUpdate();
 }
 
 const float * WavetableSynthVoice::getTableModulationValues()
@@ -299,6 +329,8 @@ WavetableSound::WavetableSound(const ValueTree &wavetableData)
 
 	normalizeTables();
 
+	createMipmaps();
+
 	pitchRatio = 1.0;
 }
 
@@ -317,6 +349,187 @@ const float * WavetableSound::getWaveTableData(int wavetableIndex) const
 	}
 }
 
+const float * WavetableSound::getWaveTableData(int wavetableIndex, int mipmapLevel) const
+{
+	if (mipmapLevel == 0)
+		return getWaveTableData(wavetableIndex);
+
+	jassert(mipmapLevel < numMipmapLevels);
+
+	const auto& level = mipmaps[mipmapLevel];
+
+	if (wavetableIndex < wavetableAmount)
+		return level.tables.getReadPointer(0, wavetableIndex * level.tableSize);
+
+	return nullptr;
+}
+
+/** Calculates the spectrum of a single cycle with an arbitrary length and resynthesises it with less harmonics.
+*
+*	The cycle length is (sampleRate / note frequency), so it's almost never a power of two. The DFT is
+*	calculated with Bluestein's algorithm on a power of two FFT, and the band-limited tables are created
+*	with an inverse FFT at the smallest power of two size that can hold the remaining harmonics.
+*/
+class WavetableSound::MipmapBuilder
+{
+public:
+
+	using Complex = dsp::Complex<float>;
+
+	MipmapBuilder(int cycleLength) :
+		length(cycleLength),
+		fftSize(nextPowerOfTwo(2 * cycleLength - 1))
+	{
+		chirp.calloc(length);
+		chirpSpectrum.calloc(fftSize);
+		workBuffer.calloc(fftSize);
+		fftBuffer.calloc(fftSize);
+		spectrum.calloc(length / 2 + 1);
+
+		for (int n = 0; n < length; n++)
+		{
+			// n * n gets too big for a precise angle, so use the fact that it's periodic with 2 * length
+			const int64 nSquared = ((int64)n * (int64)n) % (int64)(2 * length);
+			const double angle = -double_Pi * (double)nSquared / (double)length;
+
+			chirp[n] = Complex((float)std::cos(angle), (float)std::sin(angle));
+		}
+
+		fftBuffer[0] = std::conj(chirp[0]);
+
+		for (int n = 1; n < length; n++)
+		{
+			fftBuffer[n] = std::conj(chirp[n]);
+			fftBuffer[fftSize - n] = std::conj(chirp[n]);
+		}
+
+		getFFT(fftSize).perform(fftBuffer, chirpSpectrum, false);
+	}
+
+	/** Calculates the spectrum of the given cycle. */
+	void analyse(const float* cycle)
+	{
+		for (int i = 0; i < fftSize; i++)
+			workBuffer[i] = i < length ? cycle[i] * chirp[i] : Complex();
+
+		auto& fft = getFFT(fftSize);
+
+		fft.perform(workBuffer, fftBuffer, false);
+
+		for (int i = 0; i < fftSize; i++)
+			fftBuffer[i] *= chirpSpectrum[i];
+
+		fft.perform(fftBuffer, workBuffer, true);
+
+		for (int k = 0; k <= length / 2; k++)
+			spectrum[k] = workBuffer[k] * chirp[k];
+	}
+
+	/** Writes the cycle with the harmonics up to maxHarmonic into destination (which must be a power of two). */
+	void synthesise(float* destination, int destinationSize, int maxHarmonic)
+	{
+		jassert(isPowerOfTwo(destinationSize));
+		jassert(maxHarmonic < destinationSize / 2);
+
+		jassert(destinationSize <= fftSize);
+
+		for (int i = 0; i < destinationSize; i++)
+			workBuffer[i] = Complex();
+
+		// The inverse FFT is normalised to the destination size, but the spectrum is scaled with the cycle length
+		const float scale = (float)destinationSize / (float)length;
+
+		workBuffer[0] = spectrum[0] * scale;
+
+		for (int h = 1; h <= maxHarmonic; h++)
+		{
+			workBuffer[h] = spectrum[h] * scale;
+			workBuffer[destinationSize - h] = std::conj(workBuffer[h]);
+		}
+
+		getFFT(destinationSize).perform(workBuffer, fftBuffer, true);
+
+		for (int i = 0; i < destinationSize; i++)
+			destination[i] = fftBuffer[i].real();
+	}
+
+private:
+
+	/** Returns the FFT for the given power of two size and creates it on the first call. */
+	dsp::FFT& getFFT(int size)
+	{
+		jassert(isPowerOfTwo(size));
+
+		const int order = (int)findHighestSetBit((uint32)size);
+
+		while (ffts.size() <= order)
+			ffts.add(nullptr);
+
+		if (ffts[order] == nullptr)
+			ffts.set(order, new dsp::FFT(order));
+
+		return *ffts[order];
+	}
+
+	const int length;
+	const int fftSize;
+
+	OwnedArray<dsp::FFT> ffts;
+
+	HeapBlock<Complex> chirp;
+	HeapBlock<Complex> chirpSpectrum;
+	HeapBlock<Complex> workBuffer;
+	HeapBlock<Complex> fftBuffer;
+	HeapBlock<Complex> spectrum;
+};
+
+void WavetableSound::createMipmaps()
+{
+	numMipmapLevels = 1;
+
+	// The original table contains every harmonic up to nyquist. We allow a semitone of headroom before switching
+	// to the next level, the aliases of this range fold back above 0.47 * samplerate.
+	const double headroom = std::pow(2.0, 1.0 / 12.0);
+	const int numOriginalHarmonics = wavetableSize / 2;
+
+	mipmaps[0].tableSize = wavetableSize;
+	mipmaps[0].maxPitchRatio = headroom;
+
+	if (numOriginalHarmonics < 2 || wavetableAmount <= 0)
+		return;
+
+	MipmapBuilder builder(wavetableSize);
+
+	for (int level = 1; level < HISE_WAVETABLE_NUM_MIPMAP_LEVELS; level++)
+	{
+		const int numHarmonics = numOriginalHarmonics >> level;
+
+		if (numHarmonics < 1)
+			break;
+
+		auto& m = mipmaps[level];
+
+		m.tableSize = nextPowerOfTwo(2 * numHarmonics + 1);
+		m.maxPitchRatio = headroom * (double)numOriginalHarmonics / (double)numHarmonics;
+		m.tables.setSize(1, m.tableSize * wavetableAmount);
+
+		numMipmapLevels = level + 1;
+	}
+
+	for (int i = 0; i < wavetableAmount; i++)
+	{
+		builder.analyse(getWaveTableData(i));
+
+		for (int level = 1; level < numMipmapLevels; level++)
+		{
+			auto& m = mipmaps[level];
+			auto numHarmonics = numOriginalHarmonics >> level;
+
+			builder.synthesise(m.tables.getWritePointer(0, i * m.tableSize), m.tableSize, numHarmonics);
+		}
+	}
+}
+
 void WavetableSound::calculatePitchRatio(double playBackSampleRate)
 {
 	const double idealCycleLength = playBackSampleRate / MidiMessage::getMidiNoteInHertz(noteNumber);
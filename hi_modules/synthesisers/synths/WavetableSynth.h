@@ -39,6 +39,14 @@ namespace hise { using namespace juce;
 
 #define WAVETABLE_HQ_MODE 1
 
+/** The number of band-limited versions of each wavetable (including the original table).
+*
+*	Every level removes the upper octave of harmonics, so the table can be played back one octave higher without aliasing.
+*/
+#ifndef HISE_WAVETABLE_NUM_MIPMAP_LEVELS
+#define HISE_WAVETABLE_NUM_MIPMAP_LEVELS 6
+#endif
+
 class WavetableSynth;
 
 class WavetableSound: public ModulatorSynthSound
@@ -67,6 +75,30 @@ public:
 	*/
 	const float *getWaveTableData(int wavetableIndex) const;
 
+	/** Returns a read pointer to the band-limited version of the wavetable. Level 0 is the original table.
+	*
+	*	The mipmap levels have a different (power of two) table size, so use getTableSize(mipmapLevel) to scale the index.
+	*/
+	const float *getWaveTableData(int wavetableIndex, int mipmapLevel) const;
+
+	/** Returns the mipmap level that can play the table with the given pitch ratio (table samples per output sample). */
+	int getMipmapLevel(double pitchRatio) const noexcept
+	{
+		int level = 0;
+
+		while (level < numMipmapLevels - 1 && pitchRatio > mipmaps[level].maxPitchRatio)
+			++level;
+
+		return level;
+	}
+
+	int getTableSize(int mipmapLevel) const noexcept
+	{
+		return mipmapLevel == 0 ? wavetableSize : mipmaps[mipmapLevel].tableSize;
+	}
+
+	int getNumMipmapLevels() const noexcept { return numMipmapLevels; }
+
 	float getUnnormalizedMaximum()
 	{
 		return unnormalizedMaximum;
@@ -102,6 +134,23 @@ public:
 
 private:
 
+	class MipmapBuilder;
+
+	/** Creates the band-limited versions of all tables. Call this after normalizeTables(). */
+	void createMipmaps();
+
+	struct MipmapLevel
+	{
+		AudioSampleBuffer tables;
+		int tableSize = 0;
+
+		/** The highest pitch ratio that this level can play without audible aliasing. */
+		double maxPitchRatio = 1.0;
+	};
+
+	MipmapLevel mipmaps[HISE_WAVETABLE_NUM_MIPMAP_LEVELS];
+	int numMipmapLevels = 1;
+
 	float maximum;
 	float unnormalizedMaximum;
 	float unnormalizedGainValues[64];
@@ -141,6 +190,7 @@ public:
 		midiNoteNumber += getTransposeAmount();
 		currentSound = static_cast<WavetableSound*>(s);
         voiceUptime = 0.0;
+		tablePhase = 0.0;
         
 		lowerTable = currentSound->getWaveTableData(0);
 		upperTable = lowerTable;
@@ -162,6 +212,8 @@ public:
 
 	void calculateBlock(int startSample, int numSamples) override;;
 
+	void updateDisplayValues() override;
+
 	int getCurrentTableIndex() const
 	{
 		return currentTableIndex;
@@ -214,6 +266,12 @@ private:
 
 	int smoothSize;
 
+	/** The read position in the original table, wrapped to the table size (voiceUptime keeps counting for the voice stealing). */
+	double tablePhase = 0.0;
+
+	/** The last table modulation value of the block for the slider pack display (-1 if the table index isn't modulated). */
+	float lastTableModValue = -1.0f;
+
 };
 
 
@@ -301,6 +359,18 @@ public:
 		return pack->getValue(index);
 	}
 
+	/** Returns the gain table value from the copy that is refreshed before the voices are rendered.
+	*
+	*	Use this in the voice rendering, getGainValueFromTable() locks the slider pack and updates the display.
+	*/
+	float getCachedGainValue(float level) const noexcept
+	{
+		const int index = jlimit<int>(0, numCachedGainValues - 1, roundToInt((float)numCachedGainValues * level));
+		return cachedGainValues[index];
+	}
+
+	void preVoiceRendering(int startSample, int numThisTime) override;
+
 	
 	void restoreFromValueTree(const ValueTree &v) override
 	{
@@ -498,6 +568,9 @@ private:
 	int currentBankIndex = 0;
 
 	ScopedPointer<SliderPackData> pack;
+
+	float cachedGainValues[128];
+	int numCachedGainValues = 1;
 	
 	bool hqMode;
 
@@ -84,6 +84,10 @@ SET_DOCUMENTATION(ModulatorSampler)
 
     ADD_PARAMETER_DOC(UseStaticMatrix,
         "If this is true, then the routing matrix will not be resized when you load a sample map with another mic position amount.");
+
+	ADD_PARAMETER_DOC_WITH_NAME(InterpolationMode, "Interpolation",
+		"The interpolation algorithm for the sample playback: `0` = Linear, `1` = Hermite (4-point cubic), `2` = Sinc (windowed sinc). " \
+		"The higher order modes cost more CPU but reduce aliasing, so you can use samples with a lower sample rate.");
     
 	ADD_CHAIN_DOC(SampleStartModulation, "Sample Start", 
 		"Allows modification of the sample start if the sound allows this. The modulation range is depending on the *SampleStartMod* value of each sample.");
@@ -97,6 +101,7 @@ ModulatorSampler::ModulatorSampler(MainController *mc, const String &id, int num
 ModulatorSynth(mc, id, numVoices),
 preloadSize(PRELOAD_SIZE),
 asyncPurger(this),
+soundIndex(this),
 sampleMap(new SampleMap(this)),
 rrGroupAmount(1),
 bufferSize(4096),
@@ -146,6 +151,7 @@ temporaryVoiceBuffer(DEFAULT_BUFFER_TYPE_IS_FLOAT, 2, 0)
 	parameterNames.add("Purged");
 	parameterNames.add("Reversed");
     parameterNames.add("UseStaticMatrix");
+	parameterNames.add("InterpolationMode");
 
 	editorStateIdentifiers.add("SampleStartChainShown");
 	editorStateIdentifiers.add("SettingsShown");
@@ -200,6 +206,15 @@ void ModulatorSampler::refreshRRMap()
 	}
 }
 
+void ModulatorSampler::setInterpolationMode(SampleInterpolationMode newMode)
+{
+	// Calculate the polyphase table now so that it doesn't happen in the audio thread
+	if (newMode == SampleInterpolationMode::Sinc)
+		SincKernel::getTable();
+
+	interpolationMode = newMode;
+}
+
 void ModulatorSampler::setReversed(bool shouldBeReversed)
 {
     if (reversed != shouldBeReversed)
@@ -294,6 +309,7 @@ void ModulatorSampler::restoreFromValueTree(const ValueTree &v)
 {
 	loadAttribute(PreloadSize, "PreloadSize");
     loadAttribute(UseStaticMatrix, "UseStaticMatrix");
+	loadAttribute(InterpolationMode, "InterpolationMode");
 	
 	setInternalAttribute(BufferSize, v.getProperty("BufferSize", 4096));
 
@@ -366,6 +382,7 @@ ValueTree ModulatorSampler::exportAsValueTree() const
 	saveAttribute(Reversed, "Reversed");
 	v.setProperty("NumChannels", numChannels, nullptr);
     saveAttribute(UseStaticMatrix, "UseStaticMatrix");
+	saveAttribute(InterpolationMode, "InterpolationMode");
 
 	ValueTree channels("channels");
 
@@ -430,6 +447,7 @@ float ModulatorSampler::getAttribute(int parameterIndex) const
 	case Purged:			return purged ? 1.0f : 0.0f;
 	case Reversed:			return reversed ? 1.0f : 0.0f;
     case UseStaticMatrix:   return useStaticMatrix ? 1.0f : 0.0f;
+	case InterpolationMode:	return (float)(int)interpolationMode;
 	default:				jassertfalse; return -1.0f;
 	}
 }
@@ -460,6 +478,7 @@ void ModulatorSampler::setInternalAttribute(int parameterIndex, float newValue)
 	case CrossfadeGroups:	crossfadeGroups = newValue > 0.5f; refreshCrossfadeTables(); break;
 	case Purged:			purgeAllSamples(newValue > 0.5f); break;
 	case UseStaticMatrix:   setUseStaticMatrix(newValue > 0.5f); break;
+	case InterpolationMode:	setInterpolationMode((SampleInterpolationMode)jlimit<int>(0, (int)SampleInterpolationMode::numInterpolationModes - 1, (int)newValue)); break;
 	default:				jassertfalse; break;
 	}
 }
@@ -505,6 +524,34 @@ void ModulatorSampler::prepareToPlay(double newSampleRate, int samplesPerBlock)
 	if (newSampleRate != -1.0)
 	{
 		StreamingSamplerVoice::initTemporaryVoiceBuffer(&temporaryVoiceBuffer, samplesPerBlock);
+		initWorkerVoiceBuffers(samplesPerBlock);
+	}
+}
+
+bool ModulatorSampler::shouldRenderVoicesInParallel() const
+{
+	// The crossfade values are calculated for every voice into the buffer of the sampler
+	if (crossfadeGroups)
+		return false;
+
+	// The amount of threads might have been changed since the last prepareToPlay() call
+	if (workerVoiceBuffers.size() + 1 < getMainController()->getParallelRenderPool().getNumThreads())
+		return false;
+
+	return ModulatorSynth::shouldRenderVoicesInParallel();
+}
+
+void ModulatorSampler::initWorkerVoiceBuffers(int samplesPerBlock)
+{
+	const int numWorkers = getMainController()->getParallelRenderPool().getNumThreads() - 1;
+	const bool isFloat = temporaryVoiceBuffer.isFloatingPoint();
+
+	workerVoiceBuffers.clear();
+
+	for (int i = 0; i < numWorkers; i++)
+	{
+		auto b = workerVoiceBuffers.add(new hlac::HiseSampleBuffer(isFloat, 2, 0));
+		StreamingSamplerVoice::initTemporaryVoiceBuffer(b, samplesPerBlock);
 	}
 }
 
@@ -558,6 +605,7 @@ void ModulatorSampler::deleteSound(int index)
 		{
 			LockHelpers::SafeLock sl(getMainController(), LockHelpers::SampleLock);
 			removeSound(index);
+			soundIndex.markAsDirty();
 		}
 
 		if (!delayUpdate)
@@ -592,6 +640,7 @@ void ModulatorSampler::deleteAllSounds()
 		if (getNumSounds() != 0)
 		{
 			clearSounds();
+			soundIndex.markAsDirty();
 
 			if(getSampleMap() != nullptr)
 				getSampleMap()->getCurrentSamplePool()->clearUnreferencedMonoliths();
@@ -660,6 +709,7 @@ void ModulatorSampler::refreshMemoryUsage()
 		temporaryVoiceBuffer = hlac::HiseSampleBuffer(temporaryBufferShouldBeFloatingPoint, 2, 0);
 
 		StreamingSamplerVoice::initTemporaryVoiceBuffer(&temporaryVoiceBuffer, getLargestBlockSize());
+		initWorkerVoiceBuffers(getLargestBlockSize());
 
 		for (auto i = 0; i < getNumVoices(); i++)
 		{
@@ -809,6 +859,143 @@ void ModulatorSampler::AsyncPurger::handleAsyncUpdate()
 	sampler->refreshChannelsForSounds();
 }
 
+void ModulatorSampler::SoundIndex::markAsDirty()
+{
+	++version;
+	triggerAsyncUpdate();
+}
+
+bool ModulatorSampler::SoundIndex::collectSounds(const HiseEvent& m)
+{
+	GenericScopedTryLock<SpinLock> sl(tableLock);
+
+	if (!sl.isLocked() || table == nullptr || builtVersion.load() != version.load())
+		return false;
+
+	auto& stack = sampler->soundsToBeStarted;
+
+	stack.clearQuick();
+
+	const int midiChannel = m.getChannel();
+	const int transposedMidiNoteNumber = m.getNoteNumber() + m.getTransposeAmount();
+	const float velocity = m.getFloatVelocity();
+
+	if (!isPositiveAndBelow(transposedMidiNoteNumber, (int)NumNotes))
+		return true;
+
+	const int velocityZone = jlimit<int>(0, NumVelocityZones - 1, (int)(velocity * 127) / VelocityZoneSize);
+
+	auto addSoundsFromSlot = [&](int slot)
+	{
+		const int bucketIndex = table->getBucketIndex(slot, transposedMidiNoteNumber, velocityZone);
+		const int end = table->bucketStarts.getUnchecked(bucketIndex + 1);
+
+		// The table only narrows down the candidates, the sound still has to pass the usual check
+		for (int i = table->bucketStarts.getUnchecked(bucketIndex); i < end; i++)
+		{
+			auto sound = table->sounds.getUnchecked(i);
+
+			if (sampler->soundCanBePlayed(sound, midiChannel, transposedMidiNoteNumber, velocity))
+				stack.insertWithoutSearch(sound);
+		}
+	};
+
+	if (sampler->crossfadeGroups)
+	{
+		for (int slot = 0; slot <= table->numGroups; slot++)
+			addSoundsFromSlot(slot);
+	}
+	else
+		addSoundsFromSlot(table->getSlot(sampler->currentRRGroupIndex));
+
+	return true;
+}
+
+void ModulatorSampler::SoundIndex::handleAsyncUpdate()
+{
+	const int versionToBuild = version.load();
+
+	ScopedPointer<Table> newTable = new Table();
+
+	{
+		LockHelpers::SafeLock sl(sampler->getMainController(), LockHelpers::SampleLock);
+
+		newTable->numGroups = sampler->rrGroupAmount;
+
+		const int numBuckets = (newTable->numGroups + 1) * NumNotes * NumVelocityZones;
+
+		Array<int> counts;
+		counts.insertMultiple(0, 0, numBuckets);
+
+		auto forEachBucket = [&newTable](ModulatorSamplerSound* sound, const std::function<void(int)>& f)
+		{
+			const Range<int> allValues(0, 128);
+
+			auto noteRange = sound->getNoteRange().getIntersectionWith(allValues);
+			auto velocityRange = sound->getVelocityRange().getIntersectionWith(allValues);
+
+			if (noteRange.isEmpty() || velocityRange.isEmpty())
+				return;
+
+			const int slot = newTable->getSlot(sound->getRRGroup());
+			const int firstZone = velocityRange.getStart() / VelocityZoneSize;
+			const int lastZone = (velocityRange.getEnd() - 1) / VelocityZoneSize;
+
+			for (int n = noteRange.getStart(); n < noteRange.getEnd(); n++)
+			{
+				for (int z = firstZone; z <= lastZone; z++)
+					f(newTable->getBucketIndex(slot, n, z));
+			}
+		};
+
+		const int numSounds = sampler->getNumSounds();
+
+		for (int i = 0; i < numSounds; i++)
+		{
+			auto sound = static_cast<ModulatorSamplerSound*>(sampler->getSound(i));
+			forEachBucket(sound, [&counts](int b) { counts.getReference(b)++; });
+		}
+
+		newTable->bucketStarts.ensureStorageAllocated(numBuckets + 1);
+		newTable->bucketStarts.add(0);
+
+		for (int i = 0; i < numBuckets; i++)
+			newTable->bucketStarts.add(newTable->bucketStarts.getUnchecked(i) + counts[i]);
+
+		newTable->sounds.insertMultiple(0, nullptr, newTable->bucketStarts.getLast());
+
+		// Reuse the counts as write position so that the sounds keep their order within a bucket
+		for (int i = 0; i < numBuckets; i++)
+			counts.set(i, newTable->bucketStarts.getUnchecked(i));
+
+		for (int i = 0; i < numSounds; i++)
+		{
+			auto sound = static_cast<ModulatorSamplerSound*>(sampler->getSound(i));
+			forEachBucket(sound, [&](int b) { newTable->sounds.set(counts.getReference(b)++, sound); });
+		}
+
+		SpinLock::ScopedLockType tl(tableLock);
+		table.swapWith(newTable);
+		builtVersion.store(versionToBuild);
+	}
+
+	// The mapping has changed while the table was built
+	if (versionToBuild != version.load())
+		triggerAsyncUpdate();
+}
+
+int ModulatorSampler::collectSoundsToBeStarted(const HiseEvent& m)
+{
+	if (!soundIndex.collectSounds(m))
+		return ModulatorSynth::collectSoundsToBeStarted(m);
+
+#if JUCE_DEBUG
+	eventForSoundCollection = m;
+#endif
+
+	return soundsToBeStarted.size();
+}
+
 void ModulatorSampler::setPreloadSize(int newPreloadSize)
 {
 	if (newPreloadSize != 0 && newPreloadSize != preloadSize)
@@ -1166,6 +1353,8 @@ void ModulatorSampler::setRRGroupAmount(int newGroupLimit)
 
 	while (auto sound = sIter.getNextSound())
 		sound->setMaxRRGroupIndex(rrGroupAmount);
+
+	soundIndex.markAsDirty();
 }
 
 
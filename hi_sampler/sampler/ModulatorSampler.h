@@ -141,6 +141,7 @@ public:
 		Purged, 
 		Reversed,
         UseStaticMatrix,
+		InterpolationMode,
 		numModulatorSamplerParameters
 	};
 
@@ -204,6 +205,12 @@ public:
 
 	void prepareToPlay(double sampleRate, int samplesPerBlock) override;;
 
+	/** The sampler voices only change their own state and use a temporary voice buffer for each render thread. */
+	bool canRenderVoicesInParallel() const override { return true; }
+
+	/** Falls back to the serial rendering if the crossfade groups are used. */
+	bool shouldRenderVoicesInParallel() const override;
+
 	ProcessorEditorBody* createEditor(ProcessorEditor *parentEditor) override;
 
 	void loadCacheFromFile(File &f);;
@@ -292,6 +299,12 @@ public:
 	void preStartVoice(int voiceIndex, int noteNumber) override;
 	void soundsChanged() {};
 	bool soundCanBePlayed(ModulatorSynthSound *sound, int midiChannel, int midiNoteNumber, float velocity) override;;
+
+	/** Uses the precomputed sound index instead of iterating over all sounds. */
+	int collectSoundsToBeStarted(const HiseEvent& m) override;
+
+	/** Call this whenever the note / velocity range or the RR group of a sound changes. */
+	void refreshSoundIndex() { soundIndex.markAsDirty(); }
 	void handleRetriggeredNote(ModulatorSynthVoice *voice) override;
 
 	/** Overwrites the base class method and ignores the note off event if Parameters::OneShot is enabled. */
@@ -529,7 +542,15 @@ public:
 		return saveString;
 	}
 
-	hlac::HiseSampleBuffer* getTemporaryVoiceBuffer() { return &temporaryVoiceBuffer; }
+	/** Returns the buffer for the given thread index of the ParallelRenderPool. */
+	hlac::HiseSampleBuffer* getTemporaryVoiceBuffer(int threadIndex=0) 
+	{ 
+		if (threadIndex == 0)
+			return &temporaryVoiceBuffer;
+
+		jassert(isPositiveAndNotGreaterThan(threadIndex, workerVoiceBuffers.size()));
+		return workerVoiceBuffers[threadIndex - 1];
+	}
 
 	bool checkAndLogIsSoftBypassed(DebugLogger::Location location) const;
 
@@ -549,6 +570,11 @@ public:
     
     bool isUsingStaticMatrix() const noexcept { return useStaticMatrix; };
 
+	/** Sets the interpolation algorithm for the sample playback. This will be applied to all new voices. */
+	void setInterpolationMode(SampleInterpolationMode newMode);
+
+	SampleInterpolationMode getInterpolationMode() const noexcept { return interpolationMode; }
+
 	bool shouldDelayUpdate() const noexcept { return delayUpdate; }
 
 	/** Checks the global queue if there are any jobs that will be executed sometime in the future. 
@@ -597,7 +623,61 @@ private:
 		ModulatorSampler *sampler;
 	};
 
-	
+	/** A lookup table that contains the sounds for every RR group / note number / velocity zone.
+	*
+	*	The table is rebuilt on the message thread whenever the sounds or their mapping change. Until then 
+	*	the note on will fall back to the linear search over all sounds, so the result is always correct. 
+	*/
+	struct SoundIndex : public AsyncUpdater
+	{
+	public:
+
+		enum
+		{
+			NumNotes = 128,
+			NumVelocityZones = 8,
+			VelocityZoneSize = 128 / NumVelocityZones
+		};
+
+		SoundIndex(ModulatorSampler* sampler_) :
+			sampler(sampler_)
+		{};
+
+		/** Invalidates the current table and rebuilds it asynchronously. */
+		void markAsDirty();
+
+		/** Fills the soundsToBeStarted stack with the sounds for the event. Returns false if the table is not up to date. */
+		bool collectSounds(const HiseEvent& m);
+
+		void handleAsyncUpdate() override;
+
+	private:
+
+		struct Table
+		{
+			int getSlot(int rrGroup) const noexcept { return isPositiveAndNotGreaterThan(rrGroup, numGroups) ? rrGroup : 0; }
+
+			int getBucketIndex(int slot, int noteNumber, int velocityZone) const noexcept
+			{
+				return (slot * NumNotes + noteNumber) * NumVelocityZones + velocityZone;
+			}
+
+			// The RR groups outside the range 1...numGroups are stored in the slot 0
+			int numGroups = 0;
+
+			Array<int> bucketStarts;
+			Array<ModulatorSynthSound*> sounds;
+		};
+
+		ModulatorSampler *sampler;
+
+		SpinLock tableLock;
+		ScopedPointer<Table> table;
+
+		std::atomic<int> version = { 0 };
+		std::atomic<int> builtVersion = { -1 };
+	};
+
     /** Sets the streaming buffer and preload buffer sizes. */
     void setPreloadSize(int newPreloadSize);
     
@@ -605,6 +685,8 @@ private:
 
 	AsyncPurger asyncPurger;
 
+	SoundIndex soundIndex;
+
 	void refreshCrossfadeTables();
 
 	RoundRobinMap roundRobinMap;
@@ -634,6 +716,8 @@ private:
 
 	bool useStaticMatrix = false;
 
+	SampleInterpolationMode interpolationMode = SampleInterpolationMode::Linear;
+
 	int64 memoryUsage;
 
 	OwnedArray<SampleLookupTable> crossfadeTables;
@@ -642,6 +726,11 @@ private:
 
 	hlac::HiseSampleBuffer temporaryVoiceBuffer;
 
+	/** Creates the temporary voice buffers for the worker threads of the ParallelRenderPool. */
+	void initWorkerVoiceBuffers(int samplesPerBlock);
+
+	OwnedArray<hlac::HiseSampleBuffer> workerVoiceBuffers;
+
 	bool delayUpdate = false;
 
 	float groupGainValues[8];
@@ -416,6 +416,7 @@ void SampleMap::addSampleFromValueTree(ValueTree childWhichHasBeenAdded)
 	{
 		LockHelpers::SafeLock sl(sampler->getMainController(), LockHelpers::SampleLock);
 		sampler->addSound(newSound);
+		sampler->refreshSoundIndex();
 	}
 
 	dynamic_cast<ModulatorSamplerSound*>(newSound)->initPreloadBuffer((int)sampler->getAttribute(ModulatorSampler::PreloadSize));
@@ -1066,9 +1067,15 @@ void MonolithExporter::writeFiles(int channelIndex, bool overwriteExistingData)
 
 		StringPairArray empty;
 
+		// The blocks of all samples are encoded on every CPU core (the pool must outlive the writer)
+		ThreadPool encoderPool(SystemStats::getNumCpus());
+
 		ScopedPointer<AudioFormatWriter> writer = hlac.createWriterFor(hlacOutput, sampleRate, isMono ? 1 : 2, 16, empty, 5);
 
-		dynamic_cast<hlac::HiseLosslessAudioFormatWriter*>(writer.get())->setOptions(options);
+		auto hlacWriter = dynamic_cast<hlac::HiseLosslessAudioFormatWriter*>(writer.get());
+
+		hlacWriter->setOptions(options);
+		hlacWriter->setThreadPool(&encoderPool);
 
 		for (int i = 0; i < channelList->size(); i++)
 		{
@@ -553,6 +553,12 @@ void ModulatorSamplerSound::updateInternalData(const Identifier& id, const var&
 		{
 			upperVeloXFadeValue = newValue;
 		}
+
+		if (id == SampleIds::LoKey || id == SampleIds::HiKey || id == SampleIds::LoVel || id == SampleIds::HiVel || id == SampleIds::RRGroup)
+		{
+			if (auto map = parentMap.get())
+				map->getSampler()->refreshSoundIndex();
+		}
 	}
 	else
 	{
@@ -75,6 +75,7 @@ void ModulatorSamplerVoice::startNote(int midiNoteNumber,
 
 	wrappedVoice.setPitchFactor(midiNoteNumber, samePitch ? midiNoteNumber : currentlyPlayingSamplerSound->getRootNote(), sound, getOwnerSynth()->getMainController()->getGlobalPitchFactor());
 	wrappedVoice.setSampleStartModValue(sampleStartModulationDelta);
+	wrappedVoice.setInterpolationMode(sampler->getInterpolationMode());
 	wrappedVoice.startNote(midiNoteNumber, velocity, sound, -1);
 
 	voiceUptime = wrappedVoice.voiceUptime;
@@ -106,7 +107,7 @@ void ModulatorSamplerVoice::calculateBlock(int startSample, int numSamples)
 	const int startIndex = startSample;
 	const int samplesInBlock = numSamples;
 
-	auto voicePitchValues = getOwnerSynth()->getPitchValuesForVoice();
+	auto voicePitchValues = getPitchValues();
 
 	const double propertyPitch = currentlyPlayingSamplerSound->getPropertyPitch();
 	
@@ -123,6 +124,7 @@ void ModulatorSamplerVoice::calculateBlock(int startSample, int numSamples)
 
 	voiceBuffer.clear();
 
+	wrappedVoice.setTemporaryVoiceBuffer(sampler->getTemporaryVoiceBuffer(getRenderThreadIndex()));
 	wrappedVoice.renderNextBlock(voiceBuffer, startSample, numSamples);
 
 	CHECK_AND_LOG_BUFFER_DATA(getOwnerSynth(), DebugLogger::Location::SampleRendering, voiceBuffer.getReadPointer(0, startSample), true, samplesInBlock);
@@ -132,12 +134,12 @@ void ModulatorSamplerVoice::calculateBlock(int startSample, int numSamples)
 	
 	if (!wrappedVoice.isActive)
 	{
-		resetVoice();
+		resetVoiceAfterRendering();
 	}
 
 	getOwnerSynth()->effectChain->renderVoice(voiceIndex, voiceBuffer, startIndex, samplesInBlock);
 
-	if (auto modValues = getOwnerSynth()->getVoiceGainValues())
+	if (auto modValues = getGainValues())
 	{
 		FloatVectorOperations::multiply(voiceBuffer.getWritePointer(0, startIndex), modValues + startIndex, samplesInBlock);
 		FloatVectorOperations::multiply(voiceBuffer.getWritePointer(1, startIndex), modValues + startIndex, samplesInBlock);
@@ -151,7 +153,7 @@ void ModulatorSamplerVoice::calculateBlock(int startSample, int numSamples)
 		jassert(getConstantCrossfadeModulationValue() == 1.0f);
 	}
 	
-	float totalGain = getOwnerSynth()->getConstantGainModValue();
+	float totalGain = getConstantGainValue();
 	
 	float thisCrossfadeGain = getConstantCrossfadeModulationValue();
 
@@ -166,13 +168,14 @@ void ModulatorSamplerVoice::calculateBlock(int startSample, int numSamples)
 	
 	if (lGain != 1.0f) FloatVectorOperations::multiply(voiceBuffer.getWritePointer(0, startIndex), lGain, samplesInBlock);
 	if (rGain != 1.0f) FloatVectorOperations::multiply(voiceBuffer.getWritePointer(1, startIndex), rGain, samplesInBlock);
+}
 
-	
-
+void ModulatorSamplerVoice::updateDisplayValues()
+{
 #if USE_BACKEND
 	if (sampler->isLastStartedVoice(this))
 	{
-		handlePlaybackPosition(sound);
+		handlePlaybackPosition(wrappedVoice.getLoadedSound());
 	}
 #endif
 }
@@ -373,6 +376,7 @@ void MultiMicModulatorSamplerVoice::startNote(int midiNoteNumber, float velocity
 
 		voiceToUse->setPitchFactor(midiNoteNumber, rootNote, micSound, globalPitchFactor);
 		voiceToUse->setSampleStartModValue(sampleStartModulationDelta);
+		voiceToUse->setInterpolationMode(sampler->getInterpolationMode());
 		voiceToUse->startNote(midiNoteNumber, velocity, micSound, -1);
 
 		voiceUptime = wrappedVoices[i]->voiceUptime;
@@ -388,7 +392,7 @@ void MultiMicModulatorSamplerVoice::calculateBlock(int startSample, int numSampl
 	const int startIndex = startSample;
 	const int samplesInBlock = numSamples;
 
-	auto voicePitchValues = getOwnerSynth()->getPitchValuesForVoice();
+	auto voicePitchValues = getPitchValues();
 
 	const double propertyPitch = (float)currentlyPlayingSamplerSound->getPropertyPitch();
 	const double pitchCounter = limitPitchDataToMaxSamplerPitch(voicePitchValues, uptimeDelta * propertyPitch, startSample, numSamples);
@@ -413,19 +417,20 @@ void MultiMicModulatorSamplerVoice::calculateBlock(int startSample, int numSampl
 
 		AudioSampleBuffer channelBuffer(channels, 2, voiceBuffer.getNumSamples());
 
+		wrappedVoices[i]->setTemporaryVoiceBuffer(sampler->getTemporaryVoiceBuffer(getRenderThreadIndex()));
 		wrappedVoices[i]->renderNextBlock(channelBuffer, startSample, numSamples);
 
 		voiceUptime = wrappedVoices[i]->voiceUptime;
 
 		if (!wrappedVoices[i]->isActive)
 		{
-			resetVoice();
+			resetVoiceAfterRendering();
 		}
 	}
 
 	getOwnerSynth()->effectChain->renderVoice(voiceIndex, voiceBuffer, startIndex, samplesInBlock);
 	
-	if (auto modValues = getOwnerSynth()->getVoiceGainValues())
+	if (auto modValues = getGainValues())
 	{
 		for (int i = 0; i < wrappedVoices.size(); i++)
 		{
@@ -449,7 +454,7 @@ void MultiMicModulatorSamplerVoice::calculateBlock(int startSample, int numSampl
 		jassert(getConstantCrossfadeModulationValue() == 1.0f);
 	}
 
-	float totalGain = getOwnerSynth()->getConstantGainModValue();
+	float totalGain = getConstantGainValue();
 	float thisCrossfadeGain = getConstantCrossfadeModulationValue();
 
 	totalGain *= thisCrossfadeGain;
@@ -470,7 +475,10 @@ void MultiMicModulatorSamplerVoice::calculateBlock(int startSample, int numSampl
 		if (rGain != 1.0f)
 			FloatVectorOperations::multiply(voiceBuffer.getWritePointer(2 * i + 1, startIndex), rGain, samplesInBlock);
 	}
+}
 
+void MultiMicModulatorSamplerVoice::updateDisplayValues()
+{
 	if (sampler->isLastStartedVoice(this))
 	{
 		if (wrappedVoices.size() != 0 && wrappedVoices[0]->getLoadedSound() != nullptr)
@@ -59,6 +59,7 @@ public:
 
 	void prepareToPlay(double sampleRate, int samplesPerBlock) override;
 	void calculateBlock(int startSample, int numSamples) override;
+	void updateDisplayValues() override;
 	void resetVoice() override;
 
 	void handlePlaybackPosition(const StreamingSamplerSound * sound);
@@ -132,6 +133,7 @@ public:
 
 	void startNote(int midiNoteNumber, float velocity, SynthesiserSound* s, int /*currentPitchWheelPosition*/) override;
 	void calculateBlock(int startSample, int numSamples) override;
+	void updateDisplayValues() override;
 	void prepareToPlay(double sampleRate, int samplesPerBlock);
 
 	// ================================================================================================================
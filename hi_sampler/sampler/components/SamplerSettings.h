@@ -53,6 +53,10 @@ public:
 	{
 		const double usage = sampler->getDiskUsage();
 		diskSlider->setValue(usage, dontSendNotification);
+
+#if HLAC_USE_DECODED_BLOCK_CACHE
+		memoryUsageLabel->setTooltip(hlac::DecodedBlockCache::getInstance().getStatistics().toString());
+#endif
 	}
 
 	int getPanelHeight() const
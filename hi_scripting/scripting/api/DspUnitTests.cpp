@@ -57,6 +57,10 @@ public:
 
 		testVariantBufferWithCorruptValues();
 
+		testVariantBufferOperations();
+
+		testBiquadCoefficients();
+
 		testDspInstances();
 
 		testCircularBuffers();
@@ -279,6 +283,187 @@ public:
 
 
 
+	void testVariantBufferOperations()
+	{
+		beginTest("Testing VariantBuffer range checks");
+
+		VariantBuffer::Ptr b = new VariantBuffer(8);
+		VariantBuffer::Ptr small = new VariantBuffer(4);
+
+		b->fillRamp(0.0f, 7.0f);
+
+		expectEquals<float>(b->getMagnitude(2, 3), 4.0f, "Magnitude of a range");
+		expectEquals<float>(b->getMagnitude(8, -1), 0.0f, "Magnitude of an empty range");
+
+		expectError("Negative start sample", [&]() { b->getMagnitude(-1, 2); });
+		expectError("Range past the end", [&]() { b->getMagnitude(4, 5); });
+		expectError("RMS range past the end", [&]() { b->getRMSLevel(0, 9); });
+		expectError("Negative source offset", [&]() { b->copyFrom(*small, -1, 0, 2); });
+		expectError("Source range past the end", [&]() { b->copyFrom(*small, 2, 0, 4); });
+		expectError("Destination range past the end", [&]() { b->copyFrom(*small, 0, 6, 4); });
+		expectError("Inverted clamp range", [&]() { b->clamp(1.0f, -1.0f); });
+		expectError("Source buffer too small", [&]() { b->addWithMultiply(*small, 0.5f); });
+		expectError("Gain buffer too small", [&]() { b->addWithMultiply(*b, *small); });
+		expectError("Table too small", [&]() { VariantBuffer table(1); b->applyTable(table); });
+		expectError("Unknown window", [&]() { VariantBuffer::getWindowType("Foo"); });
+
+		expectBufferEquals(*b, { 0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f }, "A failed range check changed the buffer");
+
+		beginTest("Testing overlapping VariantBuffer copies");
+
+		b->copyFrom(*b, 0, 2, 6);
+		expectBufferEquals(*b, { 0.0f, 1.0f, 0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f }, "Copy to a later position");
+
+		b->fillRamp(0.0f, 7.0f);
+		b->copyFrom(*b, 2, 0, 6);
+		expectBufferEquals(*b, { 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 6.0f, 7.0f }, "Copy to an earlier position");
+
+		// The referenced buffer points into the data of the other buffer
+		VariantBuffer::Ptr ref = new VariantBuffer(0);
+		ref->referToOtherBuffer(b, 1, 6);
+
+		b->fillRamp(0.0f, 7.0f);
+		b->copyFrom(*ref, 0, 3, 5);
+		expectBufferEquals(*b, { 0.0f, 1.0f, 2.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f }, "Copy from a referenced buffer");
+
+		b->fillRamp(0.0f, 7.0f);
+		ref->copyFrom(*b, 3, 0, -1);
+		expectBufferEquals(*b, { 0.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 6.0f, 7.0f }, "Copy into a referenced buffer");
+
+		beginTest("Testing VariantBuffer script methods");
+
+		ReferenceCountedObjectPtr<VariantBuffer::Factory> factory = new VariantBuffer::Factory(4);
+
+		expect(!factory->hasMethod("add"), "Buffer methods must not be static methods of the factory");
+		expect(factory->hasMethod("create"), "The factory methods are missing");
+		expect(factory->getBufferMethod("create") == nullptr, "Factory methods must not be buffer methods");
+
+		auto addMethod = factory->getBufferMethod("add");
+
+		expect(addMethod != nullptr && addMethod->isMethod(), "The add method is missing");
+
+		if (addMethod != nullptr)
+		{
+			var thisObject(b.get());
+			var args[1] = { var(2.0) };
+
+			b->fillRamp(0.0f, 7.0f);
+			addMethod->getNativeFunction()(var::NativeFunctionArgs(thisObject, args, 1));
+
+			expectBufferEquals(*b, { 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f }, "Calling the add method");
+
+			expectError("Calling a buffer method on the factory", [&]()
+			{
+				addMethod->getNativeFunction()(var::NativeFunctionArgs(var(factory.get()), args, 1));
+			});
+		}
+	}
+
+	void testBiquadCoefficients()
+	{
+		beginTest("Testing the biquad coefficients from the coefficient table");
+
+		const double maxTableFrequency = FilterCoefficientTable::getInstance().getMaxNormalisedFrequency();
+
+		expect(maxTableFrequency > 0.4 && maxTableFrequency < 0.5, "Table limit: " + String(maxTableFrequency));
+
+		const double sampleRates[] = { 22050.0, 44100.0, 48000.0, 96000.0, 192000.0 };
+		const double qValues[] = { 0.3, 1.0 / std::sqrt(2.0), 1.0, 4.0, 10.0 };
+		const double gainValues[] = { 0.0625, 0.5, 1.0, 2.0, 16.0 };
+
+		// The first frequency is below the 2Hz clip of the shelf filters and the last ones are above
+		// the table limit, where the exact tan is used.
+		const double normalisedFrequencies[] = { 0.00005, 0.001, 0.01, 0.0523, 0.1, 0.25, 0.37, 0.45,
+												 maxTableFrequency * 0.999, maxTableFrequency * 1.001, 0.48, 0.499 };
+
+		for (int t = 0; t < StaticBiquadSubType::numFilterTypes; t++)
+		{
+			const auto type = (StaticBiquadSubType::FilterType)t;
+
+			float maxError = 0.0f;
+			String worstCase;
+
+			for (auto sr : sampleRates)
+			{
+				for (auto nf : normalisedFrequencies)
+				{
+					for (auto q : qValues)
+					{
+						for (auto gain : gainValues)
+						{
+							const double frequency = nf * sr;
+
+							auto expected = getJuceBiquadCoefficients(type, sr, frequency, q, gain);
+							auto actual = StaticBiquadSubType::makeCoefficients(type, sr, frequency, q, gain);
+
+							for (int i = 0; i < 5; i++)
+							{
+								const float e = expected.coefficients[i];
+								const float error = std::abs(actual.coefficients[i] - e) / jmax(1.0f, std::abs(e));
+
+								if (!(error <= maxError))
+								{
+									maxError = error;
+									worstCase = "samplerate: " + String(sr) + ", frequency: " + String(frequency) + ", Q: " + String(q) + ", gain: " + String(gain) + ", coefficient: " + String(i);
+								}
+							}
+						}
+					}
+				}
+			}
+
+			logMessage("Biquad type " + String(t) + " max error: " + String(maxError) + " (" + worstCase + ")");
+
+			expect(maxError < 2e-5f, "Biquad type " + String(t) + " error: " + String(maxError) + " at " + worstCase);
+		}
+	}
+
+	static IIRCoefficients getJuceBiquadCoefficients(StaticBiquadSubType::FilterType type, double sampleRate, double frequency, double q, double gain)
+	{
+		switch (type)
+		{
+		case StaticBiquadSubType::LowPass:		return IIRCoefficients::makeLowPass(sampleRate, frequency);
+		case StaticBiquadSubType::HighPass:		return IIRCoefficients::makeHighPass(sampleRate, frequency);
+		case StaticBiquadSubType::HighShelf:	return IIRCoefficients::makeHighShelf(sampleRate, frequency, q, (float)gain);
+		case StaticBiquadSubType::LowShelf:		return IIRCoefficients::makeLowShelf(sampleRate, frequency, q, (float)gain);
+		case StaticBiquadSubType::Peak:			return IIRCoefficients::makePeakFilter(sampleRate, frequency, q, (float)gain);
+		case StaticBiquadSubType::ResoLow:		return FilterEffect::makeResoLowPass(sampleRate, frequency, q);
+		case StaticBiquadSubType::numFilterTypes:
+		default:								jassertfalse; return IIRCoefficients();
+		}
+	}
+
+	template <typename F> void expectError(const String& testName, const F& f)
+	{
+		String message;
+
+		try
+		{
+			f();
+		}
+		catch (String m)
+		{
+			message = m;
+		}
+
+		expect(message.isNotEmpty(), testName + ": No error");
+	}
+
+	void expectBufferEquals(const VariantBuffer& b, std::initializer_list<float> expectedValues, const String& testName)
+	{
+		expectEquals<int>(b.size, (int)expectedValues.size(), testName + ": size mismatch");
+
+		int i = 0;
+
+		for (auto v : expectedValues)
+		{
+			if (i < b.size)
+				expectEquals<float>(b[i], v, testName + ": sample " + String(i));
+
+			i++;
+		}
+	}
+
 	void fillFloatArrayWithRandomNumbers(float *data, int numSamples)
 	{
 		for (int i = 0; i < numSamples; i++)
@@ -354,6 +539,12 @@ private:
 		testAhdsrSustain(true);
 		testAhdsrSustain(false);
 
+		testBatchedAhdsr(false);
+		testBatchedAhdsr(true);
+
+		testBatchedSimpleEnvelope(false);
+		testBatchedSimpleEnvelope(true);
+
 		testConstantModulator(false);
 		testConstantModulator(true);
 
@@ -368,6 +559,13 @@ private:
 
 		testSynthGroup();
 
+		testVoiceStealing(false);
+		testVoiceStealing(true);
+
+		testParallelVoiceRendering();
+		testParallelChildSynths();
+		testProcessorTreeVersion();
+
 		testGlobalModulators(false);
 		testGlobalModulators(true);
 		
@@ -871,6 +1069,366 @@ private:
 		expectResult(testData.isWithinErrorRange(22050, sustainLevel), "Sustain value");
 	}
 
+	void testVoiceStealing(bool useGroup)
+	{
+		beginTestWithOptionalGroup("Testing voice allocation and stealing", useGroup);
+
+		const int blockSize = 256;
+
+		Helpers::TestData data[2] = { Helpers::createTestDataWithVoiceStealing(), Helpers::createTestDataWithVoiceStealing() };
+		Array<int> voiceStates[2];
+		bool reachedVoiceLimit = false;
+
+		for (int i = 0; i < 2; i++)
+		{
+			const bool useBitMasks = i == 0;
+
+			ScopedProcessor bp = Helpers::createWithOptionalGroup(NoiseSynth::DC, useGroup);
+
+			Processor::Iterator<ModulatorSynth> iter(bp->getMainSynthChain());
+
+			while (auto s = iter.getNextProcessor())
+				s->setUseVoiceBitMasks(useBitMasks);
+
+			auto synth = Helpers::getMainSynth(bp, useGroup);
+
+			// The voice limit is lower than the number of ringing notes, so voices must be stolen
+			synth->setAttribute(ModulatorSynth::Parameters::VoiceLimit, 4.0f, dontSendNotification);
+
+			Helpers::setAttribute<SimpleEnvelope>(bp, SimpleEnvelope::Release, 200.0f);
+
+			bp->prepareToPlay((double)sampleRate, blockSize);
+
+			for (int offset = 0; offset < data[i].audioBuffer.getNumSamples(); offset += blockSize)
+			{
+				Helpers::resumeProcessing(bp, data[i], blockSize, blockSize, offset);
+
+				int numActiveVoices = 0;
+
+				// Store the event that each voice is playing after every block
+				for (int v = 0; v < synth->getNumVoices(); v++)
+				{
+					auto voice = static_cast<ModulatorSynthVoice*>(synth->getVoice(v));
+					const bool isActive = !voice->isInactive();
+
+					voiceStates[i].add(isActive ? (int)voice->getCurrentHiseEvent().getEventId() : 0);
+					numActiveVoices += isActive ? 1 : 0;
+				}
+
+				reachedVoiceLimit |= numActiveVoices >= 4;
+			}
+
+			bp = nullptr;
+		}
+
+		int numMismatches = 0;
+
+		for (int i = 0; i < jmin(voiceStates[0].size(), voiceStates[1].size()); i++)
+		{
+			if (voiceStates[0][i] != voiceStates[1][i])
+				numMismatches++;
+		}
+
+		expectEquals(voiceStates[0].size(), voiceStates[1].size(), "Voice amount mismatch");
+		expectEquals(numMismatches, 0, "The bit mask lookup starts other voices than the linear search");
+		expect(reachedVoiceLimit, "The voice limit wasn't reached");
+
+		float maxError = 0.0f;
+
+		for (int c = 0; c < 2; c++)
+		{
+			for (int i = 0; i < data[0].audioBuffer.getNumSamples(); i++)
+				maxError = jmax(maxError, std::abs(data[0].getSample(c, i) - data[1].getSample(c, i)));
+		}
+
+		// The same voices are started and stolen, so the output must be bit-identical
+		expectEquals(maxError, 0.0f, "The bit mask lookup doesn't match the linear search");
+	}
+
+	void testParallelVoiceRendering()
+	{
+		beginTest("Testing parallel voice rendering");
+
+		Helpers::TestData data[2] = { Helpers::createTestDataWithOverlappingNotes(), Helpers::createTestDataWithOverlappingNotes() };
+
+		for (int i = 0; i < 2; i++)
+		{
+			const bool renderInParallel = i == 0;
+
+			ScopedProcessor bp = new BackendProcessor(nullptr, nullptr);
+
+			bp->getParallelRenderPool().setNumWorkerThreads(renderInParallel ? 3 : 0);
+
+			ScopedPointer<SineSynth> sine = new SineSynth(bp, "TestProcessor", NUM_POLYPHONIC_VOICES);
+
+			sine->addProcessorsWhenEmpty();
+			sine->setAttribute(ModulatorSynth::Parameters::Gain, 1.0f, dontSendNotification);
+
+			bp->getMainSynthChain()->getHandler()->add(sine.release(), nullptr);
+
+			// Every voice has its own gain and pitch modulation that must be stored before the voices are rendered
+			auto pitchMod = Helpers::addVoiceModulator<SineSynth, VelocityModulator>(bp, ModulatorSynth::PitchModulation);
+			pitchMod->setIntensityFromSlider(12.0f);
+
+			Helpers::addVoiceModulator<SineSynth, VelocityModulator>(bp, ModulatorSynth::GainModulation);
+
+			Helpers::setAttribute<SimpleEnvelope>(bp, SimpleEnvelope::Attack, 10.0f);
+			Helpers::setAttribute<SimpleEnvelope>(bp, SimpleEnvelope::Release, 50.0f);
+
+			Helpers::process(bp, data[i], 512);
+
+			expect(bp->getParallelRenderPool().isEnabled() == renderInParallel, "Parallel rendering wasn't enabled");
+
+			bp = nullptr;
+		}
+
+		float maxError = 0.0f;
+
+		for (int c = 0; c < 2; c++)
+		{
+			for (int i = 0; i < data[0].audioBuffer.getNumSamples(); i++)
+				maxError = jmax(maxError, std::abs(data[0].getSample(c, i) - data[1].getSample(c, i)));
+		}
+
+		expect(data[1].audioBuffer.getMagnitude(0, 0, data[1].audioBuffer.getNumSamples()) > 0.0f, "Silent output");
+
+		// The voices are summed in the same order, so the output must be bit-identical
+		expectEquals(maxError, 0.0f, "Parallel rendering doesn't match the serial rendering");
+	}
+
+	void testParallelChildSynths()
+	{
+		beginTest("Testing parallel child synths");
+
+		Helpers::TestData data[2] = { Helpers::createTestDataWithOverlappingNotes(), Helpers::createTestDataWithOverlappingNotes() };
+
+		for (int i = 0; i < 2; i++)
+		{
+			const bool renderInParallel = i == 0;
+
+			ScopedProcessor bp = new BackendProcessor(nullptr, nullptr);
+
+			bp->getParallelRenderPool().setNumWorkerThreads(renderInParallel ? 3 : 0);
+
+			auto handler = bp->getMainSynthChain()->getHandler();
+
+			// The container can't be rendered in parallel, so it splits the other synths into two batches
+			addChildSynth<SineSynth>(bp, "Sine1", 0.5f);
+			handler->add(new GlobalModulatorContainer(bp, "Container", NUM_POLYPHONIC_VOICES), nullptr);
+			addChildSynth<NoiseSynth>(bp, "Noise", 0.25f)->setTestSignal(NoiseSynth::DC);
+			addChildSynth<SineSynth>(bp, "Sine2", 0.125f);
+			addChildSynth<SineSynth>(bp, "Sine3", 0.75f);
+
+			// The second synth uses the modulation values of the container that is rendered before
+			auto sender = Helpers::addVoiceModulator<GlobalModulatorContainer, VelocityModulator>(bp, ModulatorSynth::GainModulation);
+			auto receiver = Helpers::addVoiceModulator<NoiseSynth, GlobalVoiceStartModulator>(bp, ModulatorSynth::GainModulation);
+
+			receiver->connectToGlobalModulator("Container:" + sender->getId());
+			expect(receiver->isConnected(), "Connection failed");
+
+			Helpers::addVoiceModulator<SineSynth, VelocityModulator>(bp, ModulatorSynth::PitchModulation)->setIntensityFromSlider(7.0f);
+
+			Helpers::process(bp, data[i], 512);
+
+			bp = nullptr;
+		}
+
+		float maxError = 0.0f;
+
+		for (int c = 0; c < 2; c++)
+		{
+			for (int i = 0; i < data[0].audioBuffer.getNumSamples(); i++)
+				maxError = jmax(maxError, std::abs(data[0].getSample(c, i) - data[1].getSample(c, i)));
+		}
+
+		expect(data[1].audioBuffer.getMagnitude(0, 0, data[1].audioBuffer.getNumSamples()) > 0.0f, "Silent output");
+
+		// The synths are summed in their original order, so the output must be bit-identical
+		expectEquals(maxError, 0.0f, "Parallel child synths don't match the serial rendering");
+	}
+
+	void testProcessorTreeVersion()
+	{
+		beginTest("Testing the processor tree version");
+
+		ScopedProcessor bp1 = new BackendProcessor(nullptr, nullptr);
+		ScopedProcessor bp2 = new BackendProcessor(nullptr, nullptr);
+
+		const int version1 = bp1->getProcessorTreeVersion();
+		const int version2 = bp2->getProcessorTreeVersion();
+
+		auto s = addChildSynth<SineSynth>(bp1, "Sine", 1.0f);
+
+		expect(bp1->getProcessorTreeVersion() != version1, "Adding a synth doesn't change the version");
+		expectEquals(bp2->getProcessorTreeVersion(), version2, "Another instance changes the version");
+
+		const int versionAfterAdding = bp1->getProcessorTreeVersion();
+
+		bp1->getMainSynthChain()->getHandler()->remove(s);
+
+		expect(bp1->getProcessorTreeVersion() != versionAfterAdding, "Removing a synth doesn't change the version");
+		expectEquals(bp2->getProcessorTreeVersion(), version2, "Another instance changes the version");
+
+		bp1 = nullptr;
+		bp2 = nullptr;
+	}
+
+	template <class SynthType> static SynthType* addChildSynth(BackendProcessor* bp, const String& id, float gain)
+	{
+		ScopedPointer<SynthType> synth = new SynthType(bp, id, NUM_POLYPHONIC_VOICES);
+
+		synth->addProcessorsWhenEmpty();
+		synth->setAttribute(ModulatorSynth::Parameters::Gain, gain, dontSendNotification);
+
+		auto s = synth.get();
+		bp->getMainSynthChain()->getHandler()->add(synth.release(), nullptr);
+
+		return s;
+	}
+
+	void testBatchedAhdsr(bool useGroup)
+	{
+		beginTestWithOptionalGroup("Testing batched AHDSR envelopes", useGroup);
+
+		auto setup = [](BackendProcessor* bp, float attack, float hold, float decay, float sustainDb, float release)
+		{
+			Helpers::get<SimpleEnvelope>(bp)->setBypassed(true);
+
+			Helpers::addVoiceModulatorToOptionalGroup<AhdsrEnvelope>(bp, ModulatorSynth::GainModulation);
+
+			// Every voice gets a different sustain level
+			Helpers::addVoiceModulator<AhdsrEnvelope, VelocityModulator>(bp, AhdsrEnvelope::SustainLevelChain);
+
+			Helpers::setAttribute<AhdsrEnvelope>(bp, AhdsrEnvelope::Attack, attack);
+			Helpers::setAttribute<AhdsrEnvelope>(bp, AhdsrEnvelope::Hold, hold);
+			Helpers::setAttribute<AhdsrEnvelope>(bp, AhdsrEnvelope::Decay, decay);
+			Helpers::setAttribute<AhdsrEnvelope>(bp, AhdsrEnvelope::Sustain, sustainDb);
+			Helpers::setAttribute<AhdsrEnvelope>(bp, AhdsrEnvelope::Release, release);
+		};
+
+		expectBatchedEnvelopesMatch("All stages", useGroup, [&](BackendProcessor* bp)
+		{
+			setup(bp, 20.0f, 10.0f, 50.0f, -12.0f, 40.0f);
+			Helpers::setAttribute<AhdsrEnvelope>(bp, AhdsrEnvelope::AttackCurve, 0.9f);
+			Helpers::setAttribute<AhdsrEnvelope>(bp, AhdsrEnvelope::DecayCurve, 0.1f);
+		});
+
+		expectBatchedEnvelopesMatch("Zero times", useGroup, [&](BackendProcessor* bp)
+		{
+			setup(bp, 0.0f, 0.0f, 0.0f, -6.0f, 0.0f);
+		});
+
+		expectBatchedEnvelopesMatch("Zero attack and hold", useGroup, [&](BackendProcessor* bp)
+		{
+			setup(bp, 0.0f, 0.0f, 30.0f, -18.0f, 60.0f);
+		});
+
+		expectBatchedEnvelopesMatch("Attack level below sustain", useGroup, [&](BackendProcessor* bp)
+		{
+			setup(bp, 30.0f, 0.0f, 50.0f, -6.0f, 80.0f);
+			Helpers::setAttribute<AhdsrEnvelope>(bp, AhdsrEnvelope::AttackLevel, -12.0f);
+		});
+
+		expectBatchedEnvelopesMatch("Decay to silence", useGroup, [&](BackendProcessor* bp)
+		{
+			setup(bp, 5.0f, 0.0f, 30.0f, -100.0f, 40.0f);
+		});
+
+		expectBatchedEnvelopesMatch("Sustain change", useGroup, [&](BackendProcessor* bp)
+		{
+			setup(bp, 20.0f, 10.0f, 50.0f, -12.0f, 40.0f);
+		}, [](BackendProcessor* bp)
+		{
+			Helpers::setAttribute<AhdsrEnvelope>(bp, AhdsrEnvelope::Sustain, -3.0f);
+		});
+
+		// The monophonic envelope isn't batched, but it's the only mode with the retrigger stage
+		expectBatchedEnvelopesMatch("Monophonic retrigger", useGroup, [&](BackendProcessor* bp)
+		{
+			setup(bp, 20.0f, 10.0f, 50.0f, -12.0f, 40.0f);
+			Helpers::setAttribute<AhdsrEnvelope>(bp, EnvelopeModulator::Monophonic, 1.0f);
+			Helpers::setAttribute<AhdsrEnvelope>(bp, EnvelopeModulator::Retrigger, 1.0f);
+		});
+	}
+
+	void testBatchedSimpleEnvelope(bool useGroup)
+	{
+		beginTestWithOptionalGroup("Testing batched simple envelopes", useGroup);
+
+		auto setup = [](BackendProcessor* bp, float attack, float release, bool linear)
+		{
+			Helpers::setAttribute<SimpleEnvelope>(bp, SimpleEnvelope::Attack, attack);
+			Helpers::setAttribute<SimpleEnvelope>(bp, SimpleEnvelope::Release, release);
+			Helpers::setAttribute<SimpleEnvelope>(bp, SimpleEnvelope::LinearMode, linear ? 1.0f : 0.0f);
+		};
+
+		expectBatchedEnvelopesMatch("Linear", useGroup, [&](BackendProcessor* bp)
+		{
+			setup(bp, 20.0f, 40.0f, true);
+		});
+
+		expectBatchedEnvelopesMatch("Exponential", useGroup, [&](BackendProcessor* bp)
+		{
+			setup(bp, 20.0f, 40.0f, false);
+		});
+
+		expectBatchedEnvelopesMatch("Zero times", useGroup, [&](BackendProcessor* bp)
+		{
+			setup(bp, 0.0f, 0.0f, true);
+		});
+
+		expectBatchedEnvelopesMatch("Monophonic retrigger", useGroup, [&](BackendProcessor* bp)
+		{
+			setup(bp, 20.0f, 40.0f, false);
+			Helpers::setAttribute<SimpleEnvelope>(bp, EnvelopeModulator::Monophonic, 1.0f);
+			Helpers::setAttribute<SimpleEnvelope>(bp, EnvelopeModulator::Retrigger, 1.0f);
+		});
+	}
+
+	/** Renders overlapping voices with and without the batched envelope calculation and compares the output.
+	*
+	*	The batched calculation falls back to the state machine when a voice reaches one of the stage limits,
+	*	so the output is supposed to be the same for every stage transition.
+	*/
+	void expectBatchedEnvelopesMatch(const String& testName, bool useGroup, const std::function<void(BackendProcessor*)>& setup,
+									 const std::function<void(BackendProcessor*)>& changeInTheMiddle = {})
+	{
+		const int blockSize = 512;
+		const int numSamplesBeforeChange = 22 * blockSize;
+
+		Helpers::TestData data[2] = { Helpers::createTestDataWithOverlappingNotes(), Helpers::createTestDataWithOverlappingNotes() };
+
+		for (int i = 0; i < 2; i++)
+		{
+			ScopedProcessor bp = Helpers::createWithOptionalGroup(NoiseSynth::DC, useGroup);
+
+			const bool useBatchedEnvelopes = i == 0;
+
+			Processor::Iterator<ModulatorSynth> iter(bp->getMainSynthChain());
+
+			while (auto synth = iter.getNextProcessor())
+				synth->setUseBatchedEnvelopes(useBatchedEnvelopes);
+
+			setup(bp);
+
+			if (changeInTheMiddle)
+			{
+				Helpers::process(bp, data[i], blockSize, numSamplesBeforeChange);
+				changeInTheMiddle(bp);
+				Helpers::resumeProcessing(bp, data[i], blockSize, -1, numSamplesBeforeChange);
+			}
+			else
+			{
+				Helpers::process(bp, data[i], blockSize);
+			}
+
+			bp = nullptr;
+		}
+
+		expect(data[1].audioBuffer.getMagnitude(0, 0, data[1].audioBuffer.getNumSamples()) > 0.0f, testName + ": silent output");
+		expectResult(data[1].matches(data[0], this, -100.0f), testName + ": batched output doesn't match");
+	}
+
 	void testLFOSeq(bool useGroup)
 	{
 		beginTestWithOptionalGroup("Testing LFO Seq", useGroup);
@@ -1362,6 +1920,76 @@ private:
 			return d;
 		}
 
+		static TestData createTestDataWithOverlappingNotes()
+		{
+			TestData d;
+
+			d.audioBuffer.setSize(2, sampleRate);
+			d.audioBuffer.clear();
+
+			// Staggered notes with different velocities, so the voices are in different stages within the same block
+			for (int i = 0; i < 8; i++)
+			{
+				d.midiBuffer.addEvent(MidiMessage::noteOn(1, 60 + i, 0.3f + 0.1f * (float)i), 100 + i * 1111);
+				d.midiBuffer.addEvent(MidiMessage::noteOff(1, 60 + i), 4000 + i * 2777);
+			}
+
+			// A note that is released during the attack
+			d.midiBuffer.addEvent(MidiMessage::noteOn(1, 72, 1.0f), 500);
+			d.midiBuffer.addEvent(MidiMessage::noteOff(1, 72), 700);
+
+			// Restart a note during its release and another one while it's still pressed
+			d.midiBuffer.addEvent(MidiMessage::noteOn(1, 60, 0.8f), 5000);
+			d.midiBuffer.addEvent(MidiMessage::noteOff(1, 60), 30000);
+			d.midiBuffer.addEvent(MidiMessage::noteOn(1, 61, 0.5f), 6000);
+
+			// Two voices that start at the same sample
+			d.midiBuffer.addEvent(MidiMessage::noteOn(1, 80, 0.6f), 15000);
+			d.midiBuffer.addEvent(MidiMessage::noteOn(1, 84, 0.9f), 15000);
+			d.midiBuffer.addEvent(MidiMessage::noteOff(1, 80), 20000);
+			d.midiBuffer.addEvent(MidiMessage::noteOff(1, 84), 20000);
+
+			return d;
+		}
+
+		static TestData createTestDataWithVoiceStealing()
+		{
+			TestData d;
+
+			d.audioBuffer.setSize(2, sampleRate);
+			d.audioBuffer.clear();
+
+			// More held notes than the voice limit, so the oldest voice must be stolen
+			for (int i = 0; i < 10; i++)
+			{
+				d.midiBuffer.addEvent(MidiMessage::noteOn(1, 48 + i, 0.5f + 0.05f * (float)i), 100 + i * 1500);
+				d.midiBuffer.addEvent(MidiMessage::noteOff(1, 48 + i), 6000 + i * 1500);
+			}
+
+			// Retrigger a note while it's still pressed and another one while it's releasing
+			d.midiBuffer.addEvent(MidiMessage::noteOn(1, 57, 1.0f), 15000);
+			d.midiBuffer.addEvent(MidiMessage::noteOn(1, 56, 0.7f), 21000);
+
+			// A chord with more notes than the voice limit
+			for (int i = 0; i < 6; i++)
+				d.midiBuffer.addEvent(MidiMessage::noteOn(1, 72 + i, 0.8f), 25000);
+
+			for (int i = 0; i < 6; i++)
+				d.midiBuffer.addEvent(MidiMessage::noteOff(1, 72 + i), 30000 + i * 100);
+
+			d.midiBuffer.addEvent(MidiMessage::noteOff(1, 56), 32000);
+			d.midiBuffer.addEvent(MidiMessage::noteOff(1, 57), 32000);
+
+			// Restart the same note quickly so that voices are freed and reused in the releasing state
+			for (int i = 0; i < 8; i++)
+			{
+				d.midiBuffer.addEvent(MidiMessage::noteOn(1, 64, 0.6f), 35000 + i * 600);
+				d.midiBuffer.addEvent(MidiMessage::noteOff(1, 64), 35300 + i * 600);
+			}
+
+			return d;
+		}
+
 		static void process(BackendProcessor* bp, TestData& data, int blockSize, int numToProcess=-1)
 		{
 			bp->prepareToPlay((double)sampleRate, blockSize);
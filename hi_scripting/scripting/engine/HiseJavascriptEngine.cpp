@@ -330,6 +330,12 @@ public:
 		loc.throwError("Illegal operation in audio thread: " + getOperationName(operationType));
 	}
 
+	/** Changes the location that is used for the error message. */
+	void setLocation(const CodeLocation& newLocation)
+	{
+		loc = newLocation;
+	}
+
 private:
 
 	AudioThreadGuard::ScopedHandlerSetter setter;
@@ -339,6 +345,8 @@ private:
 struct HiseJavascriptEngine::RootObject::ScriptAudioThreadGuard
 {
 	ScriptAudioThreadGuard(const CodeLocation& /*location*/) {};
+
+	void setLocation(const CodeLocation& /*newLocation*/) {};
 };
 #endif
 
@@ -853,6 +861,20 @@ void HiseJavascriptEngine::setCallbackParameter(int callbackIndex, int parameter
 	root->hiseSpecialData.callbackNEW[callbackIndex]->setParameterValue(parameterIndex, newValue);
 }
 
+void HiseJavascriptEngine::setUseBytecode(int callbackIndex, bool shouldUseBytecode)
+{
+	if (auto c = root->hiseSpecialData.callbackNEW[callbackIndex])
+		c->setUseBytecode(shouldUseBytecode);
+}
+
+bool HiseJavascriptEngine::isUsingBytecode(int callbackIndex) const
+{
+	if (auto c = root->hiseSpecialData.callbackNEW[callbackIndex])
+		return c->isUsingBytecode();
+
+	return false;
+}
+
 DebugInformation* HiseJavascriptEngine::getDebugInformation(int index)
 {
 	return root->hiseSpecialData.getDebugInformation(index);
@@ -169,6 +169,15 @@ public:
 
 	void setCallbackParameter(int callbackIndex, int parameterIndex, const var& newValue);
 
+	/** Compiles the callback into bytecode or switches it back to the syntax tree.
+	*
+	*	The default is ENABLE_SCRIPTING_BYTECODE. This is used by the unit tests to run the same callback with both.
+	*/
+	void setUseBytecode(int callbackIndex, bool shouldUseBytecode);
+
+	/** Returns true if the callback is executed as bytecode. */
+	bool isUsingBytecode(int callbackIndex) const;
+
 	DebugInformation*getDebugInformation(int index);
 
 	var getScriptObject(const Identifier &id) const;
@@ -505,6 +514,10 @@ public:
 		struct CallbackLocalStatement;  struct CallbackLocalReference;  struct ExternalCFunction;
 		struct NativeJIT;				struct IsDefinedTest;
 
+		// Bytecode
+
+		struct BytecodeProgram;
+
 		// Parser classes
 
 		struct TokenIterator;
@@ -545,10 +558,17 @@ public:
 
 			Callback(const Identifier &id, int numArgs, double bufferTime_);
 
+			~Callback();
+
 			var perform(RootObject *root);
 
 			void setStatements(BlockStatement *s) noexcept;
 
+			/** Compiles the statements into bytecode or removes the compiled program. */
+			void setUseBytecode(bool shouldUseBytecode);
+
+			bool isUsingBytecode() const noexcept { return program != nullptr; }
+
 			bool isDefined() const noexcept{ return isCallbackDefined; }
 
 			const Identifier &getName() const { return callbackName; }
@@ -579,9 +599,20 @@ public:
 			String getDebugValue() const override 
 			{
 				const double percentage = lastExecutionTime / bufferTime * 100.0;
+
+#if JUCE_ENABLE_ALLOCATION_ARENA
+				if (arena != nullptr)
+					return String(percentage, 2) + "% (Arena: " + arena->getStatistics().toString() + ")";
+#endif
+
 				return String(percentage, 2) + "%";
 			}
 
+#if JUCE_ENABLE_ALLOCATION_ARENA
+			/** Returns the memory that is used for allocations during the callback (nullptr if the callback is not defined). */
+			AllocationArena* getArena() const noexcept { return arena.get(); }
+#endif
+
 			var createDynamicObjectForBreakpoint()
 			{
 				DynamicObject::Ptr object = new DynamicObject();
@@ -629,7 +660,19 @@ public:
 
 		private:
 
+			void performStatements(const Scope& s, var* returnValue);
+
 			ScopedPointer<BlockStatement> statements;
+
+			/** The compiled version of the statements (nullptr if the statements are executed by the tree). */
+			ScopedPointer<BytecodeProgram> program;
+
+#if JUCE_ENABLE_ALLOCATION_ARENA
+			AllocationArena::Ptr arena;
+#endif
+
+			bool useBytecode = ENABLE_SCRIPTING_BYTECODE;
+
 			double lastExecutionTime;
 			const Identifier callbackName;
 			int numArgs;
@@ -954,6 +997,12 @@ private:
 
 	ReferenceCountedObjectPtr<RootObject> root;
 	void prepareTimeout() const noexcept;
+
+	/** Checks whether the callback runs on one of the audio threads of the processor. */
+	bool isExecutedOnAudioThread() const;
+
+	/** Resolved once in the constructor so that the callback doesn't have to look it up. */
+	MainController* mc = nullptr;
 	
 	Array<WeakReference<Breakpoint::Listener>> breakpointListeners;
 
@@ -46,6 +46,9 @@ HiseJavascriptEngine::HiseJavascriptEngine(JavascriptProcessor *p) : maximumExec
 {
 	root->hiseSpecialData.setProcessor(p);
 
+	if (auto processor = dynamic_cast<Processor*>(p))
+		mc = processor->getMainController();
+
 	registerNativeObject(RootObject::ObjectClass::getClassName(), new RootObject::ObjectClass());
 	registerNativeObject(RootObject::ArrayClass::getClassName(), new RootObject::ArrayClass());
 	registerNativeObject(RootObject::StringClass::getClassName(), new RootObject::StringClass());
@@ -280,6 +283,12 @@ var HiseJavascriptEngine::RootObject::Scope::findFunctionCall(const CodeLocation
 		if (var* m = findRootClassProperty(ArrayClass::getClassName(), functionName))
 			return *m;
 
+	// The buffer methods are stored in the factory object, but not as its properties
+	if (targetObject.isBuffer())
+		if (auto f = dynamic_cast<VariantBuffer::Factory*>(root->getProperty(VariantBuffer::getName()).getDynamicObject()))
+			if (const var* m = f->getBufferMethod(functionName))
+				return *m;
+
 	if (var* m = findRootClassProperty(ObjectClass::getClassName(), functionName))
 		return *m;
 
@@ -728,7 +737,6 @@ juce::String::CharPointerType HiseJavascriptEngine::RootObject::Callback::getPro
 var HiseJavascriptEngine::executeCallback(int callbackIndex, Result *result)
 {
 #if JUCE_DEBUG
-	auto mc = dynamic_cast<Processor*>(root->hiseSpecialData.processor)->getMainController();
 	LockHelpers::noMessageThreadBeyondInitialisation(mc);
 #endif
 
@@ -744,6 +752,11 @@ var HiseJavascriptEngine::executeCallback(int callbackIndex, Result *result)
 		{
 			prepareTimeout();
 
+#if JUCE_ENABLE_ALLOCATION_ARENA
+			// The arena is only used on the audio thread so that long living objects created in eg. prepareToPlay don't pin it.
+			AllocationArena::ScopedActivation arenaActivation(isExecutedOnAudioThread() ? c->getArena() : nullptr);
+#endif
+
 			var returnVal = c->perform(root);
 
 			if (result != nullptr) *result = Result::ok();
@@ -784,10 +797,62 @@ var HiseJavascriptEngine::executeCallback(int callbackIndex, Result *result)
 	return var();
 }
 
+HiseJavascriptEngine::RootObject::Callback::~Callback()
+{
+	program = nullptr;
+	statements = nullptr;
+}
+
 void HiseJavascriptEngine::RootObject::Callback::setStatements(BlockStatement *s) noexcept
 {
+	program = nullptr;
 	statements = s;
 	isCallbackDefined = s->statements.size() != 0;
+
+	setUseBytecode(useBytecode);
+
+#if JUCE_ENABLE_ALLOCATION_ARENA
+	if (isCallbackDefined && arena == nullptr)
+		arena = new AllocationArena((size_t)SCRIPTING_CALLBACK_ARENA_SIZE * 1024);
+#endif
+}
+
+bool HiseJavascriptEngine::isExecutedOnAudioThread() const
+{
+	if (mc == nullptr)
+		return false;
+
+	// A thread never stops being an audio thread, so we only need to search the thread list once.
+	// The negative result isn't cached because the audio threads are registered lazily.
+	static thread_local const MainController* lastAudioThreadController = nullptr;
+
+	if (lastAudioThreadController == mc)
+		return true;
+
+	if (mc->getKillStateHandler().getCurrentThread() == MainController::KillStateHandler::AudioThread)
+	{
+		lastAudioThreadController = mc;
+		return true;
+	}
+
+	return false;
+}
+
+void HiseJavascriptEngine::RootObject::Callback::setUseBytecode(bool shouldUseBytecode)
+{
+	useBytecode = shouldUseBytecode;
+	program = nullptr;
+
+	if (useBytecode && statements != nullptr)
+		program = BytecodeProgram::compile(statements);
+}
+
+void HiseJavascriptEngine::RootObject::Callback::performStatements(const Scope& s, var* returnValue)
+{
+	if (program != nullptr)
+		program->perform(s, returnValue);
+	else
+		statements->perform(s, returnValue);
 }
 
 
@@ -805,14 +870,14 @@ var HiseJavascriptEngine::RootObject::Callback::perform(RootObject *root)
 
 
 
-	statements->perform(s, &returnValue);
+	performStatements(s, &returnValue);
 
 	root->removeFromCallStack(callbackName);
 
 	const double post = Time::getMillisecondCounterHiRes();
 	lastExecutionTime = post - pre;
 #else
-	statements->perform(s, &returnValue);
+	performStatements(s, &returnValue);
 #endif
 
 	return returnValue;
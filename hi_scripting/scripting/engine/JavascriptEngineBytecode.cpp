@@ -0,0 +1,850 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+namespace hise { using namespace juce;
+
+/** A register based bytecode version of a callback's statement tree.
+*
+*	The compiler lowers the control flow (blocks, if-statements and loops), the arithmetic and comparison operators,
+*	assignments, API calls and the access to registers, callback parameters and callback locals into a flat
+*	instruction list that is executed by a single dispatch loop. Intermediate values are stored in a preallocated
+*	register file, so there is no recursion and no temporary var on the stack for these nodes.
+*
+*	Every other node is kept as it is and executed by the tree (Evaluate, Assign and Perform instructions), so the
+*	behaviour of the script is exactly the same. All instructions that can fail refer to the original node, so
+*	the error locations don't change.
+*/
+struct HiseJavascriptEngine::RootObject::BytecodeProgram
+{
+	enum class OpCode : uint8
+	{
+		LoadConstant = 0,	///< dst = constants[index]
+		LoadPointer,		///< dst = *pointers[index]
+		StorePointer,		///< *pointers[index] = a
+		Evaluate,			///< dst = nodes[index]->getResult()
+		Assign,				///< nodes[index]->assign(a)
+		Perform,			///< nodes[index]->perform(), a is the index of the enclosing loop or -1
+		Add,				///< dst = a + b, nodes[index] is the BinaryOperator used for non numeric types
+		Subtract,
+		Multiply,
+		LessThan,
+		LessThanOrEqual,
+		GreaterThan,
+		GreaterThanOrEqual,
+		Equals,
+		NotEquals,
+		BinaryOperation,	///< dst = nodes[index]->getResultFor(a, b)
+		ToBool,				///< dst = (bool)a
+		Jump,				///< jumps to target
+		JumpIfFalse,		///< jumps to target if a is false
+		JumpIfTrue,			///< jumps to target if a is true
+		ApiCall,			///< dst = nodes[index]->callWithArguments(a...a+b)
+		CheckTimeout,		///< checks the timeout with the location of nodes[index]
+		StatementGuard,		///< sets the location of the audio thread guard to nodes[index]
+		Return,				///< returns a
+		ReturnCode,			///< returns index as result code (a break or continue outside of a loop)
+		End
+	};
+
+	struct Instruction
+	{
+		OpCode op;
+		int16 dst;
+		int16 a;
+		int16 b;
+		int index;
+		int target;
+	};
+
+	/** The jump targets for break and continue statements that are performed by the tree. */
+	struct LoopTargets
+	{
+		int breakTarget;
+		int continueTarget;
+	};
+
+	/** Compiles the given statements. Returns nullptr if the root block has to be executed by the tree. */
+	static BytecodeProgram* compile(const BlockStatement* statements);
+
+	/** Executes the program. This returns the same result as statements->perform(). */
+	Statement::ResultCode perform(const Scope& s, var* returnValue) const;
+
+private:
+
+	struct Compiler;
+
+	/** Marks the program as running and clears the registers afterwards, so that no object is kept alive. */
+	struct ScopedExecution
+	{
+		ScopedExecution(const BytecodeProgram& p_) :
+			p(p_)
+		{
+			p.isRunning = true;
+		}
+
+		~ScopedExecution()
+		{
+			for (int i = 0; i < p.registers.size(); i++)
+				p.registers.getReference(i) = var();
+
+			p.isRunning = false;
+		}
+
+		const BytecodeProgram& p;
+	};
+
+	struct Operations
+	{
+		struct Add				  { template <typename T> T operator()(T a, T b) const { return a + b; } };
+		struct Subtract			  { template <typename T> T operator()(T a, T b) const { return a - b; } };
+		struct Multiply			  { template <typename T> T operator()(T a, T b) const { return a * b; } };
+		struct LessThan			  { template <typename T> bool operator()(T a, T b) const { return a < b; } };
+		struct LessThanOrEqual	  { template <typename T> bool operator()(T a, T b) const { return a <= b; } };
+		struct GreaterThan		  { template <typename T> bool operator()(T a, T b) const { return a > b; } };
+		struct GreaterThanOrEqual { template <typename T> bool operator()(T a, T b) const { return a >= b; } };
+		struct Equals			  { template <typename T> bool operator()(T a, T b) const { return a == b; } };
+		struct NotEquals		  { template <typename T> bool operator()(T a, T b) const { return a != b; } };
+	};
+
+	/** Calculates the operation without the virtual calls of the BinaryOperator if the node is specialised for numbers.
+	*
+	*	This uses the same specialisation as BinaryOperator::getResultFor(), which is also called for all operands that
+	*	don't match the specialisation (so it can update it). The result has the same type as the result of 
+	*	BinaryOperator::getWithInts() / getWithDoubles().
+	*/
+	template <class OperationType> static var applyOperation(const Statement* node, const var& a, const var& b)
+	{
+		using OperandTypes = BinaryOperatorBase::OperandTypes;
+
+		auto bo = static_cast<const BinaryOperator*>(node);
+
+		switch (bo->getSpecialisation())
+		{
+		case OperandTypes::Integers:
+			if (BinaryOperatorBase::isInteger(a) && BinaryOperatorBase::isInteger(b))
+				return var(OperationType()((int64)a, (int64)b));
+			break;
+		case OperandTypes::Doubles:
+			if (a.isDouble() && b.isDouble())
+				return var(OperationType()((double)a, (double)b));
+			break;
+		case OperandTypes::Mixed:
+			if (BinaryOperatorBase::getOperandTypes(a, b) == OperandTypes::Mixed)
+				return var(OperationType()((double)a, (double)b));
+			break;
+		case OperandTypes::Generic:
+			return bo->getResultWithDynamicTypes(a, b);
+		case OperandTypes::Unknown:
+		default:
+			break;
+		}
+
+		return bo->getResultFor(a, b);
+	}
+
+	BytecodeProgram(const BlockStatement* statements_) :
+		statements(statements_)
+	{}
+
+	Array<Instruction> code;
+	Array<LoopTargets> loops;
+
+	Array<const Statement*> nodes;
+	Array<const var*> constants;
+	Array<var*> pointers;
+
+	mutable Array<var> registers;
+	mutable bool isRunning = false;
+
+	const BlockStatement* statements;
+
+	JUCE_DECLARE_NON_COPYABLE(BytecodeProgram);
+};
+
+struct HiseJavascriptEngine::RootObject::BytecodeProgram::Compiler
+{
+	Compiler(BytecodeProgram& p_) :
+		p(p_)
+	{}
+
+	/** The position of the jump instructions of a loop that need to be resolved when the loop is compiled. */
+	struct LoopLabels
+	{
+		int loopIndex;
+		Array<int> breakJumps;
+		Array<int> continueJumps;
+	};
+
+	bool compileProgram()
+	{
+		if (!canCompileBlock(p.statements))
+			return false;
+
+		compileBlock(p.statements);
+		emit(OpCode::End);
+
+		// The instruction format stores the registers as 16 bit integers
+		if (numRegisters > std::numeric_limits<int16>::max())
+			return false;
+
+		p.registers.insertMultiple(0, var(), numRegisters);
+		return true;
+	}
+
+	static bool canCompileBlock(const BlockStatement* b)
+	{
+		if (!b->lockStatements.isEmpty())
+			return false;
+
+		// Let the tree throw the breakpoint with the local scope
+		for (auto st : b->statements)
+			if (st->breakpointReference.index != -1)
+				return false;
+
+		return true;
+	}
+
+	// ================================================================================================ Statements
+
+	void compileStatement(const Statement* st)
+	{
+		if (st == nullptr)
+			return;
+
+		if (auto b = dynamic_cast<const BlockStatement*>(st))
+		{
+			if (canCompileBlock(b))
+				compileBlock(b);
+			else
+				emitPerform(st);
+		}
+		else if (auto is = dynamic_cast<const IfStatement*>(st))
+			compileIf(is);
+		else if (auto ls = dynamic_cast<const LoopStatement*>(st))
+		{
+			// The iterator names need the loop object in the scope, so for ... in loops are executed by the tree
+			if (ls->isIterator)
+				emitPerform(st);
+			else if (ls->isDoLoop)
+				compileDoLoop(ls);
+			else
+				compileLoop(ls);
+		}
+		else if (auto rs = dynamic_cast<const ReturnStatement*>(st))
+		{
+			const int r = allocateRegister();
+			compileExpression(rs->returnValue, r);
+			emit(OpCode::Return, 0, r);
+			releaseRegisters(r);
+		}
+		else if (dynamic_cast<const BreakStatement*>(st) != nullptr)
+			emitLoopJump(true);
+		else if (dynamic_cast<const ContinueStatement*>(st) != nullptr)
+			emitLoopJump(false);
+		else if (auto cl = dynamic_cast<const CallbackLocalStatement*>(st))
+		{
+			if (auto ptr = cl->parentCallback->localProperties.getVarPointer(cl->name))
+			{
+				const int r = allocateRegister();
+				compileExpression(cl->initialiser, r);
+				emit(OpCode::StorePointer, 0, r, 0, addPointer(ptr));
+				releaseRegisters(r);
+			}
+			else
+				emitPerform(st);
+		}
+		else if (auto e = dynamic_cast<const Expression*>(st))
+		{
+			const int r = allocateRegister();
+			compileExpression(e, r);
+			releaseRegisters(r);
+		}
+		else if (typeid(*st) != typeid(Statement))
+			emitPerform(st);
+
+		// An empty statement doesn't need an instruction
+	}
+
+	void compileBlock(const BlockStatement* b)
+	{
+		for (auto st : b->statements)
+		{
+			emitStatementGuard(st);
+			compileStatement(st);
+		}
+	}
+
+	void compileIf(const IfStatement* is)
+	{
+		const int r = allocateRegister();
+		compileExpression(is->condition, r);
+		const int jumpToFalseBranch = emit(OpCode::JumpIfFalse, 0, r);
+		releaseRegisters(r);
+
+		compileStatement(is->trueBranch);
+
+		if (isEmptyStatement(is->falseBranch))
+		{
+			setJumpTarget(jumpToFalseBranch, getPosition());
+		}
+		else
+		{
+			const int jumpToEnd = emit(OpCode::Jump);
+			setJumpTarget(jumpToFalseBranch, getPosition());
+			compileStatement(is->falseBranch);
+			setJumpTarget(jumpToEnd, getPosition());
+		}
+	}
+
+	/** Compiles a for or while loop.
+	*
+	*	This follows the order of LoopStatement::perform(): condition, timeout check, body, iterator.
+	*/
+	void compileLoop(const LoopStatement* ls)
+	{
+		compileStatement(ls->initialiser);
+
+		const int start = getPosition();
+
+		emitStatementGuard(ls);
+
+		int jumpToEnd = -1;
+
+		if (!isAlwaysTrue(ls->condition))
+		{
+			const int r = allocateRegister();
+			compileExpression(ls->condition, r);
+			jumpToEnd = emit(OpCode::JumpIfFalse, 0, r);
+			releaseRegisters(r);
+		}
+
+		emit(OpCode::CheckTimeout, 0, 0, 0, addNode(ls));
+
+		LoopLabels labels = compileLoopBody(ls);
+
+		const int continueTarget = getPosition();
+
+		emitStatementGuard(ls);
+		compileStatement(ls->iterator);
+		const int jumpToStart = emit(OpCode::Jump);
+		setJumpTarget(jumpToStart, start);
+
+		const int breakTarget = getPosition();
+
+		if (jumpToEnd != -1)
+			setJumpTarget(jumpToEnd, breakTarget);
+
+		resolveLoopLabels(labels, breakTarget, continueTarget);
+	}
+
+	/** Compiles a do-while loop.
+	*
+	*	A continue statement skips the condition of a do-while loop (see LoopStatement::perform()), so it jumps to
+	*	a second copy of the iterator that goes right back to the start.
+	*/
+	void compileDoLoop(const LoopStatement* ls)
+	{
+		compileStatement(ls->initialiser);
+
+		const int start = getPosition();
+
+		emit(OpCode::CheckTimeout, 0, 0, 0, addNode(ls));
+
+		LoopLabels labels = compileLoopBody(ls);
+
+		emitStatementGuard(ls);
+		compileStatement(ls->iterator);
+
+		const int r = allocateRegister();
+		compileExpression(ls->condition, r);
+		const int jumpToStart = emit(OpCode::JumpIfTrue, 0, r);
+		setJumpTarget(jumpToStart, start);
+		releaseRegisters(r);
+
+		const int jumpToEnd = emit(OpCode::Jump);
+
+		const int continueTarget = getPosition();
+
+		emitStatementGuard(ls);
+		compileStatement(ls->iterator);
+		const int jumpToStartAfterContinue = emit(OpCode::Jump);
+		setJumpTarget(jumpToStartAfterContinue, start);
+
+		const int breakTarget = getPosition();
+		setJumpTarget(jumpToEnd, breakTarget);
+
+		resolveLoopLabels(labels, breakTarget, continueTarget);
+	}
+
+	LoopLabels compileLoopBody(const LoopStatement* ls)
+	{
+		LoopLabels labels;
+		labels.loopIndex = p.loops.size();
+		p.loops.add({ -1, -1 });
+
+		loopStack.add(&labels);
+		compileStatement(ls->body);
+		loopStack.removeLast();
+
+		return labels;
+	}
+
+	void resolveLoopLabels(const LoopLabels& labels, int breakTarget, int continueTarget)
+	{
+		for (auto j : labels.breakJumps)
+			setJumpTarget(j, breakTarget);
+
+		for (auto j : labels.continueJumps)
+			setJumpTarget(j, continueTarget);
+
+		p.loops.getReference(labels.loopIndex) = { breakTarget, continueTarget };
+	}
+
+	void emitLoopJump(bool isBreak)
+	{
+		if (loopStack.isEmpty())
+		{
+			// The block statement passes this result code to the caller
+			emit(OpCode::ReturnCode, 0, 0, 0, isBreak ? Statement::breakWasHit : Statement::continueWasHit);
+			return;
+		}
+
+		auto labels = loopStack.getLast();
+		const int j = emit(OpCode::Jump);
+
+		if (isBreak)
+			labels->breakJumps.add(j);
+		else
+			labels->continueJumps.add(j);
+	}
+
+	void emitPerform(const Statement* st)
+	{
+		const int loopIndex = loopStack.isEmpty() ? -1 : loopStack.getLast()->loopIndex;
+		emit(OpCode::Perform, 0, loopIndex, 0, addNode(st));
+	}
+
+	void emitStatementGuard(const Statement* st)
+	{
+#if ENABLE_SCRIPTING_BREAKPOINTS
+		// The tree creates a ScriptAudioThreadGuard for each statement of a block
+		emit(OpCode::StatementGuard, 0, 0, 0, addNode(st));
+#else
+		ignoreUnused(st);
+#endif
+	}
+
+	// ================================================================================================ Expressions
+
+	/** Compiles the expression so that its result ends up in the register dst. */
+	void compileExpression(const Expression* e, int dst)
+	{
+		if (auto lv = dynamic_cast<const LiteralValue*>(e))
+			emit(OpCode::LoadConstant, dst, 0, 0, addConstant(&lv->value));
+		else if (auto rn = dynamic_cast<const RegisterName*>(e))
+			emit(OpCode::LoadPointer, dst, 0, 0, addPointer(rn->data));
+		else if (auto cp = dynamic_cast<const CallbackParameterReference*>(e))
+			emit(OpCode::LoadPointer, dst, 0, 0, addPointer(cp->data));
+		else if (auto cl = dynamic_cast<const CallbackLocalReference*>(e))
+		{
+			if (auto ptr = cl->parentCallback->localProperties.getVarPointer(cl->name))
+				emit(OpCode::LoadPointer, dst, 0, 0, addPointer(ptr));
+			else
+				emit(OpCode::Evaluate, dst, 0, 0, addNode(e));
+		}
+		else if (auto bo = dynamic_cast<const BinaryOperator*>(e))
+			compileBinaryOperator(bo, dst);
+		else if (auto la = dynamic_cast<const LogicalAndOp*>(e))
+			compileLogicalOperator(la, dst, true);
+		else if (auto lo = dynamic_cast<const LogicalOrOp*>(e))
+			compileLogicalOperator(lo, dst, false);
+		else if (auto co = dynamic_cast<const ConditionalOp*>(e))
+			compileConditional(co, dst);
+		else if (auto pa = dynamic_cast<const PostAssignment*>(e))
+		{
+			compileExpression(pa->target, dst);
+
+			const int r = allocateRegister();
+			compileExpression(pa->newValue, r);
+			emitAssignment(pa->target, r);
+			releaseRegisters(r);
+		}
+		else if (auto sa = dynamic_cast<const SelfAssignment*>(e))
+		{
+			compileExpression(sa->newValue, dst);
+			emitAssignment(sa->target, dst);
+		}
+		else if (auto as = dynamic_cast<const Assignment*>(e))
+		{
+			compileExpression(as->newValue, dst);
+			emitAssignment(as->target, dst);
+		}
+		else if (auto ac = dynamic_cast<const ApiCall*>(e))
+			compileApiCall(ac, dst);
+		else
+			emit(OpCode::Evaluate, dst, 0, 0, addNode(e));
+	}
+
+	void compileBinaryOperator(const BinaryOperator* bo, int dst)
+	{
+		compileExpression(bo->lhs, dst);
+
+		const int r = allocateRegister();
+		compileExpression(bo->rhs, r);
+		emit(getOpCode(bo), dst, dst, r, addNode(bo));
+		releaseRegisters(r);
+	}
+
+	static OpCode getOpCode(const BinaryOperator* bo)
+	{
+		if (dynamic_cast<const AdditionOp*>(bo) != nullptr)			  return OpCode::Add;
+		if (dynamic_cast<const SubtractionOp*>(bo) != nullptr)		  return OpCode::Subtract;
+		if (dynamic_cast<const MultiplyOp*>(bo) != nullptr)			  return OpCode::Multiply;
+		if (dynamic_cast<const LessThanOp*>(bo) != nullptr)			  return OpCode::LessThan;
+		if (dynamic_cast<const LessThanOrEqualOp*>(bo) != nullptr)	  return OpCode::LessThanOrEqual;
+		if (dynamic_cast<const GreaterThanOp*>(bo) != nullptr)		  return OpCode::GreaterThan;
+		if (dynamic_cast<const GreaterThanOrEqualOp*>(bo) != nullptr) return OpCode::GreaterThanOrEqual;
+		if (dynamic_cast<const EqualsOp*>(bo) != nullptr)			  return OpCode::Equals;
+		if (dynamic_cast<const NotEqualsOp*>(bo) != nullptr)		  return OpCode::NotEquals;
+
+		return OpCode::BinaryOperation;
+	}
+
+	/** The tree uses the && and || operator of the var class, so the result is always a bool. */
+	void compileLogicalOperator(const BinaryOperatorBase* op, int dst, bool isAnd)
+	{
+		compileExpression(op->lhs, dst);
+		emit(OpCode::ToBool, dst, dst);
+		const int jumpToEnd = emit(isAnd ? OpCode::JumpIfFalse : OpCode::JumpIfTrue, 0, dst);
+
+		compileExpression(op->rhs, dst);
+		emit(OpCode::ToBool, dst, dst);
+		setJumpTarget(jumpToEnd, getPosition());
+	}
+
+	void compileConditional(const ConditionalOp* co, int dst)
+	{
+		compileExpression(co->condition, dst);
+		const int jumpToFalseBranch = emit(OpCode::JumpIfFalse, 0, dst);
+
+		compileExpression(co->trueBranch, dst);
+		const int jumpToEnd = emit(OpCode::Jump);
+
+		setJumpTarget(jumpToFalseBranch, getPosition());
+		compileExpression(co->falseBranch, dst);
+		setJumpTarget(jumpToEnd, getPosition());
+	}
+
+	void compileApiCall(const ApiCall* ac, int dst)
+	{
+		// The tree suspends the audio thread guard for the argument evaluation of these calls
+		if (ac->apiClass == nullptr || ac->apiClass->allowIllegalCallsOnAudioThread(ac->functionIndex))
+		{
+			emit(OpCode::Evaluate, dst, 0, 0, addNode(ac));
+			return;
+		}
+
+		const int firstArgument = compileArguments(ac->argumentList, ac->expectedNumArguments);
+		emit(OpCode::ApiCall, dst, firstArgument, ac->expectedNumArguments, addNode(ac));
+		releaseRegisters(firstArgument);
+	}
+
+	/** Evaluates the arguments into consecutive registers and returns the first one. */
+	int compileArguments(const ExpPtr* arguments, int numArguments)
+	{
+		const int firstArgument = numUsedRegisters;
+
+		for (int i = 0; i < numArguments; i++)
+			compileExpression(arguments[i], allocateRegister());
+
+		return firstArgument;
+	}
+
+	void emitAssignment(const Expression* target, int source)
+	{
+		var* ptr = nullptr;
+
+		if (auto rn = dynamic_cast<const RegisterName*>(target))
+			ptr = rn->data;
+		else if (auto cl = dynamic_cast<const CallbackLocalReference*>(target))
+			ptr = cl->parentCallback->localProperties.getVarPointer(cl->name);
+
+		if (ptr != nullptr)
+			emit(OpCode::StorePointer, 0, source, 0, addPointer(ptr));
+		else
+			emit(OpCode::Assign, 0, source, 0, addNode(target));
+	}
+
+	// ================================================================================================ Helpers
+
+	int emit(OpCode op, int dst=0, int a=0, int b=0, int index=-1)
+	{
+		Instruction i;
+
+		i.op = op;
+		i.dst = (int16)dst;
+		i.a = (int16)a;
+		i.b = (int16)b;
+		i.index = index;
+		i.target = -1;
+
+		p.code.add(i);
+		return p.code.size() - 1;
+	}
+
+	int getPosition() const noexcept { return p.code.size(); }
+
+	void setJumpTarget(int instructionIndex, int target)
+	{
+		p.code.getReference(instructionIndex).target = target;
+	}
+
+	int addNode(const Statement* st)
+	{
+		p.nodes.add(st);
+		return p.nodes.size() - 1;
+	}
+
+	int addConstant(const var* v)
+	{
+		p.constants.add(v);
+		return p.constants.size() - 1;
+	}
+
+	int addPointer(var* v)
+	{
+		const int index = p.pointers.indexOf(v);
+
+		if (index != -1)
+			return index;
+
+		p.pointers.add(v);
+		return p.pointers.size() - 1;
+	}
+
+	int allocateRegister()
+	{
+		numRegisters = jmax(numRegisters, numUsedRegisters + 1);
+		return numUsedRegisters++;
+	}
+
+	/** Releases the given register and all registers that were allocated after it. */
+	void releaseRegisters(int firstRegisterToRelease)
+	{
+		numUsedRegisters = firstRegisterToRelease;
+	}
+
+	static bool isEmptyStatement(const Statement* st)
+	{
+		return st == nullptr || typeid(*st) == typeid(Statement);
+	}
+
+	static bool isAlwaysTrue(const Expression* e)
+	{
+		if (auto lv = dynamic_cast<const LiteralValue*>(e))
+			return isNumeric(lv->value) && (bool)lv->value;
+
+		return false;
+	}
+
+	BytecodeProgram& p;
+
+	Array<LoopLabels*> loopStack;
+
+	int numUsedRegisters = 0;
+	int numRegisters = 0;
+};
+
+HiseJavascriptEngine::RootObject::BytecodeProgram* HiseJavascriptEngine::RootObject::BytecodeProgram::compile(const BlockStatement* statements)
+{
+	if (statements == nullptr)
+		return nullptr;
+
+	ScopedPointer<BytecodeProgram> p = new BytecodeProgram(statements);
+
+	Compiler c(*p);
+
+	if (!c.compileProgram())
+		return nullptr;
+
+	return p.release();
+}
+
+HiseJavascriptEngine::RootObject::Statement::ResultCode HiseJavascriptEngine::RootObject::BytecodeProgram::perform(const Scope& s, var* returnValue) const
+{
+	// The program uses a single register file, so a recursive call is executed by the tree
+	if (isRunning)
+		return statements->perform(s, returnValue);
+
+	ScopedExecution se(*this);
+
+#if ENABLE_SCRIPTING_BREAKPOINTS
+	ScriptAudioThreadGuard guard(statements->location);
+#endif
+
+	var* r = registers.getRawDataPointer();
+	const Instruction* const start = code.begin();
+	const Instruction* i = start;
+
+	for (;;)
+	{
+		switch (i->op)
+		{
+		case OpCode::LoadConstant:
+			r[i->dst] = *constants.getUnchecked(i->index);
+			++i;
+			break;
+		case OpCode::LoadPointer:
+			r[i->dst] = *pointers.getUnchecked(i->index);
+			++i;
+			break;
+		case OpCode::StorePointer:
+			*pointers.getUnchecked(i->index) = r[i->a];
+			++i;
+			break;
+		case OpCode::Evaluate:
+			r[i->dst] = static_cast<const Expression*>(nodes.getUnchecked(i->index))->getResult(s);
+			++i;
+			break;
+		case OpCode::Assign:
+			static_cast<const Expression*>(nodes.getUnchecked(i->index))->assign(s, r[i->a]);
+			++i;
+			break;
+		case OpCode::Perform:
+		{
+			const auto result = nodes.getUnchecked(i->index)->perform(s, returnValue);
+
+			if (result == Statement::ok)
+			{
+				++i;
+				break;
+			}
+
+			const bool isLoopJump = result == Statement::breakWasHit || result == Statement::continueWasHit;
+
+			if (!isLoopJump || i->a == -1)
+				return result;
+
+			const auto& l = loops.getReference(i->a);
+			i = start + (result == Statement::breakWasHit ? l.breakTarget : l.continueTarget);
+			break;
+		}
+		case OpCode::Add:
+			r[i->dst] = applyOperation<Operations::Add>(nodes.getUnchecked(i->index), r[i->a], r[i->b]);
+			++i;
+			break;
+		case OpCode::Subtract:
+			r[i->dst] = applyOperation<Operations::Subtract>(nodes.getUnchecked(i->index), r[i->a], r[i->b]);
+			++i;
+			break;
+		case OpCode::Multiply:
+			r[i->dst] = applyOperation<Operations::Multiply>(nodes.getUnchecked(i->index), r[i->a], r[i->b]);
+			++i;
+			break;
+		case OpCode::LessThan:
+			r[i->dst] = applyOperation<Operations::LessThan>(nodes.getUnchecked(i->index), r[i->a], r[i->b]);
+			++i;
+			break;
+		case OpCode::LessThanOrEqual:
+			r[i->dst] = applyOperation<Operations::LessThanOrEqual>(nodes.getUnchecked(i->index), r[i->a], r[i->b]);
+			++i;
+			break;
+		case OpCode::GreaterThan:
+			r[i->dst] = applyOperation<Operations::GreaterThan>(nodes.getUnchecked(i->index), r[i->a], r[i->b]);
+			++i;
+			break;
+		case OpCode::GreaterThanOrEqual:
+			r[i->dst] = applyOperation<Operations::GreaterThanOrEqual>(nodes.getUnchecked(i->index), r[i->a], r[i->b]);
+			++i;
+			break;
+		case OpCode::Equals:
+			r[i->dst] = applyOperation<Operations::Equals>(nodes.getUnchecked(i->index), r[i->a], r[i->b]);
+			++i;
+			break;
+		case OpCode::NotEquals:
+			r[i->dst] = applyOperation<Operations::NotEquals>(nodes.getUnchecked(i->index), r[i->a], r[i->b]);
+			++i;
+			break;
+		case OpCode::BinaryOperation:
+			r[i->dst] = static_cast<const BinaryOperator*>(nodes.getUnchecked(i->index))->getResultFor(r[i->a], r[i->b]);
+			++i;
+			break;
+		case OpCode::ToBool:
+			r[i->dst] = (bool)r[i->a];
+			++i;
+			break;
+		case OpCode::Jump:
+			i = start + i->target;
+			break;
+		case OpCode::JumpIfFalse:
+			i = r[i->a] ? i + 1 : start + i->target;
+			break;
+		case OpCode::JumpIfTrue:
+			i = r[i->a] ? start + i->target : i + 1;
+			break;
+		case OpCode::ApiCall:
+		{
+			auto ac = static_cast<const ApiCall*>(nodes.getUnchecked(i->index));
+			var* arguments = r + i->a;
+
+			for (int argIndex = 0; argIndex < i->b; argIndex++)
+				HiseJavascriptEngine::checkValidParameter(argIndex, arguments[argIndex], ac->location);
+
+			r[i->dst] = ac->callWithArguments(arguments);
+			++i;
+			break;
+		}
+		case OpCode::CheckTimeout:
+			s.checkTimeOut(nodes.getUnchecked(i->index)->location);
+			++i;
+			break;
+		case OpCode::StatementGuard:
+#if ENABLE_SCRIPTING_BREAKPOINTS
+			guard.setLocation(nodes.getUnchecked(i->index)->location);
+#endif
+			++i;
+			break;
+		case OpCode::Return:
+			if (returnValue != nullptr)
+				*returnValue = r[i->a];
+
+			return Statement::returnWasHit;
+		case OpCode::ReturnCode:
+			return (Statement::ResultCode)i->index;
+		case OpCode::End:
+		default:
+			return Statement::ok;
+		}
+	}
+}
+
+} // namespace hise
@@ -0,0 +1,332 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which also must be licenced for commercial applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+#include "AppConfig.h"
+
+#if HI_RUN_UNIT_TESTS
+
+#include  "JuceHeader.h"
+
+using namespace hise;
+
+/** Runs the same onNoteOn callback with the syntax tree and with the bytecode and checks that the return value
+*	and the error message (including its location) are the same. */
+class JavascriptEngineBytecodeUnitTests : public UnitTest
+{
+public:
+
+	JavascriptEngineBytecodeUnitTests() :
+		UnitTest("Testing the scripting bytecode")
+	{}
+
+	void runTest() override
+	{
+		ScopedValueSetter<bool> s(MainController::unitTestMode, true);
+
+		ScopedPointer<BackendProcessor> bp = new BackendProcessor(nullptr, nullptr);
+
+		processor = new TestProcessor(bp);
+		processor->setOwnerSynth(bp->getMainSynthChain());
+
+		auto mpc = dynamic_cast<MidiProcessorChain*>(bp->getMainSynthChain()->getChildProcessor(ModulatorSynth::MidiProcessor));
+		mpc->getHandler()->add(processor, nullptr);
+
+		testLoops();
+		testIncrements();
+		testLogicalOperators();
+		testApiCalls();
+		testRecursion();
+		testErrorLocations();
+
+		processor = nullptr;
+		bp = nullptr;
+	}
+
+private:
+
+	/** Adds a Test.recurse() method that executes the onNoteOn callback while it is running. */
+	class TestProcessor : public JavascriptMidiProcessor
+	{
+	public:
+
+		TestProcessor(MainController* mc) :
+			JavascriptMidiProcessor(mc, "BytecodeTest")
+		{}
+
+		void registerApiClasses() override
+		{
+			JavascriptMidiProcessor::registerApiClasses();
+
+			DynamicObject::Ptr testObject = new DynamicObject();
+
+			testObject->setMethod("recurse", [this](const var::NativeFunctionArgs&)
+			{
+				Result r = Result::ok();
+				getScriptEngine()->executeCallback(JavascriptMidiProcessor::onNoteOn, &r);
+				return var(r.wasOk());
+			});
+
+			getScriptEngine()->registerNativeObject("Test", testObject.get());
+		}
+	};
+
+	struct CallbackResult
+	{
+		var returnValue;
+		String errorMessage;
+	};
+
+	void testLoops()
+	{
+		expectSameResult("for loop with break and continue",
+			"reg i = 0;\nreg sum = 0;",
+			"sum = 0;\n"
+			"for (i = 0; i < 20; i++)\n"
+			"{\n"
+			"	if (i == 3) continue;\n"
+			"	if (i > 12) break;\n"
+			"	sum += i;\n"
+			"}\n"
+			"return [sum, i];",
+			createArray({ 75, 13 }));
+
+		expectSameResult("while and do-while loops with break and continue",
+			"",
+			"local n = 0;\n"
+			"local evens = 0;\n"
+			"while (n < 10)\n"
+			"{\n"
+			"	n++;\n"
+			"	if (n % 2 == 1) continue;\n"
+			"	evens += n;\n"
+			"}\n"
+			"local k = 0;\n"
+			"local skipped = 0;\n"
+			"do\n"
+			"{\n"
+			"	k++;\n"
+			"	if (k == 2) { skipped++; continue; }\n"
+			"	if (k == 6) break;\n"
+			"}\n"
+			"while (k < 10);\n"
+			"return [n, evens, k, skipped];",
+			createArray({ 10, 30, 6, 1 }));
+
+		expectSameResult("nested loops",
+			"reg i = 0;\nreg j = 0;",
+			"local count = 0;\n"
+			"for (i = 0; i < 4; i++)\n"
+			"{\n"
+			"	for (j = 0; j < 4; j++)\n"
+			"	{\n"
+			"		if (j > i) break;\n"
+			"		if (j == 1) continue;\n"
+			"		count += 10 * i + j;\n"
+			"	}\n"
+			"}\n"
+			"return count;",
+			147);
+	}
+
+	void testIncrements()
+	{
+		expectSameResult("pre and post increment",
+			"reg i = 0;",
+			"local a = 5;\n"
+			"local b = a++;\n"
+			"local c = a--;\n"
+			"local d = ++a;\n"
+			"i = 0;\n"
+			"local e = i++ + i++;\n"
+			"local f = 2.5;\n"
+			"local g = f++;\n"
+			"return [a, b, c, d, e, i, f, g];",
+			createArray({ 6, 5, 6, 6, 1, 2, 3.5, 2.5 }));
+	}
+
+	void testLogicalOperators()
+	{
+		expectSameResult("short circuit evaluation",
+			"reg calls = 0;\n"
+			"inline function touch(value)\n"
+			"{\n"
+			"	calls++;\n"
+			"	return value;\n"
+			"}",
+			"calls = 0;\n"
+			"local a = touch(0) && touch(1);\n"
+			"local b = touch(1) || touch(0);\n"
+			"local c = touch(2) && touch(3);\n"
+			"local d = touch(0) || touch(\"\");\n"
+			"local e = touch(1) ? touch(10) : touch(20);\n"
+			"return [a, b, c, d, e, calls];",
+			createArray({ false, true, true, false, 10, 8 }));
+	}
+
+	void testApiCalls()
+	{
+		// The parser creates an ApiCall for Math and a function call on the object for the MidiList methods
+		expectSameResult("API calls and calls on const objects",
+			"const var list = Engine.createMidiList();\nreg i = 0;",
+			"list.fill(0);\n"
+			"for (i = 0; i < 8; i++)\n"
+			"	list.setValue(i, i * i);\n"
+			"local m = Math.max(list.getValue(3), 5);\n"
+			"local r = Math.round(2.6) + Math.min(4, list.getValue(7));\n"
+			"return [m, r, list.getValueAmount(0), list.getIndex(49)];",
+			createArray({ 9, 7, 121, 7 }));
+	}
+
+	void testRecursion()
+	{
+		// The inner calls must fall back to the tree or they would overwrite the registers of the outer call
+		expectSameResult("recursive callback",
+			"reg depth = 0;\nreg calls = 0;\nreg sum = 0;\nreg i = 0;",
+			"calls++;\n"
+			"depth++;\n"
+			"for (i = 0; i < 3; i++)\n"
+			"{\n"
+			"	sum += depth * (i + 1);\n"
+			"	if (depth < 3)\n"
+			"		Test.recurse();\n"
+			"}\n"
+			"depth--;\n"
+			"return [calls, sum, depth];",
+			createArray({ 3, 21, 0 }));
+	}
+
+	void testErrorLocations()
+	{
+		expectSameError("undefined API call parameter",
+			"reg i = 0;",
+			"local u;\n"
+			"for (i = 0; i < 10; i++)\n"
+			"{\n"
+			"	if (i == 7)\n"
+			"		Math.abs(u);\n"
+			"}",
+			"API call with undefined parameter 0");
+
+		expectSameError("failed assertion",
+			"reg i = 0;",
+			"local x = 0;\n"
+			"while (i < 10)\n"
+			"{\n"
+			"	x = x + i++;\n"
+			"	Console.assertTrue(x < 10);\n"
+			"}",
+			"Assertion failure");
+
+		expectSameError("loop timeout",
+			"",
+			"local x = 0;\n"
+			"while (x >= 0)\n"
+			"	x = (x + 1) % 1000;",
+			"Execution timed-out");
+	}
+
+	void expectSameResult(const String& testName, const String& onInit, const String& onNoteOn, const var& expectedValue)
+	{
+		beginTest(testName);
+
+		auto tree = runCallback(onInit, onNoteOn, false);
+		auto bytecode = runCallback(onInit, onNoteOn, true);
+
+		expectEquals(tree.errorMessage, String(), "Tree error");
+		expectEquals(bytecode.errorMessage, String(), "Bytecode error");
+
+		// The JSON string also compares the types of the values
+		expectEquals(JSON::toString(bytecode.returnValue, true), JSON::toString(tree.returnValue, true), "Bytecode result");
+		expect(tree.returnValue == expectedValue, "Expected " + JSON::toString(expectedValue, true) + ", actual: " + JSON::toString(tree.returnValue, true));
+	}
+
+	void expectSameError(const String& testName, const String& onInit, const String& onNoteOn, const String& expectedError)
+	{
+		beginTest(testName);
+
+		auto tree = runCallback(onInit, onNoteOn, false);
+		auto bytecode = runCallback(onInit, onNoteOn, true);
+
+		expect(tree.errorMessage.contains(expectedError), "Tree error: " + tree.errorMessage);
+		expectEquals(bytecode.errorMessage, tree.errorMessage, "Bytecode error");
+	}
+
+	CallbackResult runCallback(const String& onInit, const String& onNoteOn, bool useBytecode)
+	{
+		String code;
+
+		code << onInit << "\n";
+		code << "function onNoteOn()\n{\n" << onNoteOn << "\n}\n";
+		code << "function onNoteOff()\n{\n}\n";
+		code << "function onController()\n{\n}\n";
+		code << "function onTimer()\n{\n}\n";
+		code << "function onControl(number, value)\n{\n}\n";
+
+		processor->parseSnippetsFromString(code, true);
+		processor->compileScript();
+
+		expect(processor->wasLastCompileOK(), "Compile error: " + processor->getLastErrorMessage().getErrorMessage());
+
+		auto engine = processor->getScriptEngine();
+
+		engine->setUseBytecode(JavascriptMidiProcessor::onNoteOn, useBytecode);
+
+		expect(engine->isUsingBytecode(JavascriptMidiProcessor::onNoteOn) == useBytecode, "The callback wasn't compiled");
+
+		engine->maximumExecutionTime = RelativeTime(0.2);
+
+		CallbackResult cr;
+		Result r = Result::ok();
+
+		cr.returnValue = engine->executeCallback(JavascriptMidiProcessor::onNoteOn, &r);
+		cr.errorMessage = r.getErrorMessage();
+
+		return cr;
+	}
+
+	static var createArray(std::initializer_list<var> values)
+	{
+		Array<var> a;
+
+		for (const auto& v : values)
+			a.add(v);
+
+		return var(a);
+	}
+
+	// Owned by the MIDI processor chain
+	TestProcessor* processor = nullptr;
+};
+
+static JavascriptEngineBytecodeUnitTests javascriptEngineBytecodeUnitTests;
+
+#endif
@@ -101,11 +101,17 @@ struct HiseJavascriptEngine::RootObject::ApiCall : public Expression
 			HiseJavascriptEngine::checkValidParameter(i, results[i], location);
 		}
 
+		return callWithArguments(results);
+	}
+
+	/** Calls the API function with the already evaluated arguments. */
+	var callWithArguments(var* arguments) const
+	{
 		CHECK_CONDITION_WITH_LOCATION(apiClass != nullptr, "API class does not exist");
 
 		try
 		{
-			return apiClass->callFunction(functionIndex, results, expectedNumArguments);
+			return apiClass->callFunction(functionIndex, arguments, expectedNumArguments);
 		}
 		catch (String& error)
 		{
@@ -9,12 +9,37 @@ struct HiseJavascriptEngine::RootObject::LiteralValue : public Expression
 
 struct HiseJavascriptEngine::RootObject::UnqualifiedName : public Expression
 {
-	UnqualifiedName(const CodeLocation& l, const Identifier& n, bool isFunction) noexcept : Expression(l), name(n), allowUnqualifiedDefinition(isFunction) {}
+	/** The scope where the parser expects the variable to live. This is used to skip the walk through the scope chain. */
+	enum class ResolvedScope
+	{
+		Dynamic = 0, ///< no static information, walk through all scopes
+		Local, ///< a parameter or var of the function that contains this expression
+		Root ///< an expression outside of a function (onInit, callbacks & inline functions)
+	};
+
+	UnqualifiedName(const CodeLocation& l, const Identifier& n, bool isFunction, ResolvedScope resolvedScope_=ResolvedScope::Dynamic) noexcept :
+		Expression(l),
+		name(n),
+		allowUnqualifiedDefinition(isFunction),
+		resolvedScope(resolvedScope_)
+	{}
+
+	var getResult(const Scope& s) const override
+	{
+		if (const var* v = findResolvedSlot(s))
+			return *v;
 
-	var getResult(const Scope& s) const override  { return s.findSymbolInParentScopes(name); }
+		return s.findSymbolInParentScopes(name);
+	}
 
 	void assign(const Scope& s, const var& newValue) const override
 	{
+		if (var* v = findResolvedSlot(s))
+		{
+			*v = newValue;
+			return;
+		}
+
 		const Scope* currentScope = &s;
 		var* v = getPropertyPointer(currentScope->scope, name);
 
@@ -44,10 +69,38 @@ struct HiseJavascriptEngine::RootObject::UnqualifiedName : public Expression
 			
 	}
 
+	/** Returns the slot in the scope that the parser resolved or nullptr if the dynamic lookup has to be used. 
+	*
+	*	The first scope in the chain is always searched first, so this yields the same result as the dynamic lookup. */
+	var* findResolvedSlot(const Scope& s) const
+	{
+		switch (resolvedScope)
+		{
+		case ResolvedScope::Local:	return getCachedSlot(s.scope.get());
+		case ResolvedScope::Root:	return (s.parent == nullptr && s.scope.get() == s.root.get()) ? getCachedSlot(s.root.get()) : nullptr;
+		case ResolvedScope::Dynamic:
+		default:					return nullptr;
+		}
+	}
+
+	/** Checks the last index of the name in the object's properties before searching it again. */
+	var* getCachedSlot(DynamicObject* o) const
+	{
+		const NamedValueSet& properties = o->getProperties();
+
+		if (!isPositiveAndBelow(cachedSlotIndex, properties.size()) || properties.getName(cachedSlotIndex) != name)
+			cachedSlotIndex = properties.indexOf(name);
+
+		return cachedSlotIndex != -1 ? properties.getVarPointerAt(cachedSlotIndex) : nullptr;
+	}
+
 	bool allowUnqualifiedDefinition = false;
 
 	JavascriptNamespace* ns = nullptr;
 	Identifier name;
+
+	const ResolvedScope resolvedScope;
+	mutable int cachedSlotIndex = -1;
 };
 
 
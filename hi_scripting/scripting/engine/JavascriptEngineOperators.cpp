@@ -2,11 +2,80 @@ namespace hise { using namespace juce;
 
 struct HiseJavascriptEngine::RootObject::BinaryOperatorBase : public Expression
 {
+	/** The type combination of the operands of a numeric operation. */
+	enum class OperandTypes : uint8
+	{
+		Unknown = 0,
+		Integers,	///< both operands are int or int64
+		Doubles,	///< both operands are doubles
+		Mixed,		///< an int and a double
+		Generic		///< anything else (these are handled by the dynamic type dispatch)
+	};
+
 	BinaryOperatorBase(const CodeLocation& l, ExpPtr& a, ExpPtr& b, TokenType op) noexcept
 	: Expression(l), lhs(a), rhs(b), operation(op) {}
 
+	static bool isInteger(const var& v) noexcept { return v.isInt() || v.isInt64(); }
+
+	static OperandTypes getOperandTypes(const var& a, const var& b) noexcept
+	{
+		const bool aIsDouble = a.isDouble();
+		const bool bIsDouble = b.isDouble();
+
+		if (!(aIsDouble || isInteger(a)) || !(bIsDouble || isInteger(b)))
+			return OperandTypes::Generic;
+
+		if (aIsDouble && bIsDouble)
+			return OperandTypes::Doubles;
+
+		return (aIsDouble || bIsDouble) ? OperandTypes::Mixed : OperandTypes::Integers;
+	}
+
+	/** Returns the operand types if they were the same for the last evaluations. */
+	OperandTypes getSpecialisation() const noexcept { return specialisation; }
+
+	/** Call this with the operand types of every evaluation that didn't match the specialisation.
+	*
+	*	If the same types are observed a few times in a row, the operator will be specialised for these
+	*	types (operators with non numeric types are specialised to use the dynamic type dispatch without
+	*	further checks). An operator that keeps changing its types will stay unspecialised. */
+	void updateSpecialisation(OperandTypes currentTypes) const noexcept
+	{
+		if (specialisation != OperandTypes::Unknown)
+		{
+			// The types have changed after the operator was specialised
+			specialisation = OperandTypes::Unknown;
+			numDeoptimisations++;
+		}
+
+		if (currentTypes != lastOperandTypes)
+		{
+			lastOperandTypes = currentTypes;
+			numStableEvaluations = 0;
+		}
+
+		if (numDeoptimisations >= MaxNumDeoptimisations)
+			return;
+
+		if (++numStableEvaluations >= NumEvaluationsUntilSpecialised)
+			specialisation = currentTypes;
+	}
+
 	ExpPtr lhs, rhs;
 	TokenType operation;
+
+private:
+
+	enum
+	{
+		NumEvaluationsUntilSpecialised = 8,
+		MaxNumDeoptimisations = 4
+	};
+
+	mutable OperandTypes specialisation = OperandTypes::Unknown;
+	mutable OperandTypes lastOperandTypes = OperandTypes::Unknown;
+	mutable uint8 numStableEvaluations = 0;
+	mutable uint8 numDeoptimisations = 0;
 };
 
 struct HiseJavascriptEngine::RootObject::BinaryOperator : public BinaryOperatorBase
@@ -24,6 +93,41 @@ struct HiseJavascriptEngine::RootObject::BinaryOperator : public BinaryOperatorB
 	{
 		var a(lhs->getResult(s)), b(rhs->getResult(s));
 
+		return getResultFor(a, b);
+	}
+
+	/** Applies the operation to the already evaluated operands. */
+	var getResultFor(const var& a, const var& b) const
+	{
+		// Skip the type dispatch if the operands have the types that were observed before
+		switch (getSpecialisation())
+		{
+		case OperandTypes::Integers:
+			if (isInteger(a) && isInteger(b))
+				return getWithInts(a, b);
+			break;
+		case OperandTypes::Doubles:
+			if (a.isDouble() && b.isDouble())
+				return getWithDoubles(a, b);
+			break;
+		case OperandTypes::Mixed:
+			if (getOperandTypes(a, b) == OperandTypes::Mixed)
+				return getWithDoubles(a, b);
+			break;
+		case OperandTypes::Generic:
+			return getResultWithDynamicTypes(a, b);
+		case OperandTypes::Unknown:
+		default:
+			break;
+		}
+
+		updateSpecialisation(getOperandTypes(a, b));
+
+		return getResultWithDynamicTypes(a, b);
+	}
+
+	var getResultWithDynamicTypes(const var& a, const var& b) const
+	{
 		if (isNumericOrUndefined(a) && isNumericOrUndefined(b))
 			return (a.isDouble() || b.isDouble()) ? getWithDoubles(a, b) : getWithInts(a, b);
 
@@ -354,11 +354,15 @@ struct HiseJavascriptEngine::RootObject::ExpressionTreeBuilder : private TokenIt
 
 	void parseFunctionParamsAndBody(FunctionObject& fo)
 	{
+		Array<Identifier> functionLocals;
+		ScopedValueSetter<Array<Identifier>*> svs(currentFunctionLocals, &functionLocals);
+
 		match(TokenTypes::openParen);
 
 		while (currentType != TokenTypes::closeParen)
 		{
 			fo.parameters.add(currentValue.toString());
+			functionLocals.add(fo.parameters.getLast());
 			match(TokenTypes::identifier);
 
 			if (currentType != TokenTypes::closeParen)
@@ -541,6 +545,9 @@ private:
 
 	DynamicObject* currentInlineFunction = nullptr;
 
+	/** The parameters and vars of the function that is currently parsed (or nullptr outside of a function). */
+	Array<Identifier>* currentFunctionLocals = nullptr;
+
 	JavascriptNamespace* currentNamespace = nullptr;
 
 	JavascriptNamespace* getCurrentNamespace()
@@ -814,6 +821,9 @@ private:
 
 		hiseSpecialData->checkIfExistsInOtherStorage(HiseSpecialData::VariableStorageType::RootScope, s->name, location);
 
+		if (currentFunctionLocals != nullptr)
+			currentFunctionLocals->addIfNotAlreadyThere(s->name);
+
 		s->initialiser = matchIf(TokenTypes::assign) ? parseExpression() : new Expression(location);
 
 		if (matchIf(TokenTypes::comma))
@@ -1729,6 +1739,18 @@ private:
 		return matchCloseParen(s.release());
 	}
 
+	/** Checks whether the location of an unqualified variable is known at compile time. */
+	UnqualifiedName::ResolvedScope getResolvedScope(const Identifier& id) const
+	{
+		if (currentFunctionLocals == nullptr)
+			return UnqualifiedName::ResolvedScope::Root;
+
+		if (currentFunctionLocals->contains(id))
+			return UnqualifiedName::ResolvedScope::Local;
+
+		return UnqualifiedName::ResolvedScope::Dynamic;
+	}
+
 	Expression* parseSuffixes(Expression* e)
 	{
 		ExpPtr input(e);
@@ -1886,7 +1908,7 @@ private:
 						}
 					}
 
-					return parseSuffixes(new UnqualifiedName(location, parseIdentifier(), false));
+					return parseSuffixes(new UnqualifiedName(location, parseIdentifier(), false, getResolvedScope(id)));
 				}
 			}
 		}
@@ -86,6 +86,7 @@ Set this to true if you add this module to your existing C++ project and don't e
 #include "hi_streaming/SampleThreadPool.h"
 #include "hi_streaming/MonolithAudioFormat.h"
 #include "hi_streaming/StreamingSampler.h"
+#include "hi_streaming/SampleInterpolators.h"
 #include "hi_streaming/StreamingSamplerSound.h"
 #include "hi_streaming/StreamingSamplerVoice.h"
 
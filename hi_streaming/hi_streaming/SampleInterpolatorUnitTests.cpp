@@ -0,0 +1,366 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+#include "AppConfig.h"
+
+#if HI_RUN_UNIT_TESTS
+
+#include  "JuceHeader.h"
+
+using namespace hise;
+
+/** Checks the resampling kernels against a double precision reference and
+*	prints a micro benchmark (voices per core) so that regressions can be tracked. */
+class SampleInterpolatorUnitTests : public UnitTest
+{
+public:
+
+	SampleInterpolatorUnitTests() :
+		UnitTest("Testing streaming sampler interpolation")
+	{}
+
+	void runTest() override
+	{
+		testKernels<float, true>("float");
+		testKernels<int16, false>("int16");
+
+		testHigherOrderKernels();
+
+		runBenchmark<float, true>("float");
+		runBenchmark<int16, false>("int16");
+		runKernelBenchmark();
+	}
+
+private:
+
+	enum
+	{
+		BlockSize = 512,
+		SourceSize = BlockSize * MAX_SAMPLER_PITCH + 2
+	};
+
+	template <typename SignalType, bool isFloat> void fillSource(HeapBlock<SignalType>& data)
+	{
+		data.calloc(SourceSize);
+
+		// A mix of two sine waves is used instead of noise: the kernels accumulate the read position 
+		// in different orders, so the tiny position errors must not be amplified by a steep signal.
+		const double f1 = r.nextDouble() * 0.02;
+		const double f2 = r.nextDouble() * 0.05;
+
+		for (int i = 0; i < SourceSize; i++)
+		{
+			const float v = (float)(0.5 * std::sin(double_Pi * f1 * (double)i) + 0.4 * std::sin(double_Pi * f2 * (double)i));
+			data[i] = isFloat ? (SignalType)v : (SignalType)(v * (float)INT16_MAX);
+		}
+	}
+
+	/** Calculates the expected output with double precision read positions. */
+	template <typename SignalType, bool isFloat> static void processReference(const SignalType* in, const float* pitchData, float* out, double index, double delta)
+	{
+		const double gainFactor = isFloat ? 1.0 : (1.0 / (double)INT16_MAX);
+
+		for (int i = 0; i < BlockSize; i++)
+		{
+			const int pos = (int)index;
+			const double alpha = index - (double)pos;
+
+			out[i] = (float)(((double)in[pos] * (1.0 - alpha) + (double)in[pos + 1] * alpha) * gainFactor);
+
+			index += pitchData != nullptr ? (double)pitchData[i] : delta;
+		}
+	}
+
+	template <typename SignalType, bool isFloat> void testKernels(const String& typeName)
+	{
+		HeapBlock<SignalType> l, r_;
+		fillSource<SignalType, isFloat>(l);
+		fillSource<SignalType, isFloat>(r_);
+
+		const double deltas[] = { 1.0, 0.5, 0.999, 1.3, 2.7 };
+		const double startAlphas[] = { 0.0, 0.25, 0.8 };
+
+		for (auto delta : deltas)
+		{
+			for (auto startAlpha : startAlphas)
+			{
+				beginTest("Testing " + typeName + " kernels with pitch " + String(delta) + ", start " + String(startAlpha));
+
+				compare<SignalType, isFloat>(l, r_, nullptr, startAlpha, delta);
+
+				HeapBlock<float> pitchData(BlockSize);
+
+				for (int i = 0; i < BlockSize; i++)
+					pitchData[i] = (float)delta * (0.9f + 0.2f * r.nextFloat());
+
+				compare<SignalType, isFloat>(l, r_, pitchData, startAlpha, delta);
+			}
+		}
+	}
+
+	template <typename SignalType, bool isFloat> void compare(const SignalType* l, const SignalType* r_, const float* pitchData, double startAlpha, double delta)
+	{
+		AudioSampleBuffer expected(2, BlockSize);
+		AudioSampleBuffer actual(2, BlockSize);
+
+		processReference<SignalType, isFloat>(l, pitchData, expected.getWritePointer(0), startAlpha, delta);
+		processReference<SignalType, isFloat>(r_, pitchData, expected.getWritePointer(1), startAlpha, delta);
+
+		using InstructionSet = InterpolatorHelpers::InstructionSet;
+
+		for (int s = 0; s <= (int)InterpolatorHelpers::getAvailableInstructionSet(); s++)
+		{
+			InterpolatorHelpers::setInstructionSet((InstructionSet)s);
+			LinearInterpolator::interpolateStereo<SignalType, isFloat>(l, r_, pitchData, actual.getWritePointer(0), actual.getWritePointer(1), 0, startAlpha, delta, BlockSize);
+
+			for (int c = 0; c < 2; c++)
+			{
+				float maxError = 0.0f;
+
+				for (int i = 0; i < BlockSize; i++)
+					maxError = jmax<float>(maxError, std::abs(expected.getSample(c, i) - actual.getSample(c, i)));
+
+				expect(maxError < 0.0005f, InterpolatorHelpers::getInstructionSetName((InstructionSet)s) + " max error: " + String(maxError));
+			}
+		}
+
+		InterpolatorHelpers::setSIMDEnabled(true);
+	}
+
+	template <typename SignalType, bool isFloat> double measure(const SignalType* l, const SignalType* r_, const float* pitchData, double delta, InterpolatorHelpers::InstructionSet instructionSet)
+	{
+		AudioSampleBuffer output(2, BlockSize);
+
+		InterpolatorHelpers::setInstructionSet(instructionSet);
+
+		const int numIterations = 20000;
+
+		const double start = Time::getMillisecondCounterHiRes();
+
+		for (int i = 0; i < numIterations; i++)
+			LinearInterpolator::interpolateStereo<SignalType, isFloat>(l, r_, pitchData, output.getWritePointer(0), output.getWritePointer(1), 0, 0.3, delta, BlockSize);
+
+		const double duration = Time::getMillisecondCounterHiRes() - start;
+
+		InterpolatorHelpers::setSIMDEnabled(true);
+
+		// the amount of voices that can be rendered in realtime at 44.1kHz
+		const double blockDurationMs = 1000.0 * (double)BlockSize / 44100.0;
+		return blockDurationMs / (duration / (double)numIterations);
+	}
+
+	template <typename SignalType, bool isFloat> void runBenchmark(const String& typeName)
+	{
+		beginTest("Benchmarking " + typeName + " kernels");
+
+		HeapBlock<SignalType> l, r_;
+		fillSource<SignalType, isFloat>(l);
+		fillSource<SignalType, isFloat>(r_);
+
+		HeapBlock<float> pitchData(BlockSize);
+
+		for (int i = 0; i < BlockSize; i++)
+			pitchData[i] = 1.0f + 0.05f * r.nextFloat();
+
+		struct Setup
+		{
+			String name;
+			const float* pitch;
+			double delta;
+		};
+
+		const Setup setups[] = { { "unity pitch", nullptr, 1.0 }, { "constant pitch", nullptr, 1.26 }, { "modulated pitch", pitchData.get(), 1.0 } };
+
+		using InstructionSet = InterpolatorHelpers::InstructionSet;
+
+		for (const auto& s : setups)
+		{
+			String message = typeName + " " + s.name + ":";
+
+			for (int i = 0; i <= (int)InterpolatorHelpers::getAvailableInstructionSet(); i++)
+			{
+				const double numVoices = measure<SignalType, isFloat>(l, r_, s.pitch, s.delta, (InstructionSet)i);
+				message << " " << String(roundToInt(numVoices)) << " voices per core (" << InterpolatorHelpers::getInstructionSetName((InstructionSet)i) << ")";
+			}
+
+			logMessage(message);
+		}
+
+		expect(true);
+	}
+
+	static double getSineValue(double index) { return std::sin(double_Pi * 0.04 * index); }
+
+	template <class KernelType> float getMaxKernelError(const float* sine, const float* pitchData, double delta)
+	{
+		HeapBlock<float> output(BlockSize);
+
+		// Start after the history so that all kernels have valid samples before the read position
+		const double startIndex = 8.3;
+
+		KernelInterpolator<KernelType>::template process<false>(sine, nullptr, pitchData, output, nullptr, startIndex, delta, BlockSize);
+
+		double index = startIndex;
+		float maxError = 0.0f;
+
+		for (int i = 0; i < BlockSize; i++)
+		{
+			maxError = jmax<float>(maxError, std::abs(output[i] - (float)getSineValue(index)));
+			index += pitchData != nullptr ? (double)pitchData[i] : delta;
+		}
+
+		return maxError;
+	}
+
+	void testHigherOrderKernels()
+	{
+		beginTest("Testing higher order interpolation kernels");
+
+		HeapBlock<float> sine(SourceSize);
+
+		for (int i = 0; i < SourceSize; i++)
+			sine[i] = (float)getSineValue((double)i);
+
+		for (int i = 0; i <= SincKernel::NumPhases; i += SincKernel::NumPhases / 4)
+		{
+			const float* c = SincKernel::getTable().getCoefficients(i);
+			float sum = 0.0f;
+
+			for (int j = 0; j < SincKernel::NumTaps; j++)
+				sum += c[j];
+
+			expectWithinAbsoluteError(sum, 1.0f, 0.0001f, "Sinc phase " + String(i) + " doesn't have unity gain");
+		}
+
+		expectWithinAbsoluteError(HermiteKernel::interpolate(sine + 20, 0.0f), sine[20], 0.00001f, "Hermite doesn't hit the sample");
+		expectWithinAbsoluteError(SincKernel::interpolate(sine + 20, 0.0f), sine[20], 0.00001f, "Sinc doesn't hit the sample");
+
+		HeapBlock<float> pitchData(BlockSize);
+
+		for (int i = 0; i < BlockSize; i++)
+			pitchData[i] = 0.5f + 0.1f * r.nextFloat();
+
+		const double deltas[] = { 0.25, 0.5, 0.77, 1.3 };
+
+		for (auto delta : deltas)
+		{
+			InterpolatorHelpers::setSIMDEnabled(false);
+
+			HeapBlock<float> linear(BlockSize);
+
+			const double startIndex = 8.3;
+			LinearInterpolator::interpolateMono<float, true>(sine, nullptr, nullptr, linear, nullptr, 0, startIndex, delta, BlockSize);
+
+			InterpolatorHelpers::setSIMDEnabled(true);
+
+			float linearError = 0.0f;
+
+			for (int i = 0; i < BlockSize; i++)
+				linearError = jmax<float>(linearError, std::abs(linear[i] - (float)getSineValue(startIndex + (double)i * delta)));
+
+			const float hermiteError = getMaxKernelError<HermiteKernel>(sine, nullptr, delta);
+			const float sincError = getMaxKernelError<SincKernel>(sine, nullptr, delta);
+
+			expect(hermiteError < linearError, "Hermite error " + String(hermiteError) + " >= linear error " + String(linearError));
+			expect(sincError < linearError, "Sinc error " + String(sincError) + " >= linear error " + String(linearError));
+			expect(sincError < 0.001f, "Sinc error: " + String(sincError));
+		}
+
+		expect(getMaxKernelError<HermiteKernel>(sine, pitchData, 1.0) < 0.001f, "Hermite error with pitch modulation");
+		expect(getMaxKernelError<SincKernel>(sine, pitchData, 1.0) < 0.001f, "Sinc error with pitch modulation");
+
+		testSincAntiAliasing();
+	}
+
+	/** Resamples a sine close to nyquist an octave up and checks that the band limited table removes it. */
+	void testSincAntiAliasing()
+	{
+		HeapBlock<float> highSine(SourceSize);
+
+		for (int i = 0; i < SourceSize; i++)
+			highSine[i] = (float)std::sin(0.9 * double_Pi * (double)i);
+
+		HeapBlock<float> output(BlockSize);
+
+		auto getPeak = [&](double maxPitchRatio)
+		{
+			KernelInterpolator<SincKernel>::template process<false>(highSine, nullptr, nullptr, output, nullptr, 8.3, 2.0, BlockSize, maxPitchRatio);
+			return FloatVectorOperations::findMaximum(output.getData() + SincKernel::NumTaps, BlockSize - SincKernel::NumTaps);
+		};
+
+		const float aliasedPeak = getPeak(1.0);
+		const float filteredPeak = getPeak(2.0);
+
+		expect(aliasedPeak > 0.5f, "Full band sinc should pass the signal: " + String(aliasedPeak));
+		expect(filteredPeak < 0.03f, "Sinc aliasing with pitch ratio 2: " + String(filteredPeak));
+		expect(SincKernel::getTableForPitch(0.5) == &SincKernel::getTable(), "Wrong band for pitch < 1");
+	}
+
+	template <class KernelType> double measureKernel(const float* l, const float* r_, double delta)
+	{
+		AudioSampleBuffer output(2, BlockSize);
+
+		const int numIterations = 5000;
+		const double start = Time::getMillisecondCounterHiRes();
+
+		for (int i = 0; i < numIterations; i++)
+			KernelInterpolator<KernelType>::template process<true>(l, r_, nullptr, output.getWritePointer(0), output.getWritePointer(1), 8.3, delta, BlockSize);
+
+		const double duration = Time::getMillisecondCounterHiRes() - start;
+		const double blockDurationMs = 1000.0 * (double)BlockSize / 44100.0;
+		return blockDurationMs / (duration / (double)numIterations);
+	}
+
+	void runKernelBenchmark()
+	{
+		beginTest("Benchmarking higher order kernels");
+
+		HeapBlock<float> l, r_;
+		fillSource<float, true>(l);
+		fillSource<float, true>(r_);
+
+		const double linearVoices = measure<float, true>(l, r_, nullptr, 0.74, InterpolatorHelpers::getAvailableInstructionSet());
+		const double hermiteVoices = measureKernel<HermiteKernel>(l, r_, 0.74);
+		const double sincVoices = measureKernel<SincKernel>(l, r_, 0.74);
+
+		logMessage("Linear: " + String(roundToInt(linearVoices)) + " voices per core, Hermite: " + String(roundToInt(hermiteVoices)) +
+			       " voices per core, Sinc: " + String(roundToInt(sincVoices)) + " voices per core");
+
+		expect(true);
+	}
+
+	Random r;
+};
+
+static SampleInterpolatorUnitTests sampleInterpolatorUnitTests;
+
+#endif
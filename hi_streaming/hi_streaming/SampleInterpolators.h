@@ -0,0 +1,692 @@
+/*  ===========================================================================
+*
+*   This file is part of HISE.
+*   Copyright 2016 Christoph Hart
+*
+*   HISE is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   HISE is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with HISE.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Commercial licenses for using HISE in an closed source project are
+*   available on request. Please visit the project's website to get more
+*   information about commercial licensing:
+*
+*   http://www.hise.audio/
+*
+*   HISE is based on the JUCE library,
+*   which must be separately licensed for closed source applications:
+*
+*   http://www.juce.com
+*
+*   ===========================================================================
+*/
+
+#ifndef SAMPLEINTERPOLATORS_H_INCLUDED
+#define SAMPLEINTERPOLATORS_H_INCLUDED
+
+namespace hise { using namespace juce;
+
+// Set this to 0 to disable the vectorized resampling kernels (the scalar versions will be used instead).
+#ifndef HISE_USE_SIMD_RESAMPLING
+#define HISE_USE_SIMD_RESAMPLING 1
+#endif
+
+#if JUCE_USE_SIMD && (defined(__SSE2__) || defined(_M_X64))
+#define HISE_SIMD_RESAMPLING_SSE 1
+#else
+#define HISE_SIMD_RESAMPLING_SSE 0
+#endif
+
+#if JUCE_USE_SIMD && (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#define HISE_SIMD_RESAMPLING_NEON 1
+#else
+#define HISE_SIMD_RESAMPLING_NEON 0
+#endif
+
+// The AVX2 kernels are compiled with a function specific target attribute, so they don't need any compiler flags
+#if HISE_SIMD_RESAMPLING_SSE && (JUCE_GCC || JUCE_CLANG)
+#define HISE_RESAMPLING_TARGET(x) __attribute__((target(x)))
+#else
+#define HISE_RESAMPLING_TARGET(x)
+#endif
+
+/** Some helper functions for the resampling kernels of the streaming sampler. */
+struct InterpolatorHelpers
+{
+	/** The instruction sets that can be used by the linear interpolation kernels. */
+	enum class InstructionSet
+	{
+		Scalar = 0,
+		Vector4, ///< SSE2 or NEON
+		AVX2,
+		numInstructionSets
+	};
+
+	/** Returns the best instruction set that is supported by this CPU. */
+	static InstructionSet getAvailableInstructionSet() noexcept
+	{
+#if HISE_USE_SIMD_RESAMPLING && HISE_SIMD_RESAMPLING_SSE
+		// SSE2 is guaranteed by the compiler flags, AVX2 is detected at runtime
+		return SystemStats::hasAVX2() ? InstructionSet::AVX2 : InstructionSet::Vector4;
+#elif HISE_USE_SIMD_RESAMPLING && HISE_SIMD_RESAMPLING_NEON
+		return InstructionSet::Vector4;
+#else
+		return InstructionSet::Scalar;
+#endif
+	}
+
+	/** Returns the instruction set that is currently used by the kernels. */
+	static InstructionSet getInstructionSet() noexcept { return (InstructionSet)getInstructionSetFlag().load(); }
+
+	/** Changes the instruction set (this is used for benchmarking). It will be limited to the available instruction set. */
+	static void setInstructionSet(InstructionSet newInstructionSet) noexcept
+	{
+		getInstructionSetFlag().store((int)jmin(newInstructionSet, getAvailableInstructionSet()));
+	}
+
+	static String getInstructionSetName(InstructionSet s)
+	{
+		switch (s)
+		{
+		case InstructionSet::Scalar:	return "Scalar";
+		case InstructionSet::Vector4:	return HISE_SIMD_RESAMPLING_NEON ? "NEON" : "SSE2";
+		case InstructionSet::AVX2:		return "AVX2";
+		default:						return {};
+		}
+	}
+
+	static bool isSIMDAvailable() noexcept { return getAvailableInstructionSet() != InstructionSet::Scalar; }
+
+	/** Returns true if the vectorized kernels should be used. You can change this with setSIMDEnabled(). */
+	static bool isSIMDEnabled() noexcept { return getInstructionSet() != InstructionSet::Scalar; }
+
+	/** Enables or disables the vectorized kernels (this is mainly used for benchmarking). */
+	static void setSIMDEnabled(bool shouldBeEnabled) noexcept 
+	{ 
+		setInstructionSet(shouldBeEnabled ? getAvailableInstructionSet() : InstructionSet::Scalar); 
+	}
+
+	/** Converts the 16 bit integer data to float and applies the gain factor. */
+	static void convertInt16ToFloat(const int16* src, float* dst, int numSamples, float gainFactor) noexcept
+	{
+		int i = 0;
+
+		if (isSIMDEnabled())
+		{
+#if HISE_SIMD_RESAMPLING_SSE
+			const __m128 gain = _mm_set1_ps(gainFactor);
+
+			for (; i + 8 <= numSamples; i += 8)
+			{
+				const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+
+				// Sign extend the lower and upper four values to 32 bit integers
+				const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+				const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+
+				_mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), gain));
+				_mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), gain));
+			}
+#elif HISE_SIMD_RESAMPLING_NEON
+			const float32x4_t gain = vdupq_n_f32(gainFactor);
+
+			for (; i + 8 <= numSamples; i += 8)
+			{
+				const int16x8_t v = vld1q_s16(src + i);
+
+				vst1q_f32(dst + i, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), gain));
+				vst1q_f32(dst + i + 4, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), gain));
+			}
+#endif
+		}
+
+		for (; i < numSamples; i++)
+			dst[i] = (float)src[i] * gainFactor;
+	}
+
+#if HISE_SIMD_RESAMPLING_SSE || HISE_SIMD_RESAMPLING_NEON
+
+	/** A minimal abstraction over a register of four floats so that the kernels can be written once for SSE and NEON. */
+	struct Vec4
+	{
+#if HISE_SIMD_RESAMPLING_SSE
+		using Type = __m128;
+		using IntType = __m128i;
+
+		static Type load(const float* d) noexcept { return _mm_loadu_ps(d); }
+		static void store(float* d, Type v) noexcept { _mm_storeu_ps(d, v); }
+		static Type set(float a, float b, float c, float d) noexcept { return _mm_setr_ps(a, b, c, d); }
+		static Type expand(float v) noexcept { return _mm_set1_ps(v); }
+		static Type add(Type a, Type b) noexcept { return _mm_add_ps(a, b); }
+		static Type sub(Type a, Type b) noexcept { return _mm_sub_ps(a, b); }
+		static Type mul(Type a, Type b) noexcept { return _mm_mul_ps(a, b); }
+		static IntType truncate(Type v) noexcept { return _mm_cvttps_epi32(v); }
+		static Type toFloat(IntType v) noexcept { return _mm_cvtepi32_ps(v); }
+		static void storeInt(int* d, IntType v) noexcept { _mm_storeu_si128(reinterpret_cast<__m128i*>(d), v); }
+		static Type broadcastLast(Type v) noexcept { return _mm_shuffle_ps(v, v, 0xFF); }
+
+		/** Returns [0, a, a+b, a+b+c] for [a, b, c, d]. */
+		static Type exclusivePrefixSum(Type v) noexcept
+		{
+			const Type t = _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(v), 4));
+			const Type t1 = _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(t), 4));
+			const Type t2 = _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(t), 8));
+			return _mm_add_ps(_mm_add_ps(t, t1), t2);
+		}
+#else
+		using Type = float32x4_t;
+		using IntType = int32x4_t;
+
+		static Type load(const float* d) noexcept { return vld1q_f32(d); }
+		static void store(float* d, Type v) noexcept { vst1q_f32(d, v); }
+		static Type set(float a, float b, float c, float d) noexcept { const float data[4] = { a, b, c, d }; return vld1q_f32(data); }
+		static Type expand(float v) noexcept { return vdupq_n_f32(v); }
+		static Type add(Type a, Type b) noexcept { return vaddq_f32(a, b); }
+		static Type sub(Type a, Type b) noexcept { return vsubq_f32(a, b); }
+		static Type mul(Type a, Type b) noexcept { return vmulq_f32(a, b); }
+		static IntType truncate(Type v) noexcept { return vcvtq_s32_f32(v); }
+		static Type toFloat(IntType v) noexcept { return vcvtq_f32_s32(v); }
+		static void storeInt(int* d, IntType v) noexcept { vst1q_s32(d, v); }
+		static Type broadcastLast(Type v) noexcept { return vdupq_n_f32(vgetq_lane_f32(v, 3)); }
+
+		/** Returns [0, a, a+b, a+b+c] for [a, b, c, d]. */
+		static Type exclusivePrefixSum(Type v) noexcept
+		{
+			const Type zero = vdupq_n_f32(0.0f);
+			const Type t = vextq_f32(zero, v, 3);
+			return vaddq_f32(vaddq_f32(t, vextq_f32(zero, t, 3)), vextq_f32(zero, t, 2));
+		}
+#endif
+	};
+
+#endif
+
+private:
+
+	static std::atomic<int>& getInstructionSetFlag() noexcept
+	{
+		static std::atomic<int> instructionSet((int)getAvailableInstructionSet());
+		return instructionSet;
+	}
+};
+
+/** The linear interpolation kernels of the StreamingSamplerVoice.
+*
+*	There are three code paths:
+*
+*	- if the pitch is constant and exactly 1.0, the samples are converted / copied with vector operations
+*	- otherwise the read positions are calculated for four samples at once and the interpolation is vectorized
+*	- a scalar fallback for the remaining samples (or if SIMD is not available)
+*/
+struct LinearInterpolator
+{
+	template <typename SignalType, bool isFloat> static void interpolateMono(const SignalType* inL, const SignalType* unusedIn, const float* pitchData, float* outL, float* unusedOut, int startSample, double indexInBuffer, double uptimeDelta, int numSamples)
+	{
+		ignoreUnused(unusedIn, unusedOut);
+
+		process<SignalType, isFloat, false>(inL, nullptr, pitchData, outL, nullptr, startSample, indexInBuffer, uptimeDelta, numSamples);
+	}
+
+	template <typename SignalType, bool isFloat> static void interpolateStereo(const SignalType* inL, const SignalType* inR, const float* pitchData, float* outL, float* outR, int startSample, double indexInBuffer, double uptimeDelta, int numSamples)
+	{
+		process<SignalType, isFloat, true>(inL, inR, pitchData, outL, outR, startSample, indexInBuffer, uptimeDelta, numSamples);
+	}
+
+	/** The scalar implementation. This is used for the remaining samples and as reference for the unit tests. */
+	template <typename SignalType, bool isFloat, bool isStereo> static void processScalar(const SignalType* inL, const SignalType* inR, const float* pitchData, float* outL, float* outR, float indexInBufferFloat, float uptimeDeltaFloat, int numSamples)
+	{
+		constexpr float gainFactor = isFloat ? 1.0f : (1.0f / (float)INT16_MAX);
+
+		for (int i = 0; i < numSamples; i++)
+		{
+			const int pos = int(indexInBufferFloat);
+			const float alpha = indexInBufferFloat - (float)pos;
+			const float invAlpha = 1.0f - alpha;
+
+			outL[i] = ((float)inL[pos] * invAlpha + (float)inL[pos + 1] * alpha) * gainFactor;
+
+			if (isStereo)
+				outR[i] = ((float)inR[pos] * invAlpha + (float)inR[pos + 1] * alpha) * gainFactor;
+
+			if (pitchData != nullptr)
+			{
+				jassert(pitchData[i] <= (float)MAX_SAMPLER_PITCH);
+				indexInBufferFloat += pitchData[i];
+			}
+			else
+				indexInBufferFloat += uptimeDeltaFloat;
+		}
+	}
+
+private:
+
+	template <typename SignalType, bool isFloat, bool isStereo> static void process(const SignalType* inL, const SignalType* inR, const float* pitchData, float* outL, float* outR, int startSample, double indexInBuffer, double uptimeDelta, int numSamples)
+	{
+		if (pitchData != nullptr)
+			pitchData += startSample;
+
+		if (!InterpolatorHelpers::isSIMDEnabled())
+		{
+			processScalar<SignalType, isFloat, isStereo>(inL, inR, pitchData, outL, outR, (float)indexInBuffer, (float)uptimeDelta, numSamples);
+			return;
+		}
+
+		if (pitchData == nullptr && uptimeDelta == 1.0)
+		{
+			processUnityPitch<SignalType, isFloat>(inL, outL, indexInBuffer, numSamples);
+
+			if (isStereo)
+				processUnityPitch<SignalType, isFloat>(inR, outR, indexInBuffer, numSamples);
+
+			return;
+		}
+
+#if HISE_SIMD_RESAMPLING_SSE
+		const int numProcessed = InterpolatorHelpers::getInstructionSet() == InterpolatorHelpers::InstructionSet::AVX2 ?
+			processAVX2<SignalType, isFloat, isStereo>(inL, inR, pitchData, outL, outR, indexInBuffer, uptimeDelta, numSamples) :
+			processSIMD<SignalType, isFloat, isStereo>(inL, inR, pitchData, outL, outR, indexInBuffer, uptimeDelta, numSamples);
+#else
+		const int numProcessed = processSIMD<SignalType, isFloat, isStereo>(inL, inR, pitchData, outL, outR, indexInBuffer, uptimeDelta, numSamples);
+#endif
+
+		if (numProcessed < numSamples)
+		{
+			float indexInBufferFloat = (float)indexInBuffer;
+
+			if (pitchData != nullptr)
+			{
+				for (int i = 0; i < numProcessed; i++)
+					indexInBufferFloat += pitchData[i];
+			}
+			else
+				indexInBufferFloat += (float)numProcessed * (float)uptimeDelta;
+
+			processScalar<SignalType, isFloat, isStereo>(inL, inR, pitchData != nullptr ? pitchData + numProcessed : nullptr,
+				outL + numProcessed, isStereo ? outR + numProcessed : nullptr, indexInBufferFloat, (float)uptimeDelta, numSamples - numProcessed);
+		}
+	}
+
+	/** If the pitch factor is exactly 1.0, the interpolation weights are the same for every sample and the data is contiguous. */
+	template <typename SignalType, bool isFloat> static void processUnityPitch(const SignalType* in, float* out, double indexInBuffer, int numSamples)
+	{
+		const int pos = (int)indexInBuffer;
+		const float alpha = (float)(indexInBuffer - (double)pos);
+
+		const float* src;
+
+		if (isFloat)
+			src = reinterpret_cast<const float*>(in) + pos;
+		else
+		{
+			auto converted = (float*)alloca(sizeof(float) * (numSamples + 1));
+			InterpolatorHelpers::convertInt16ToFloat(reinterpret_cast<const int16*>(in) + pos, converted, numSamples + 1, 1.0f / (float)INT16_MAX);
+			src = converted;
+		}
+
+		if (alpha == 0.0f)
+		{
+			FloatVectorOperations::copy(out, src, numSamples);
+		}
+		else
+		{
+			FloatVectorOperations::copyWithMultiply(out, src, 1.0f - alpha, numSamples);
+			FloatVectorOperations::addWithMultiply(out, src + 1, alpha, numSamples);
+		}
+	}
+
+	/** Processes as many samples as fit into whole SIMD registers and returns the number of processed samples. 
+	*
+	*	The read positions of four samples are calculated at once (using a prefix sum for the pitch modulation), then the 
+	*	samples are gathered from the positions and interpolated in the vector registers. */
+	template <typename SignalType, bool isFloat, bool isStereo> static int processSIMD(const SignalType* inL, const SignalType* inR, const float* pitchData, float* outL, float* outR, double indexInBuffer, double uptimeDelta, int numSamples)
+	{
+#if HISE_SIMD_RESAMPLING_SSE || HISE_SIMD_RESAMPLING_NEON
+		using V = InterpolatorHelpers::Vec4;
+
+		constexpr float gainFactor = isFloat ? 1.0f : (1.0f / (float)INT16_MAX);
+
+		const V::Type one = V::expand(1.0f);
+		const V::Type gain = V::expand(gainFactor);
+
+		const float uptimeDeltaFloat = (float)uptimeDelta;
+
+		V::Type base = V::expand((float)indexInBuffer);
+		const V::Type constantOffsets = V::set(0.0f, uptimeDeltaFloat, 2.0f * uptimeDeltaFloat, 3.0f * uptimeDeltaFloat);
+		const V::Type constantStep = V::expand(4.0f * uptimeDeltaFloat);
+
+		int pos[4];
+
+		int i = 0;
+
+		for (; i + 4 <= numSamples; i += 4)
+		{
+			V::Type index;
+
+			if (pitchData != nullptr)
+			{
+				const V::Type p = V::load(pitchData + i);
+				const V::Type offsets = V::exclusivePrefixSum(p);
+
+				index = V::add(base, offsets);
+				base = V::broadcastLast(V::add(index, p));
+			}
+			else
+			{
+				index = V::add(base, constantOffsets);
+				base = V::add(base, constantStep);
+			}
+
+			const V::IntType intIndex = V::truncate(index);
+			const V::Type alpha = V::sub(index, V::toFloat(intIndex));
+			const V::Type invAlpha = V::sub(one, alpha);
+
+			V::storeInt(pos, intIndex);
+
+			const V::Type l0 = V::set((float)inL[pos[0]], (float)inL[pos[1]], (float)inL[pos[2]], (float)inL[pos[3]]);
+			const V::Type l1 = V::set((float)inL[pos[0] + 1], (float)inL[pos[1] + 1], (float)inL[pos[2] + 1], (float)inL[pos[3] + 1]);
+
+			V::store(outL + i, V::mul(V::add(V::mul(l0, invAlpha), V::mul(l1, alpha)), gain));
+
+			if (isStereo)
+			{
+				const V::Type r0 = V::set((float)inR[pos[0]], (float)inR[pos[1]], (float)inR[pos[2]], (float)inR[pos[3]]);
+				const V::Type r1 = V::set((float)inR[pos[0] + 1], (float)inR[pos[1] + 1], (float)inR[pos[2] + 1], (float)inR[pos[3] + 1]);
+
+				V::store(outR + i, V::mul(V::add(V::mul(r0, invAlpha), V::mul(r1, alpha)), gain));
+			}
+		}
+
+		return i;
+#else
+		ignoreUnused(inL, inR, pitchData, outL, outR, indexInBuffer, uptimeDelta, numSamples);
+		return 0;
+#endif
+	}
+
+#if HISE_SIMD_RESAMPLING_SSE
+
+	/** Reads the samples at the positions and the positions + 1 with gather instructions. 
+	*
+	*	For 16 bit data, a single 32 bit gather fetches both samples (the sample at the position ends up in the lower half). */
+	template <typename SignalType, bool isFloat> HISE_RESAMPLING_TARGET("avx2") static void gatherAVX2(const SignalType* in, __m256i pos, __m256& v0, __m256& v1) noexcept
+	{
+		if (isFloat)
+		{
+			auto d = reinterpret_cast<const float*>(in);
+
+			v0 = _mm256_i32gather_ps(d, pos, 4);
+			v1 = _mm256_i32gather_ps(d + 1, pos, 4);
+		}
+		else
+		{
+			const __m256i both = _mm256_i32gather_epi32(reinterpret_cast<const int*>(in), pos, 2);
+
+			v0 = _mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_slli_epi32(both, 16), 16));
+			v1 = _mm256_cvtepi32_ps(_mm256_srai_epi32(both, 16));
+		}
+	}
+
+	/** The AVX2 version of processSIMD() that calculates eight samples at once. */
+	template <typename SignalType, bool isFloat, bool isStereo> HISE_RESAMPLING_TARGET("avx2") static int processAVX2(const SignalType* inL, const SignalType* inR, const float* pitchData, float* outL, float* outR, double indexInBuffer, double uptimeDelta, int numSamples)
+	{
+		constexpr float gainFactor = isFloat ? 1.0f : (1.0f / (float)INT16_MAX);
+
+		const __m256 one = _mm256_set1_ps(1.0f);
+		const __m256 gain = _mm256_set1_ps(gainFactor);
+
+		const float d = (float)uptimeDelta;
+
+		__m256 base = _mm256_set1_ps((float)indexInBuffer);
+		const __m256 constantOffsets = _mm256_setr_ps(0.0f, d, 2.0f * d, 3.0f * d, 4.0f * d, 5.0f * d, 6.0f * d, 7.0f * d);
+		const __m256 constantStep = _mm256_set1_ps(8.0f * d);
+
+		const __m256i fourthLane = _mm256_set1_epi32(3);
+		const __m256i lastLane = _mm256_set1_epi32(7);
+
+		int i = 0;
+
+		for (; i + 8 <= numSamples; i += 8)
+		{
+			__m256 index;
+
+			if (pitchData != nullptr)
+			{
+				const __m256 p = _mm256_loadu_ps(pitchData + i);
+
+				// The inclusive prefix sum within both 128 bit halves...
+				__m256 sum = _mm256_add_ps(p, _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(p), 4)));
+				sum = _mm256_add_ps(sum, _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(sum), 8)));
+
+				// ...plus the sum of the lower half for the upper half
+				sum = _mm256_add_ps(sum, _mm256_blend_ps(_mm256_setzero_ps(), _mm256_permutevar8x32_ps(sum, fourthLane), 0xF0));
+
+				index = _mm256_add_ps(base, _mm256_sub_ps(sum, p));
+				base = _mm256_add_ps(base, _mm256_permutevar8x32_ps(sum, lastLane));
+			}
+			else
+			{
+				index = _mm256_add_ps(base, constantOffsets);
+				base = _mm256_add_ps(base, constantStep);
+			}
+
+			const __m256i pos = _mm256_cvttps_epi32(index);
+			const __m256 alpha = _mm256_sub_ps(index, _mm256_cvtepi32_ps(pos));
+			const __m256 invAlpha = _mm256_sub_ps(one, alpha);
+
+			__m256 v0, v1;
+
+			gatherAVX2<SignalType, isFloat>(inL, pos, v0, v1);
+			_mm256_storeu_ps(outL + i, _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(v0, invAlpha), _mm256_mul_ps(v1, alpha)), gain));
+
+			if (isStereo)
+			{
+				gatherAVX2<SignalType, isFloat>(inR, pos, v0, v1);
+				_mm256_storeu_ps(outR + i, _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(v0, invAlpha), _mm256_mul_ps(v1, alpha)), gain));
+			}
+		}
+
+		return i;
+	}
+
+#endif
+};
+
+/** The interpolation algorithms that can be used by the StreamingSamplerVoice. */
+enum class SampleInterpolationMode
+{
+	Linear = 0, ///< the default linear interpolation (fastest)
+	Hermite, ///< 4-point, 3rd order hermite interpolation
+	Sinc, ///< windowed sinc interpolation with a precomputed polyphase table (best quality)
+	numInterpolationModes
+};
+
+/** A 4-point, 3rd order hermite (Catmull-Rom) kernel. */
+struct HermiteKernel
+{
+	/** The number of samples before the read position that are used by the kernel. */
+	static constexpr int NumLeft = 1;
+
+	/** The number of samples after the read position that are used by the kernel. */
+	static constexpr int NumRight = 2;
+
+	/** The hermite kernel has no anti-aliasing, so there is nothing to select. */
+	struct Table {};
+
+	static const Table* getTableForPitch(double /*pitchRatio*/) noexcept { return nullptr; }
+
+	static forcedinline float interpolate(const Table* /*table*/, const float* d, float alpha) noexcept
+	{
+		return interpolate(d, alpha);
+	}
+
+	static forcedinline float interpolate(const float* d, float alpha) noexcept
+	{
+		const float ym1 = d[-1];
+		const float y0 = d[0];
+		const float y1 = d[1];
+		const float y2 = d[2];
+
+		const float c1 = 0.5f * (y1 - ym1);
+		const float c2 = ym1 - 2.5f * y0 + 2.0f * y1 - 0.5f * y2;
+		const float c3 = 0.5f * (y2 - ym1) + 1.5f * (y0 - y1);
+
+		return ((c3 * alpha + c2) * alpha + c1) * alpha + y0;
+	}
+};
+
+/** A windowed sinc kernel that uses a precomputed polyphase table.
+*
+*	The table contains the (Blackman windowed) sinc coefficients for NumPhases fractional positions, 
+*	so the interpolation is just a dot product of the surrounding samples with the nearest phase. 
+*	Call getTable() once on a non-realtime thread before using this kernel so that the table is not 
+*	calculated in the audio thread.
+*
+*	If the pitch ratio is above 1, the cutoff of the sinc is lowered to 1 / pitchRatio so that the
+*	frequencies above the new nyquist frequency are removed instead of aliasing back. There are 
+*	NumBands tables with the cutoff in half octave steps (getTableForPitch() picks the first table 
+*	that has a cutoff below the pitch ratio). The number of taps stays the same, so the transition
+*	band gets wider for the lower cutoffs and pitch ratios above 8 still alias slightly.
+*/
+struct SincKernel
+{
+	static constexpr int NumTaps = 16;
+	static constexpr int NumLeft = NumTaps / 2 - 1;
+	static constexpr int NumRight = NumTaps / 2;
+	static constexpr int NumPhases = 1024;
+	static constexpr int NumBands = 7;
+
+	struct Table
+	{
+		Table()
+		{
+			setCutoff(1.0);
+		}
+
+		/** Calculates the coefficients for the given cutoff (relative to the nyquist frequency). */
+		void setCutoff(double cutoff)
+		{
+			const double halfWidth = (double)NumTaps / 2.0;
+
+			for (int p = 0; p <= NumPhases; p++)
+			{
+				const double alpha = (double)p / (double)NumPhases;
+				float* c = getCoefficients(p);
+				double sum = 0.0;
+
+				for (int i = 0; i < NumTaps; i++)
+				{
+					const double x = (double)(i - NumLeft) - alpha;
+					const double sinc = x == 0.0 ? 1.0 : std::sin(double_Pi * cutoff * x) / (double_Pi * cutoff * x);
+					const double w = 0.42 + 0.5 * std::cos(double_Pi * x / halfWidth) + 0.08 * std::cos(2.0 * double_Pi * x / halfWidth);
+
+					c[i] = (float)(sinc * w);
+					sum += c[i];
+				}
+
+				// Normalise every phase to unity gain at DC
+				for (int i = 0; i < NumTaps; i++)
+					c[i] = (float)(c[i] / sum);
+			}
+		}
+
+		float* getCoefficients(int phase) noexcept { return coefficients + phase * NumTaps; }
+		const float* getCoefficients(int phase) const noexcept { return coefficients + phase * NumTaps; }
+
+		float coefficients[(NumPhases + 1) * NumTaps];
+	};
+
+	struct BandTables
+	{
+		BandTables()
+		{
+			for (int i = 1; i < NumBands; i++)
+				tables[i].setCutoff(std::pow(2.0, -0.5 * (double)i));
+		}
+
+		Table tables[NumBands];
+	};
+
+	static const BandTables& getBandTables()
+	{
+		static const BandTables bandTables;
+		return bandTables;
+	}
+
+	/** Returns the table with the full bandwidth. This also calculates the tables for the other bands. */
+	static const Table& getTable()
+	{
+		return getBandTables().tables[0];
+	}
+
+	/** Returns the table with a cutoff that removes the frequencies that would alias with the given pitch ratio. */
+	static const Table* getTableForPitch(double pitchRatio) noexcept
+	{
+		int band = 0;
+
+		if (pitchRatio > 1.001)
+			band = jmin<int>(NumBands - 1, (int)std::ceil(2.0 * std::log2(pitchRatio) - 0.01));
+
+		return getBandTables().tables + band;
+	}
+
+	static forcedinline float interpolate(const float* d, float alpha) noexcept
+	{
+		return interpolate(&getTable(), d, alpha);
+	}
+
+	static forcedinline float interpolate(const Table* table, const float* d, float alpha) noexcept
+	{
+		const float* c = table->getCoefficients((int)(alpha * (float)NumPhases + 0.5f));
+		const float* s = d - NumLeft;
+
+		float sum = 0.0f;
+
+		for (int i = 0; i < NumTaps; i++)
+			sum += s[i] * c[i];
+
+		return sum;
+	}
+};
+
+/** Resamples float data with one of the higher order kernels (HermiteKernel or SincKernel).
+*
+*	Unlike the LinearInterpolator, the kernel needs samples before the read position, so the 
+*	input pointers must have KernelType::NumLeft valid samples before and KernelType::NumRight 
+*	valid samples after every read position (the StreamingSamplerVoice keeps a small history for this).
+*
+*	The maxPitchRatio is used to select the anti-aliasing band of the kernel, so pass in the highest
+*	pitch ratio of the block.
+*/
+template <class KernelType> struct KernelInterpolator
+{
+	template <bool isStereo> static void process(const float* inL, const float* inR, const float* pitchData, float* outL, float* outR, double indexInBuffer, double uptimeDelta, int numSamples, double maxPitchRatio=1.0)
+	{
+		const auto* table = KernelType::getTableForPitch(maxPitchRatio);
+
+		for (int i = 0; i < numSamples; i++)
+		{
+			const int pos = (int)indexInBuffer;
+			const float alpha = (float)(indexInBuffer - (double)pos);
+
+			outL[i] = KernelType::interpolate(table, inL + pos, alpha);
+
+			if (isStereo)
+				outR[i] = KernelType::interpolate(table, inR + pos, alpha);
+
+			indexInBuffer += pitchData != nullptr ? (double)pitchData[i] : uptimeDelta;
+		}
+	}
+};
+
+} // namespace hise
+
+#endif  // SAMPLEINTERPOLATORS_H_INCLUDED
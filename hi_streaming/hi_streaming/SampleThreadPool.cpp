@@ -35,52 +35,190 @@ namespace hise { using namespace juce;
 
 struct SampleThreadPool::Pimpl
 {
+	enum
+	{
+		MaxNumWorkerThreads = 16
+	};
+
+	/** The state of each thread that processes jobs (index 0 is the main loading thread). */
+	struct WorkerState
+	{
+		WorkerState() :
+			diskUsage(0.0),
+			threadId(nullptr),
+			currentlyExecutedJob(nullptr)
+		{};
+
+		int64 startTime = 0;
+		int64 endTime = 0;
+
+		std::atomic<double> diskUsage;
+
+		std::atomic<Thread::ThreadID> threadId;
+
+		std::atomic<Job*> currentlyExecutedJob;
+	};
+
+	/** An additional thread that processes the jobs from the worker queue. */
+	class WorkerThread : public Thread
+	{
+	public:
+
+		WorkerThread(SampleThreadPool& parent_, int workerIndex_) :
+			Thread("Sample Loading Worker " + String(workerIndex_)),
+			parent(parent_),
+			workerIndex(workerIndex_)
+		{};
+
+		void run() override
+		{
+			parent.pimpl->states[workerIndex].threadId.store(getCurrentThreadId());
+
+			while (!threadShouldExit())
+			{
+				if (!parent.pimpl->processNextJob(this, workerIndex))
+					wait(500);
+			}
+
+			parent.pimpl->states[workerIndex].threadId.store(nullptr);
+		}
+
+	private:
+
+		SampleThreadPool& parent;
+		const int workerIndex;
+	};
+
 	Pimpl() :
 		jobQueue(8192),
-		currentlyExecutedJob(nullptr),
-		diskUsage(0.0),
+		workerQueue(8192),
 		counter(0)
-	{};
+	{
+		pendingJobs.reserve(8192);
+		resetSlackStatistics();
+	};
 
 	~Pimpl()
 	{
-		if (auto currentJob = currentlyExecutedJob.load())
+		jassert(workers.isEmpty());
+
+		for (auto& s : states)
 		{
-			currentJob->signalJobShouldExit();
+			if (auto currentJob = s.currentlyExecutedJob.load())
+				currentJob->signalJobShouldExit();
 		}
 	}
 
-	Atomic<int> counter;
+	bool processNextJob(Thread* thread, int workerIndex);
 
-	std::atomic<double> diskUsage;
+	/** Sets the job to running. If another thread is running the job, it marks it as requested and returns false. */
+	bool tryToStartJob(Job* j);
 
-	int64 startTime, endTime;
+	/** Sets the job back to idle and returns true if it was requested again while it was running. */
+	bool finishJobRun(Job* j);
 
+	/** Moves all jobs from the worker queue into the pending heap and picks the one with the earliest deadline. */
+	bool dequeueMostUrgentJob(WeakReference<Job>& next);
+
+	void updateSlackStatistics(Job* j, int64 finishTime);
+
+	void resetSlackStatistics()
+	{
+		SpinLock::ScopedLockType sl(slackLock);
+
+		slackStatistics = {};
+		slackStatistics.minSlack = std::numeric_limits<double>::max();
+	}
+
+	void stopWorkers()
+	{
+		for (auto w : workers)
+			w->signalThreadShouldExit();
+
+		for (auto w : workers)
+			w->notify();
+
+		for (auto w : workers)
+			w->stopThread(1000);
+
+		workers.clear();
+	}
+
+	Atomic<int> counter;
+
+	WorkerState states[MaxNumWorkerThreads];
+
+	/** The queue for jobs that must be executed on the main loading thread. */
 	moodycamel::ReaderWriterQueue<WeakReference<Job>> jobQueue;
 
-	std::atomic<Job*> currentlyExecutedJob;
+	/** The queue for jobs that can be executed by any thread. */
+	moodycamel::ConcurrentQueue<WeakReference<Job>> workerQueue;
+
+	OwnedArray<WorkerThread> workers;
+
+	/** A job in the pending heap. The deadline is copied so that the heap order can't change while it's pending. */
+	struct PendingJob
+	{
+		/** Returns true if the other job is more urgent. Jobs with the same deadline are processed in the order they were added. */
+		bool operator<(const PendingJob& other) const noexcept
+		{
+			if (deadline != other.deadline)
+				return deadline > other.deadline;
+
+			return index > other.index;
+		}
+
+		int64 deadline;
+		uint64 index;
+		WeakReference<Job> job;
+	};
+
+	SpinLock pendingLock;
+
+	/** The jobs that were taken from the worker queue, but weren't processed yet (a max-heap with the most urgent job on top). */
+	std::vector<PendingJob> pendingJobs;
+
+	uint64 pendingJobCounter = 0;
+
+	SpinLock slackLock;
+
+	Job::SlackStatistics slackStatistics;
 
 	static const String errorMessage;
 };
 
-SampleThreadPool::SampleThreadPool() :
+SampleThreadPool::SampleThreadPool(int numWorkerThreads) :
 	Thread("Sample Loading Thread"),
 	pimpl(new Pimpl())
 {
-
 	startThread(9);
 	
+	setNumWorkerThreads(numWorkerThreads);
 }
 
 SampleThreadPool::~SampleThreadPool()
 {
+	pimpl->stopWorkers();
 	stopThread(1000);
 	pimpl = nullptr;
 }
 
 double SampleThreadPool::getDiskUsage() const noexcept
 {
-	return pimpl->diskUsage.load();
+	double maxUsage = 0.0;
+
+	for (int i = 0; i < getNumWorkerThreads(); i++)
+		maxUsage = jmax<double>(maxUsage, getDiskUsage(i));
+
+	return maxUsage;
+}
+
+double SampleThreadPool::getDiskUsage(int workerIndex) const noexcept
+{
+	if (isPositiveAndBelow(workerIndex, (int)Pimpl::MaxNumWorkerThreads))
+		return pimpl->states[workerIndex].diskUsage.load();
+
+	return 0.0;
 }
 
 void SampleThreadPool::addJob(Job* jobToAdd, bool unused)
@@ -99,77 +237,306 @@ void SampleThreadPool::addJob(Job* jobToAdd, bool unused)
 
 
 	jobToAdd->queued.store(true);
-	pimpl->jobQueue.enqueue(jobToAdd);
 
+	if (jobToAdd->canRunOnWorkerThread())
+	{
+		pimpl->workerQueue.enqueue(jobToAdd);
+		notifyAllWorkers();
+	}
+	else
+	{
+		pimpl->jobQueue.enqueue(jobToAdd);
+		notify();
+	}
+}
 
-	notify();
+SampleThreadPool::Job::SlackStatistics SampleThreadPool::getSlackStatistics() const noexcept
+{
+	SpinLock::ScopedLockType sl(pimpl->slackLock);
+
+	auto copy = pimpl->slackStatistics;
+
+	if (copy.minSlack == std::numeric_limits<double>::max())
+		copy.minSlack = 0.0;
+
+	return copy;
 }
 
-void SampleThreadPool::run()
+void SampleThreadPool::resetSlackStatistics() noexcept
 {
-	while (!threadShouldExit())
+	pimpl->resetSlackStatistics();
+}
+
+void SampleThreadPool::setNumWorkerThreads(int newNumWorkerThreads)
+{
+	newNumWorkerThreads = jlimit<int>(1, (int)Pimpl::MaxNumWorkerThreads, newNumWorkerThreads);
+
+	if (newNumWorkerThreads == getNumWorkerThreads())
+		return;
+
+	pimpl->stopWorkers();
+
+	for (int i = 1; i < newNumWorkerThreads; i++)
 	{
-		WeakReference<Job> next;
+		auto w = new Pimpl::WorkerThread(*this, i);
+		pimpl->workers.add(w);
+		w->startThread(9);
+	}
+}
 
-		if (pimpl->jobQueue.try_dequeue(next))
-		{
-			Job* j = next.get();
+int SampleThreadPool::getNumWorkerThreads() const noexcept
+{
+	return pimpl->workers.size() + 1;
+}
+
+bool SampleThreadPool::isLoadingThread(Thread::ThreadID threadId) const noexcept
+{
+	if (threadId == nullptr)
+		return false;
+
+	if (threadId == getThreadId())
+		return true;
+
+	for (int i = 1; i < Pimpl::MaxNumWorkerThreads; i++)
+	{
+		if (pimpl->states[i].threadId.load() == threadId)
+			return true;
+	}
+
+	return false;
+}
+
+void SampleThreadPool::notifyAllWorkers()
+{
+	notify();
+
+	for (auto w : pimpl->workers)
+		w->notify();
+}
+
+bool SampleThreadPool::Pimpl::processNextJob(Thread* thread, int workerIndex)
+{
+	WeakReference<Job> next;
+
+	const bool isWorkerJob = dequeueMostUrgentJob(next);
+
+	// Only the main loading thread processes jobs that can't run on a worker thread.
+	if (!isWorkerJob && (workerIndex != 0 || !jobQueue.try_dequeue(next)))
+		return false;
+
+	auto& state = states[workerIndex];
 
 #if ENABLE_CPU_MEASUREMENT
 
-			const int64 lastEndTime = pimpl->endTime;
-			pimpl->startTime = Time::getHighResolutionTicks();
+	const int64 lastEndTime = state.endTime;
+	state.startTime = Time::getHighResolutionTicks();
 #endif
 
-			if (j != nullptr)
-			{
-				pimpl->currentlyExecutedJob.store(j);
+	if (Job* j = next.get())
+	{
+		if (!tryToStartJob(j))
+		{
+			// The job was queued twice and is currently executed by another worker. The other worker
+			// will queue it again when it's done, so this request is merged into that run.
+			--counter;
+			return true;
+		}
 
-				j->currentThread.store(this);
+		state.currentlyExecutedJob.store(j);
 
-				j->running.store(true);
-				
-				Job::JobStatus status = j->runJob();
+		j->currentThread.store(thread);
 
-				j->running.store(false);
+		Job::JobStatus status = j->runJob();
 
-				if (status == Job::jobHasFinished)
-				{
-					j->queued.store(false);
-					--pimpl->counter;
-				}
-				else if (status == Job::jobNeedsRunningAgain)
-				{
-					pimpl->jobQueue.enqueue(next);
-				}
+		if (finishJobRun(j))
+			status = Job::jobNeedsRunningAgain;
 
-				pimpl->currentlyExecutedJob.store(nullptr);
-			}
+		if (status == Job::jobHasFinished)
+		{
+			updateSlackStatistics(j, Time::getHighResolutionTicks());
+
+			j->queued.store(false);
+			--counter;
+		}
+		else if (status == Job::jobNeedsRunningAgain)
+		{
+			if (isWorkerJob)
+				workerQueue.enqueue(next);
 			else
-			{
-				pimpl->jobQueue.pop();
-			}
+				jobQueue.enqueue(next);
+		}
+
+		state.currentlyExecutedJob.store(nullptr);
+	}
 
 #if ENABLE_CPU_MEASUREMENT
-			pimpl->endTime = Time::getHighResolutionTicks();
+	state.endTime = Time::getHighResolutionTicks();
 
-			const int64 idleTime = pimpl->startTime - lastEndTime;
-			const int64 busyTime = pimpl->endTime - pimpl->startTime;
+	const int64 idleTime = state.startTime - lastEndTime;
+	const int64 busyTime = state.endTime - state.startTime;
 
-			pimpl->diskUsage.store((double)busyTime / (double)(idleTime + busyTime));
+	state.diskUsage.store((double)busyTime / (double)(idleTime + busyTime));
 #endif
+
+	return true;
+}
+
+bool SampleThreadPool::Pimpl::tryToStartJob(Job* j)
+{
+	for (;;)
+	{
+		int s = j->runState.load();
+
+		if (s == Job::Idle)
+		{
+			if (j->runState.compare_exchange_weak(s, Job::Running))
+				return true;
+		}
+		else if (s == Job::Running)
+		{
+			if (j->runState.compare_exchange_weak(s, Job::RunningAndRequested))
+				return false;
+		}
+		else
+			return false;
+	}
+}
+
+bool SampleThreadPool::Pimpl::finishJobRun(Job* j)
+{
+	int expected = Job::Running;
+
+	if (j->runState.compare_exchange_strong(expected, Job::Idle))
+		return false;
+
+	jassert(expected == Job::RunningAndRequested);
+
+	j->runState.store(Job::Idle);
+	return true;
+}
+
+bool SampleThreadPool::Pimpl::dequeueMostUrgentJob(WeakReference<Job>& next)
+{
+	WeakReference<Job> newJobs[32];
+
+	// The new jobs are prefetched outside the lock, so that the system calls don't block the other workers
+	while (auto numNewJobs = workerQueue.try_dequeue_bulk(newJobs, numElementsInArray(newJobs)))
+	{
+		for (size_t i = 0; i < numNewJobs; i++)
+		{
+			if (auto newJob = newJobs[i].get())
+				newJob->prefetch();
+		}
+
+		SpinLock::ScopedLockType sl(pendingLock);
+
+		for (size_t i = 0; i < numNewJobs; i++)
+		{
+			auto newJob = newJobs[i].get();
+
+			if (newJob == nullptr)
+				continue;
+
+			PendingJob p;
+
+			// Jobs without a deadline are processed after all jobs with a deadline
+			p.deadline = newJob->usesDeadline.load() ? newJob->deadline.load() : std::numeric_limits<int64>::max();
+			p.index = pendingJobCounter++;
+			p.job = newJobs[i];
+
+			pendingJobs.push_back(p);
+			std::push_heap(pendingJobs.begin(), pendingJobs.end());
 		}
+	}
+
+	SpinLock::ScopedLockType sl(pendingLock);
+
+	while (!pendingJobs.empty())
+	{
+		std::pop_heap(pendingJobs.begin(), pendingJobs.end());
+		next = pendingJobs.back().job;
+		pendingJobs.pop_back();
+
+		// Skip jobs that were deleted while they were pending
+		if (next.get() != nullptr)
+			return true;
+	}
+
+	return false;
+}
+
+void SampleThreadPool::Pimpl::updateSlackStatistics(Job* j, int64 finishTime)
+{
+	const bool hadDeadline = j->usesDeadline.load();
+	const int64 deadline = j->deadline.load();
+
+	j->deadline.store(0);
+	j->usesDeadline.store(false);
+
+	if (!hadDeadline)
+		return;
+
+	const double slack = Time::highResolutionTicksToSeconds(deadline - finishTime);
+	const bool missed = slack < 0.0;
+
+	j->lastSlack.store((float)slack);
+	j->minSlack.store(jmin<float>(j->minSlack.load(), (float)slack));
+
+	if (missed)
+		++j->numDeadlinesMissed;
+
+	SpinLock::ScopedLockType sl(slackLock);
+
+	slackStatistics.lastSlack = slack;
+	slackStatistics.minSlack = jmin<double>(slackStatistics.minSlack, slack);
 
+	if (missed)
+		slackStatistics.numDeadlinesMissed++;
+}
+
+void SampleThreadPool::Job::setDeadline(double secondsFromNow) noexcept
+{
+	const int64 ticks = (int64)(jmax<double>(0.0, secondsFromNow) * (double)Time::getHighResolutionTicksPerSecond());
+
+	deadline.store(Time::getHighResolutionTicks() + ticks);
+	usesDeadline.store(true);
+}
+
+SampleThreadPool::Job::SlackStatistics SampleThreadPool::Job::getSlackStatistics() const noexcept
+{
+	SlackStatistics s;
+
+	s.lastSlack = (double)lastSlack.load();
+	s.numDeadlinesMissed = numDeadlinesMissed.load();
+
+	const float m = minSlack.load();
+	s.minSlack = m == std::numeric_limits<float>::max() ? 0.0 : (double)m;
+
+	return s;
+}
+
+void SampleThreadPool::Job::resetSlackStatistics() noexcept
+{
+	lastSlack.store(0.0f);
+	minSlack.store(std::numeric_limits<float>::max());
+	numDeadlinesMissed.store(0);
+}
+
+void SampleThreadPool::run()
+{
+	pimpl->states[0].threadId.store(getCurrentThreadId());
+
+	while (!threadShouldExit())
+	{
 #if 0 // Set this to true to enable defective threading (for debugging purposes)
+		pimpl->processNextJob(this, 0);
 		wait(500);
 #else
-		else
+		if (!pimpl->processNextJob(this, 0))
 		{
 			wait(500);
 		}
 #endif
-
-
 	}
 }
 
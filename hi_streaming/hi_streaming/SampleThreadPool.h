@@ -35,11 +35,24 @@
 
 namespace hise { using namespace juce;
 
+// The amount of threads that process the streaming jobs. The default is a single thread, but if you are streaming from fast SSDs,
+// you can increase this number to process multiple voices concurrently (it can be changed dynamically with SampleThreadPool::setNumWorkerThreads()).
+#ifndef NUM_STREAMING_WORKER_THREADS
+#define NUM_STREAMING_WORKER_THREADS 1
+#endif
+
+/** The background thread pool that processes the streaming jobs.
+*
+*	The pool itself is the main loading thread which runs every job (including the preloading and unmapping jobs).
+*	If you set the amount of worker threads to more than one, the jobs that return true in canRunOnWorkerThread() are 
+*	put into a multi-consumer queue and the additional worker threads will process them concurrently. This allows fast 
+*	SSDs to serve multiple read requests at the same time.
+*/
 class SampleThreadPool : public Thread
 {
 public:
 
-	SampleThreadPool();
+	SampleThreadPool(int numWorkerThreads=NUM_STREAMING_WORKER_THREADS);
 
 	~SampleThreadPool();
 	
@@ -51,8 +64,13 @@ public:
 		Job(const String &name_) : 
 			name(name_),
 			queued(false),
-			running(false),
-			shouldStop(false)
+			runState(Idle),
+			shouldStop(false),
+			deadline(0),
+			usesDeadline(false),
+			lastSlack(0.0f),
+			minSlack(std::numeric_limits<float>::max()),
+			numDeadlinesMissed(0)
 		{};
         
         virtual ~Job() { masterReference.clear(); }
@@ -69,10 +87,51 @@ public:
 
 		void signalJobShouldExit() { shouldStop.store(true); }
 
-		bool isRunning() const noexcept{ return running.load(); };
+		bool isRunning() const noexcept{ return runState.load() != Idle; };
 
 		bool isQueued() const noexcept{ return queued.load(); };
 
+		/** Override this and return true if the job can be executed by any worker thread.
+		*
+		*	Jobs that return false here will always be executed by the main loading thread. Jobs that can run
+		*	on a worker thread must not rely on being called from a specific thread and must make sure that 
+		*	their data access is thread safe.
+		*/
+		virtual bool canRunOnWorkerThread() const noexcept { return false; }
+
+		/** Override this and tell the OS which data the job will read.
+		*
+		*	This will be called once for every job that can run on a worker thread as soon as it is picked up by 
+		*	the pool, so that the data of all pending jobs can be fetched concurrently while the most urgent job is
+		*	being processed. It must not block and it must not change the state of the job.
+		*/
+		virtual void prefetch() {}
+
+		/** Contains the slack (the time between the completion of the job and its deadline) of a job. 
+		*
+		*	A negative slack means that the job finished too late (for a SampleLoader this means a streaming failure).
+		*/
+		struct SlackStatistics
+		{
+			double lastSlack = 0.0;
+			double minSlack = 0.0;
+			int numDeadlinesMissed = 0;
+		};
+
+		/** Sets the time in seconds until the job has to be finished. 
+		*
+		*	Call this before adding the job to the pool. Jobs that can run on worker threads will be sorted by their
+		*	deadline, so that the most urgent job is processed first. Jobs without a deadline are processed after all
+		*	jobs with a deadline in the order they were added.
+		*/
+		void setDeadline(double secondsFromNow) noexcept;
+
+		/** Returns the slack statistics of this job. */
+		SlackStatistics getSlackStatistics() const noexcept;
+
+		/** Clears the slack statistics (eg. when a voice is restarted). */
+		void resetSlackStatistics() noexcept;
+
 	protected:
 
 		Thread* getCurrentThread() { return currentThread.load(); }
@@ -80,25 +139,68 @@ public:
 	private:
 
 		friend class SampleThreadPool;
+
+		enum RunState
+		{
+			Idle = 0,
+			Running,
+			RunningAndRequested		///< the job was added again while it was running, so it needs another run
+		};
         
         friend class WeakReference<Job>;
         WeakReference<Job>::Master masterReference;
 
 		std::atomic<bool> queued;
 
-		std::atomic<bool> running;
+		std::atomic<int> runState;
 
 		std::atomic<bool> shouldStop;
 
 		std::atomic<Thread*> currentThread;
 
+		std::atomic<int64> deadline;
+
+		std::atomic<bool> usesDeadline;
+
+		std::atomic<float> lastSlack;
+
+		std::atomic<float> minSlack;
+
+		std::atomic<int> numDeadlinesMissed;
+
 		const String name;
 	};
 
+	/** Returns the highest disk usage of all worker threads. */
 	double getDiskUsage() const noexcept;
 
+	/** Returns the disk usage of the given worker thread (0 is the main loading thread). */
+	double getDiskUsage(int workerIndex) const noexcept;
+
 	void addJob(Job* jobToAdd, bool unused);
 
+	/** Returns the slack statistics of every job with a deadline that was processed since the last reset. */
+	Job::SlackStatistics getSlackStatistics() const noexcept;
+
+	/** Clears the slack statistics of the pool. */
+	void resetSlackStatistics() noexcept;
+
+	/** Changes the amount of threads that process the streaming jobs. 
+	*
+	*	The main loading thread counts as one, so if you pass in 1 here, it will use the single threaded behaviour. 
+	*	Don't call this while voices are playing.
+	*/
+	void setNumWorkerThreads(int newNumWorkerThreads);
+
+	/** Returns the amount of threads that process streaming jobs (including the main loading thread). */
+	int getNumWorkerThreads() const noexcept;
+
+	/** Checks whether the given thread is either the main loading thread or one of the worker threads. */
+	bool isLoadingThread(Thread::ThreadID threadId) const noexcept;
+
+	/** Wakes up every thread of the pool. */
+	void notifyAllWorkers();
+
 	void run() override;
 
 	struct Pimpl;
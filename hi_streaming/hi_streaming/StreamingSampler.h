@@ -138,7 +138,8 @@ struct StereoChannelData
 // Same as the preload size.
 #define BUFFER_SIZE_FOR_STREAM_BUFFERS 8192
 
-// Deactivate this to use one rounded pitch value for one a buffer (crucial for other interpolation methods than linear interpolation)
+// Deactivate this to use one rounded pitch value for one a buffer. This is not required for the higher order interpolation modes
+// (see SampleInterpolationMode) as the voice keeps the samples before the read position between the buffers.
 #define USE_SAMPLE_ACCURATE_RESAMPLING 0
 
 #if HISE_IOS
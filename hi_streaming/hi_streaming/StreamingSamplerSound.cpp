@@ -673,6 +673,20 @@ void StreamingSamplerSound::fillSampleBuffer(hlac::HiseSampleBuffer &sampleBuffe
 	}
 };
 
+void StreamingSamplerSound::prefetchSampleData(int samplesToCopy, int uptime) const
+{
+	const int start = uptime + (int)sampleStart;
+
+	// Wrapped loops and the start of the sample are mostly served from the loop & preload buffers
+	if (loopEnabled && (start + samplesToCopy) > loopEnd)
+		return;
+
+	if (start + samplesToCopy < internalPreloadSize)
+		return;
+
+	fileReader.prefetch(start + monolithOffset, samplesToCopy);
+}
+
 void StreamingSamplerSound::fillInternal(hlac::HiseSampleBuffer &sampleBuffer, int samplesToCopy, int uptime, int offsetInBuffer/*=0*/) const
 {
 	jassert(uptime + samplesToCopy <= sampleEnd);
@@ -993,6 +1007,21 @@ void StreamingSamplerSound::FileReader::readFromDisk(hlac::HiseSampleBuffer &buf
 }
 
 
+void StreamingSamplerSound::FileReader::prefetch(int readerPosition, int numSamples)
+{
+	if (!fileHandlesOpen || !isMonolithic())
+		return;
+
+	// This is just a hint, so skip it instead of waiting for the file handles to be opened / closed
+	if (!fileAccessLock.tryEnterRead())
+		return;
+
+	if (auto r = dynamic_cast<hlac::HlacSubSectionReader*>(normalReader.get()))
+		r->prefetch(readerPosition, numSamples);
+
+	fileAccessLock.exitRead();
+}
+
 float StreamingSamplerSound::FileReader::calculatePeakValue()
 {
 #if USE_FRONTEND
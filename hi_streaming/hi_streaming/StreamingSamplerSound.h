@@ -323,6 +323,9 @@ private:
 		/** Encapsulates all reading operations. It will use the best available reader type and opens the file handle if it is not open yet. */
 		void readFromDisk(hlac::HiseSampleBuffer &buffer, int startSample, int numSamples, int readerPosition, bool useMemoryMappedReader);
 
+		/** Tells the OS that the given range will be read soon (only monoliths support this at the moment). */
+		void prefetch(int readerPosition, int numSamples);
+
 		/** Call this method if you want to close the file handle. If voices are playing, it won't close it. */
 		void closeFileHandles(NotificationType notifyPool = sendNotification);
 
@@ -445,6 +448,12 @@ private:
 	*/
 	void fillSampleBuffer(hlac::HiseSampleBuffer &sampleBuffer, int samplesToCopy, int uptime) const;
 
+	/** Gives the OS a hint about the data that the next fillSampleBuffer() call will read from disk. 
+	*
+	*	This doesn't lock the sample, so it can be called for all pending read operations before they are executed.
+	*/
+	void prefetchSampleData(int samplesToCopy, int uptime) const;
+
 	// used to wrap the read process for looping
 	void fillInternal(hlac::HiseSampleBuffer &sampleBuffer, int samplesToCopy, int uptime, int offsetInBuffer = 0) const;
 
@@ -120,6 +120,8 @@ void SampleLoader::startNote(StreamingSamplerSound const *s, int startTime)
 
 	voiceCounterWasIncreased = false;
 
+	resetSlackStatistics();
+
 	entireSampleIsLoaded = s->isEntireSampleLoaded();
 
 	if (!entireSampleIsLoaded)
@@ -160,6 +162,7 @@ void SampleLoader::reset()
 void SampleLoader::clearLoader()
 {
 	sound = nullptr;
+	prefetchSound = nullptr;
 	diskUsage = 0.0f;
 	cancelled = true;
 }
@@ -330,6 +333,16 @@ bool SampleLoader::requestNewData()
 {
 	cancelled = false;
 
+	prefetchPosition = positionInSampleFile;
+	prefetchNumSamples = getNumSamplesForStreamingBuffers();
+	prefetchSound = sound.get();
+
+	if (streamingSpeed > 0.0)
+	{
+		const double numSamplesLeft = jmax<double>(0.0, (double)readBuffer.get()->getNumSamples() - readIndexDouble);
+		setDeadline(numSamplesLeft / streamingSpeed);
+	}
+
 #if KILL_VOICES_WHEN_STREAMING_IS_BLOCKED
 	if (this->isQueued())
 	{
@@ -389,6 +402,15 @@ SampleThreadPoolJob::JobStatus SampleLoader::runJob()
 	return SampleThreadPoolJob::JobStatus::jobHasFinished;
 }
 
+void SampleLoader::prefetch()
+{
+	if (cancelled || writeBufferIsBeingFilled)
+		return;
+
+	if (auto localSound = prefetchSound.get())
+		localSound->prefetchSampleData(prefetchNumSamples.get(), prefetchPosition.get());
+}
+
 size_t SampleLoader::getActualStreamingBufferSize() const
 {
 	return b1.getNumSamples() * 2 * 2;
@@ -492,6 +514,9 @@ StreamingSamplerVoice::StreamingSamplerVoice(SampleThreadPool *pool) :
 	sampleStartModValue(0)
 {
 	pitchData = nullptr;
+
+	FloatVectorOperations::clear(history[0], SincKernel::NumLeft);
+	FloatVectorOperations::clear(history[1], SincKernel::NumLeft);
 };
 
 
@@ -504,13 +529,6 @@ void StreamingSamplerVoice::startNote(int /*midiNoteNumber*/,
 
 	if (sound != nullptr && sound->getSampleLength() > 0)
 	{
-		loader.startNote(sound, sampleStartModValue);
-
-		jassert(sound != nullptr);
-		sound->wakeSound();
-
-		voiceUptime = (double)sampleStartModValue;
-
 		// You have to call setPitchFactor() before startNote().
 		jassert(uptimeDelta != 0.0);
 
@@ -520,6 +538,17 @@ void StreamingSamplerVoice::startNote(int /*midiNoteNumber*/,
 
 		constUptimeDelta = uptimeDelta;
 
+		loader.setStreamingSpeed(uptimeDelta * getSampleRate());
+		loader.startNote(sound, sampleStartModValue);
+
+		jassert(sound != nullptr);
+		sound->wakeSound();
+
+		voiceUptime = (double)sampleStartModValue;
+
+		FloatVectorOperations::clear(history[0], SincKernel::NumLeft);
+		FloatVectorOperations::clear(history[1], SincKernel::NumLeft);
+
 		isActive = true;
 
 	}
@@ -554,128 +583,6 @@ void StreamingSamplerVoice::setDebugLogger(DebugLogger* newLogger)
 static int alignedCalls = 0;
 static int unalignedCalls = 0;
 
-using SSEFloat = dsp::SIMDRegister<float>;
-
-#if 0
-struct Helpers
-{
-	static SSEFloat getSSEFloatRegister(const float* a)
-	{
-		return SSEFloat::fromRawArray(a);
-	}
-
-	static SSEFloat getSSEFloatRegister(const int16* d)
-	{
-		auto l = _mm_load_si128(reinterpret_cast<const __m128i*>(d));
-		l = _mm_cvtepi16_epi32(l);
-		return _mm_cvtepi32_ps(l);
-	}
-};
-#endif
-
-
-template <typename SignalType, bool isFloat> void interpolateMonoSamples(const SignalType* inL, const SignalType* unusedIn, const float* pitchData, float* outL, float* unusedOut, int startSample, double indexInBuffer, double uptimeDelta, int numSamples)
-{
-	ignoreUnused(unusedIn, unusedOut);
-
-	constexpr float gainFactor = isFloat ? 1.0f : (1.0f / (float)INT16_MAX);
-
-	if (pitchData != nullptr)
-	{
-		pitchData += startSample;
-
-		float indexInBufferFloat = (float)indexInBuffer;
-
-		for (int i = 0; i < numSamples; i++)
-		{
-			const int pos = int(indexInBufferFloat);
-			const float alpha = indexInBufferFloat - (float)pos;
-			const float invAlpha = 1.0f - alpha;
-
-			float l = ((float)inL[pos] * invAlpha + (float)inL[pos + 1] * alpha);
-
-			outL[i] = l * gainFactor;
-
-			jassert(*pitchData <= (float)MAX_SAMPLER_PITCH);
-
-			indexInBufferFloat += pitchData[i];
-		}
-	}
-	else
-	{
-		float indexInBufferFloat = (float)indexInBuffer;
-		const float uptimeDeltaFloat = (float)uptimeDelta;
-
-		while (numSamples > 0)
-		{
-			const int pos = int(indexInBufferFloat);
-			const float alpha = indexInBufferFloat - (float)pos;
-			const float invAlpha = 1.0f - alpha;
-
-			float l = ((float)inL[pos] * invAlpha + (float)inL[pos + 1] * alpha);
-
-			*outL++ = l * gainFactor;
-
-			indexInBufferFloat += uptimeDeltaFloat;
-
-			numSamples--;
-		}
-	}
-}
-
-template <typename SignalType, bool isFloat> void interpolateStereoSamples(const SignalType* inL, const SignalType* inR, const float* pitchData, float* outL, float* outR, int startSample, double indexInBuffer, double uptimeDelta, int numSamples)
-{
-	constexpr float gainFactor = isFloat ? 1.0f : (1.0f / (float)INT16_MAX);
-
-	if (pitchData != nullptr)
-	{
-		pitchData += startSample;
-
-		float indexInBufferFloat = (float)indexInBuffer;
-
-		for (int i = 0; i < numSamples; i++)
-		{
-			const int pos = int(indexInBufferFloat);
-			const float alpha = indexInBufferFloat - (float)pos;
-			const float invAlpha = 1.0f - alpha;
-
-			float l = ((float)inL[pos] * invAlpha + (float)inL[pos + 1] * alpha);
-			float r = ((float)inR[pos] * invAlpha + (float)inR[pos + 1] * alpha);
-
-			outL[i] = l * gainFactor;
-			outR[i] = r * gainFactor;
-
-			jassert(*pitchData <= (float)MAX_SAMPLER_PITCH);
-
-			indexInBufferFloat += pitchData[i];
-		}
-	}
-	else
-	{
-		float indexInBufferFloat = (float)indexInBuffer;
-		const float uptimeDeltaFloat = (float)uptimeDelta;
-
-		while (numSamples > 0)
-		{
-			const int pos = int(indexInBufferFloat);
-			const float alpha = indexInBufferFloat - (float)pos;
-			const float invAlpha = 1.0f - alpha;
-
-			float l = ((float)inL[pos] * invAlpha + (float)inL[pos + 1] * alpha);
-			float r = ((float)inR[pos] * invAlpha + (float)inR[pos + 1] * alpha);
-
-			*outL++ = l * gainFactor;
-			*outR++ = r * gainFactor;
-
-			indexInBufferFloat += uptimeDeltaFloat;
-
-			numSamples--;
-		}
-	}
-}
-
-
-
 void StreamingSamplerVoice::renderNextBlock(AudioSampleBuffer &outputBuffer, int startSample, int numSamples)
 {
 	const StreamingSamplerSound *sound = loader.getLoadedSound();
@@ -695,8 +602,11 @@ void StreamingSamplerVoice::renderNextBlock(AudioSampleBuffer &outputBuffer, int
 
 		jassert(tempVoiceBuffer != nullptr);
 
+		const bool useLinearInterpolation = interpolationMode == SampleInterpolationMode::Linear;
+		const double padding = useLinearInterpolation ? 0.0 : (double)InterpolationPadding;
+
 		// Copy the not resampled values into the voice buffer.
-		StereoChannelData data = loader.fillVoiceBuffer(*tempVoiceBuffer, pitchCounter + startAlpha);
+		StereoChannelData data = loader.fillVoiceBuffer(*tempVoiceBuffer, pitchCounter + startAlpha + padding);
 
 		float* outL = outputBuffer.getWritePointer(0, startSample);
 		float* outR = outputBuffer.getWritePointer(1, startSample);
@@ -710,12 +620,19 @@ void StreamingSamplerVoice::renderNextBlock(AudioSampleBuffer &outputBuffer, int
 
 		double indexInBuffer = startAlpha;
 
-		if (data.b->isFloatingPoint())
+		if (!useLinearInterpolation)
+		{
+			if (interpolationMode == SampleInterpolationMode::Hermite)
+				renderWithKernel<HermiteKernel>(data, outL, outR, startSample, numSamples, startAlpha);
+			else
+				renderWithKernel<SincKernel>(data, outL, outR, startSample, numSamples, startAlpha);
+		}
+		else if (data.b->isFloatingPoint())
 		{
 			const float* const inL = static_cast<const float*>(data.b->getReadPointer(0, data.offsetInBuffer));
 			const float* const inR = static_cast<const float*>(data.b->getReadPointer(1, data.offsetInBuffer));
 
-			interpolateStereoSamples<float, true>(inL, inR, pitchData, outL, outR, startSample, indexInBuffer, uptimeDelta, numSamples);
+			LinearInterpolator::interpolateStereo<float, true>(inL, inR, pitchData, outL, outR, startSample, indexInBuffer, uptimeDelta, numSamples);
 		}
 		else
 		{
@@ -739,20 +656,20 @@ void StreamingSamplerVoice::renderNextBlock(AudioSampleBuffer &outputBuffer, int
 
 					data.b->convertToFloatWithNormalisation(d, data.b->getNumChannels(), data.offsetInBuffer, numSamplesThisTime);
 
-					interpolateStereoSamples<float, true>(inL_f, inR_f, pitchData, outL, outR, startSample, indexInBuffer, uptimeDelta, numSamples);
+					LinearInterpolator::interpolateStereo<float, true>(inL_f, inR_f, pitchData, outL, outR, startSample, indexInBuffer, uptimeDelta, numSamples);
 				}
 				else
 				{
 					data.b->convertToFloatWithNormalisation(d, 1, data.offsetInBuffer, numSamplesThisTime);
 
-					interpolateMonoSamples<float, true>(inL_f, nullptr, pitchData, outL, nullptr, startSample, indexInBuffer, uptimeDelta, numSamples);
+					LinearInterpolator::interpolateMono<float, true>(inL_f, nullptr, pitchData, outL, nullptr, startSample, indexInBuffer, uptimeDelta, numSamples);
 
 					memcpy(outR, outL, sizeof(float) * numSamples);
 				}
 			}
 			else
 			{
-				interpolateStereoSamples<int16, false>(inL, inR, pitchData, outL, outR, startSample, indexInBuffer, uptimeDelta, numSamples);
+				LinearInterpolator::interpolateStereo<int16, false>(inL, inR, pitchData, outL, outR, startSample, indexInBuffer, uptimeDelta, numSamples);
 			}
 		}
 
@@ -775,6 +692,9 @@ void StreamingSamplerVoice::renderNextBlock(AudioSampleBuffer &outputBuffer, int
 		voiceUptime += pitchCounter;
 #endif
 
+		if (numSamplesFixed > 0)
+			loader.setStreamingSpeed(pitchCounter / (double)numSamplesFixed * getSampleRate());
+
 		if (!loader.advanceReadIndex(voiceUptime))
 		{
 #if LOG_SAMPLE_RENDERING
@@ -802,6 +722,75 @@ void StreamingSamplerVoice::renderNextBlock(AudioSampleBuffer &outputBuffer, int
 	}
 };
 
+template <class KernelType> void StreamingSamplerVoice::renderWithKernel(const StereoChannelData& data, float* outL, float* outR, int startSample, int numSamples, double startAlpha)
+{
+	constexpr int numHistory = KernelType::NumLeft;
+
+	// The kernels need contiguous float data with the history in front of the current read position
+	const int numSourceSamples = (int)std::ceil(pitchCounter + startAlpha) + KernelType::NumRight + 1;
+	const int numTotal = numHistory + numSourceSamples;
+
+	if (numTotal > kernelBuffer.getNumSamples())
+	{
+		// prepareToPlay() wasn't called with the correct block size...
+		jassertfalse;
+		FloatVectorOperations::clear(outL, numSamples);
+		FloatVectorOperations::clear(outR, numSamples);
+		return;
+	}
+
+	float* l = kernelBuffer.getWritePointer(0);
+	float* r = kernelBuffer.getWritePointer(1);
+
+	FloatVectorOperations::copy(l, history[0], numHistory);
+	FloatVectorOperations::copy(r, history[1], numHistory);
+
+	auto b = data.b;
+	bool isStereo = true;
+
+	if (b->isFloatingPoint())
+	{
+		FloatVectorOperations::copy(l + numHistory, static_cast<const float*>(b->getReadPointer(0, data.offsetInBuffer)), numSourceSamples);
+		FloatVectorOperations::copy(r + numHistory, static_cast<const float*>(b->getReadPointer(1, data.offsetInBuffer)), numSourceSamples);
+	}
+	else if (b->usesNormalisation())
+	{
+		float* d[2] = { l + numHistory, r + numHistory };
+
+		isStereo = b->getNumChannels() == 2 && !b->useOneMap;
+		b->convertToFloatWithNormalisation(d, isStereo ? 2 : 1, data.offsetInBuffer, numSourceSamples);
+	}
+	else
+	{
+		const float gainFactor = 1.0f / (float)INT16_MAX;
+
+		InterpolatorHelpers::convertInt16ToFloat(static_cast<const int16*>(b->getReadPointer(0, data.offsetInBuffer)), l + numHistory, numSourceSamples, gainFactor);
+		InterpolatorHelpers::convertInt16ToFloat(static_cast<const int16*>(b->getReadPointer(1, data.offsetInBuffer)), r + numHistory, numSourceSamples, gainFactor);
+	}
+
+	const float* pitchDataThisBlock = pitchData != nullptr ? pitchData + startSample : nullptr;
+
+	const double maxPitchRatio = pitchDataThisBlock != nullptr ? (double)FloatVectorOperations::findMaximum(pitchDataThisBlock, numSamples) : uptimeDelta;
+
+	if (isStereo)
+	{
+		KernelInterpolator<KernelType>::template process<true>(l + numHistory, r + numHistory, pitchDataThisBlock, outL, outR, startAlpha, uptimeDelta, numSamples, maxPitchRatio);
+	}
+	else
+	{
+		KernelInterpolator<KernelType>::template process<false>(l + numHistory, nullptr, pitchDataThisBlock, outL, nullptr, startAlpha, uptimeDelta, numSamples, maxPitchRatio);
+		FloatVectorOperations::copy(outR, outL, numSamples);
+	}
+
+	// Store the samples before the read position of the next block.
+	const int nextReadIndex = (int)(voiceUptime + pitchCounter) - (int)voiceUptime;
+
+	jassert(nextReadIndex + numHistory <= numTotal);
+
+	FloatVectorOperations::copy(history[0], l + nextReadIndex, numHistory);
+	FloatVectorOperations::copy(history[1], isStereo ? r + nextReadIndex : l + nextReadIndex, numHistory);
+}
+
 void StreamingSamplerVoice::setPitchFactor(int midiNote, int rootNote, StreamingSamplerSound *sound, double globalPitchFactor)
 {
 	if (midiNote == rootNote)
@@ -820,6 +809,8 @@ void StreamingSamplerVoice::prepareToPlay(double sampleRate, int samplesPerBlock
 	{
 		loader.assertBufferSize(samplesPerBlock * MAX_SAMPLER_PITCH);
 
+		kernelBuffer.setSize(2, samplesPerBlock * MAX_SAMPLER_PITCH + SincKernel::NumLeft + SincKernel::NumRight + 2);
+
 		setCurrentPlaybackSampleRate(sampleRate);
 	}
 }
@@ -857,9 +848,12 @@ void StreamingSamplerVoice::initTemporaryVoiceBuffer(hlac::HiseSampleBuffer* buf
 	// The channel amount must be set correctly in the constructor
 	jassert(bufferToUse->getNumChannels() > 0);
 
-	if (bufferToUse->getNumSamples() < samplesPerBlock*MAX_SAMPLER_PITCH)
+	// Add some samples for the lookahead of the higher order interpolators
+	const int numSamples = samplesPerBlock * MAX_SAMPLER_PITCH + InterpolationPadding + 1;
+
+	if (bufferToUse->getNumSamples() < numSamples)
 	{
-		bufferToUse->setSize(bufferToUse->getNumChannels(), samplesPerBlock*MAX_SAMPLER_PITCH);
+		bufferToUse->setSize(bufferToUse->getNumChannels(), numSamples);
 		bufferToUse->clear();
 	}
 }
@@ -69,6 +69,16 @@ public:
 	*/
 	JobStatus runJob() override;
 
+	/** The sample loader reads the data while holding the sample lock of the sound, so it can be executed on any worker thread. */
+	bool canRunOnWorkerThread() const noexcept override { return true; }
+
+	/** Sends a prefetch hint for the data that will be read into the inactive buffer.
+	*
+	*	This is called from the worker thread while the audio thread keeps running the voice, so it only
+	*	uses the values that were snapshotted in requestNewData().
+	*/
+	void prefetch() override;
+
 	size_t getActualStreamingBufferSize() const;
 
 	void setStreamingBufferDataType(bool shouldBeFloat);
@@ -78,6 +88,13 @@ public:
 	/** Advances the read index and returns `false` if the streaming thread is blocked. */
 	bool advanceReadIndex(double uptime);
 
+	/** Sets the amount of source samples that are consumed per second.
+	*
+	*	This is used to calculate the deadline of the next read operation (the time until the active buffer runs out),
+	*	so that the SampleThreadPool can serve the voices that are about to underrun first.
+	*/
+	void setStreamingSpeed(double sourceSamplesPerSecond) noexcept { streamingSpeed = sourceSamplesPerSecond; }
+
 	/** Call this whenever a sound was started.
 	*
 	*	This will set the read pointer to the preload buffer of the StreamingSamplerSound and start the background reading.
@@ -185,6 +202,14 @@ private:
 	Atomic<float> diskUsage;
 	double lastCallToRequestData;
 
+	double streamingSpeed = 0.0;
+
+	// the state for prefetch() as seen by the last call to requestNewData()
+
+	Atomic<StreamingSamplerSound const *> prefetchSound;
+	Atomic<int> prefetchPosition;
+	Atomic<int> prefetchNumSamples;
+
 	// just a pointer to the used pool
 	SampleThreadPool *backgroundPool;
 
@@ -253,6 +278,14 @@ public:
 	*/
 	double getDiskUsage() { return loader.getDiskUsage(); };
 
+	/** Sets the interpolation algorithm. You have to call this before startNote() (the mode can't be changed while the voice is playing). */
+	void setInterpolationMode(SampleInterpolationMode newMode) noexcept { interpolationMode = newMode; }
+
+	SampleInterpolationMode getInterpolationMode() const noexcept { return interpolationMode; }
+
+	/** Returns the slack statistics of the streaming jobs since the voice was started. */
+	SampleThreadPool::Job::SlackStatistics getStreamingSlackStatistics() const noexcept { return loader.getSlackStatistics(); }
+
 	/** Initializes its sampleBuffer. You have to call this manually, since there is no base class function. */
 	void prepareToPlay(double sampleRate, int samplesPerBlock);
 
@@ -287,8 +320,21 @@ public:
 
 private:
 
+	/** The amount of samples that the higher order interpolators need in addition to the linear interpolation. */
+	static constexpr int InterpolationPadding = SincKernel::NumRight + 1;
+
+	template <class KernelType> void renderWithKernel(const StereoChannelData& data, float* outL, float* outR, int startSample, int numSamples, double startAlpha);
+
 	double pitchCounter = 0.0;
 
+	SampleInterpolationMode interpolationMode = SampleInterpolationMode::Linear;
+
+	// The last samples before the current read position (the higher order kernels need them)
+	float history[2][SincKernel::NumLeft];
+
+	// The contiguous float data (history + source samples) for the higher order kernels
+	AudioSampleBuffer kernelBuffer;
+
 	hlac::HiseSampleBuffer* tvb = nullptr;
 
 	const float *pitchData;
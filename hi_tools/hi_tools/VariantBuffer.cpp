@@ -222,6 +222,288 @@ const float & VariantBuffer::operator[](int sampleIndex) const
 	return buffer.getReadPointer(0)[sampleIndex];
 }
 
+VariantBuffer::WindowType VariantBuffer::getWindowType(const String& name)
+{
+	static const StringArray names = { "Rectangle", "Triangle", "Hann", "Hamming", "Blackman", "BlackmanHarris" };
+
+	const int index = names.indexOf(name, true);
+
+	CHECK_CONDITION(index != -1, "Unknown window type: " + name);
+
+	return (WindowType)index;
+}
+
+void VariantBuffer::addWithMultiply(const VariantBuffer &source, float gain)
+{
+	CHECK_CONDITION((source.size >= size), "second buffer too small: " + String(source.size));
+
+	FloatVectorOperations::addWithMultiply(buffer.getWritePointer(0), source.buffer.getReadPointer(0), FloatSanitizers::sanitizeFloatNumber(gain), size);
+}
+
+void VariantBuffer::addWithMultiply(const VariantBuffer &source, const VariantBuffer &gain)
+{
+	CHECK_CONDITION((source.size >= size && gain.size >= size), "second buffer too small: " + String(jmin(source.size, gain.size)));
+
+	FloatVectorOperations::addWithMultiply(buffer.getWritePointer(0), source.buffer.getReadPointer(0), gain.buffer.getReadPointer(0), size);
+}
+
+void VariantBuffer::applyGainRamp(float startGain, float endGain)
+{
+	if (size > 0)
+		buffer.applyGainRamp(0, 0, size, FloatSanitizers::sanitizeFloatNumber(startGain), FloatSanitizers::sanitizeFloatNumber(endGain));
+}
+
+void VariantBuffer::fillRamp(float startValue, float endValue)
+{
+	startValue = FloatSanitizers::sanitizeFloatNumber(startValue);
+	endValue = FloatSanitizers::sanitizeFloatNumber(endValue);
+
+	const float delta = size > 1 ? (endValue - startValue) / (float)(size - 1) : 0.0f;
+	float* d = buffer.getWritePointer(0);
+
+	for (int i = 0; i < size; i++)
+		d[i] = startValue + delta * (float)i;
+}
+
+void VariantBuffer::makeAbsolute()
+{
+	FloatVectorOperations::abs(buffer.getWritePointer(0), buffer.getReadPointer(0), size);
+}
+
+void VariantBuffer::clamp(float minValue, float maxValue)
+{
+	CHECK_CONDITION(minValue <= maxValue, "Invalid range: " + String(minValue) + " - " + String(maxValue));
+
+	FloatVectorOperations::clip(buffer.getWritePointer(0), buffer.getReadPointer(0), minValue, maxValue, size);
+}
+
+float VariantBuffer::getMagnitude(int startSample, int numSamples) const
+{
+	if (numSamples == -1)
+		numSamples = size - startSample;
+
+	CHECK_CONDITION(startSample >= 0 && numSamples >= 0 && startSample + numSamples <= size, "Invalid range: " + String(startSample) + " - " + String(startSample + numSamples));
+
+	return numSamples > 0 ? buffer.getMagnitude(0, startSample, numSamples) : 0.0f;
+}
+
+float VariantBuffer::getRMSLevel(int startSample, int numSamples) const
+{
+	if (numSamples == -1)
+		numSamples = size - startSample;
+
+	CHECK_CONDITION(startSample >= 0 && numSamples >= 0 && startSample + numSamples <= size, "Invalid range: " + String(startSample) + " - " + String(startSample + numSamples));
+
+	return numSamples > 0 ? buffer.getRMSLevel(0, startSample, numSamples) : 0.0f;
+}
+
+void VariantBuffer::copyFrom(const VariantBuffer &source, int sourceOffset, int destinationOffset, int numSamples)
+{
+	if (numSamples == -1)
+		numSamples = jmin(source.size - sourceOffset, size - destinationOffset);
+
+	CHECK_CONDITION(sourceOffset >= 0 && numSamples >= 0 && sourceOffset + numSamples <= source.size, "Invalid source range: " + String(sourceOffset) + " - " + String(sourceOffset + numSamples));
+	CHECK_CONDITION(destinationOffset >= 0 && destinationOffset + numSamples <= size, "Invalid destination range: " + String(destinationOffset) + " - " + String(destinationOffset + numSamples));
+
+	if (numSamples == 0)
+		return;
+
+	float* d = buffer.getWritePointer(0, destinationOffset);
+	const float* s = source.buffer.getReadPointer(0, sourceOffset);
+
+	// Referenced buffers might point to the same data
+	if (d < s + numSamples && s < d + numSamples)
+		memmove(d, s, sizeof(float) * (size_t)numSamples);
+	else
+		FloatVectorOperations::copy(d, s, numSamples);
+}
+
+void VariantBuffer::applyTable(const VariantBuffer &table)
+{
+	CHECK_CONDITION(table.size >= 2, "table buffer too small: " + String(table.size));
+
+	const float* t = table.buffer.getReadPointer(0);
+	float* d = buffer.getWritePointer(0);
+
+	const int lastIndex = table.size - 1;
+	const float maxIndex = (float)lastIndex;
+
+	for (int i = 0; i < size; i++)
+	{
+		const float index = jlimit(0.0f, 1.0f, d[i]) * maxIndex;
+		const int i0 = jmin((int)index, lastIndex - 1);
+		const float alpha = index - (float)i0;
+
+		d[i] = t[i0] + alpha * (t[i0 + 1] - t[i0]);
+	}
+}
+
+void VariantBuffer::applyWindow(WindowType type)
+{
+	if (size < 2 || type == WindowType::Rectangle)
+		return;
+
+	float* d = buffer.getWritePointer(0);
+	const double delta = 1.0 / (double)(size - 1);
+
+	for (int i = 0; i < size; i++)
+	{
+		const double phase = (double)i * delta;
+		const double c1 = std::cos(double_Pi * 2.0 * phase);
+
+		double w;
+
+		switch (type)
+		{
+		case WindowType::Triangle:		 w = 1.0 - std::abs(2.0 * phase - 1.0); break;
+		case WindowType::Hann:			 w = 0.5 - 0.5 * c1; break;
+		case WindowType::Hamming:		 w = 0.54 - 0.46 * c1; break;
+		case WindowType::Blackman:		 w = 0.42 - 0.5 * c1 + 0.08 * std::cos(double_Pi * 4.0 * phase); break;
+		case WindowType::BlackmanHarris: w = 0.35875 - 0.48829 * c1 + 0.14128 * std::cos(double_Pi * 4.0 * phase) - 0.01168 * std::cos(double_Pi * 6.0 * phase); break;
+		case WindowType::Rectangle:
+		case WindowType::numWindowTypes:
+		default:						 w = 1.0; break;
+		}
+
+		d[i] *= (float)w;
+	}
+}
+
+/** The methods that can be called on a buffer object in a script.
+*
+*	They are stored in the factory (which is registered as "Buffer" in the root object) so that the buffer objects don't need a method table.
+*	They are kept out of the factory's properties so that they don't show up as static methods.
+*/
+struct VariantBuffer::Factory::BufferMethods
+{
+	using Args = const var::NativeFunctionArgs&;
+
+	static VariantBuffer& getThis(Args a)
+	{
+		VariantBuffer* b = a.thisObject.getBuffer();
+		CHECK_CONDITION(b != nullptr, "This method must be called on a buffer");
+		return *b;
+	}
+
+	static const var& get(Args a, int index)
+	{
+		CHECK_CONDITION(index < a.numArguments, "argument amount mismatch: " + String(a.numArguments));
+		return a.arguments[index];
+	}
+
+	static int getOptionalInt(Args a, int index, int defaultValue)
+	{
+		return index < a.numArguments ? (int)a.arguments[index] : defaultValue;
+	}
+
+	static VariantBuffer& getBuffer(Args a, int index)
+	{
+		VariantBuffer* b = get(a, index).getBuffer();
+		CHECK_CONDITION(b != nullptr, "argument " + String(index + 1) + " is not a buffer");
+		return *b;
+	}
+
+	static var add(Args a)
+	{
+		const var& v = get(a, 0);
+
+		if (v.isBuffer())
+			getThis(a) += *v.getBuffer();
+		else
+			getThis(a) += (float)v;
+
+		return var();
+	}
+
+	static var sub(Args a)
+	{
+		const var& v = get(a, 0);
+
+		if (v.isBuffer())
+			getThis(a) -= *v.getBuffer();
+		else
+			getThis(a) -= (float)v;
+
+		return var();
+	}
+
+	static var mul(Args a)
+	{
+		const var& v = get(a, 0);
+
+		if (v.isBuffer())
+			getThis(a) *= *v.getBuffer();
+		else
+			getThis(a) *= (float)v;
+
+		return var();
+	}
+
+	static var mac(Args a)
+	{
+		const var& gain = get(a, 1);
+
+		if (gain.isBuffer())
+			getThis(a).addWithMultiply(getBuffer(a, 0), *gain.getBuffer());
+		else
+			getThis(a).addWithMultiply(getBuffer(a, 0), (float)gain);
+
+		return var();
+	}
+
+	static var applyRamp(Args a)
+	{
+		getThis(a).applyGainRamp((float)get(a, 0), (float)get(a, 1));
+		return var();
+	}
+
+	static var fillRamp(Args a)
+	{
+		getThis(a).fillRamp((float)get(a, 0), (float)get(a, 1));
+		return var();
+	}
+
+	static var abs(Args a)
+	{
+		getThis(a).makeAbsolute();
+		return var();
+	}
+
+	static var clamp(Args a)
+	{
+		getThis(a).clamp((float)get(a, 0), (float)get(a, 1));
+		return var();
+	}
+
+	static var getMagnitude(Args a)
+	{
+		return getThis(a).getMagnitude(getOptionalInt(a, 0, 0), getOptionalInt(a, 1, -1));
+	}
+
+	static var getRMSLevel(Args a)
+	{
+		return getThis(a).getRMSLevel(getOptionalInt(a, 0, 0), getOptionalInt(a, 1, -1));
+	}
+
+	static var copyFrom(Args a)
+	{
+		getThis(a).copyFrom(getBuffer(a, 0), getOptionalInt(a, 1, 0), getOptionalInt(a, 2, 0), getOptionalInt(a, 3, -1));
+		return var();
+	}
+
+	static var lookup(Args a)
+	{
+		getThis(a).applyTable(getBuffer(a, 0));
+		return var();
+	}
+
+	static var applyWindow(Args a)
+	{
+		getThis(a).applyWindow(getWindowType(get(a, 0).toString()));
+		return var();
+	}
+};
+
 VariantBuffer::Factory::Factory(int stackSize_) :
 stackSize(stackSize_)
 {
@@ -234,6 +516,20 @@ stackSize(stackSize_)
 
 	setMethod("create", create);
 	setMethod("referTo", referTo);
+
+	bufferMethods.set("add", var(BufferMethods::add));
+	bufferMethods.set("sub", var(BufferMethods::sub));
+	bufferMethods.set("mul", var(BufferMethods::mul));
+	bufferMethods.set("mac", var(BufferMethods::mac));
+	bufferMethods.set("applyRamp", var(BufferMethods::applyRamp));
+	bufferMethods.set("fillRamp", var(BufferMethods::fillRamp));
+	bufferMethods.set("abs", var(BufferMethods::abs));
+	bufferMethods.set("clamp", var(BufferMethods::clamp));
+	bufferMethods.set("getMagnitude", var(BufferMethods::getMagnitude));
+	bufferMethods.set("getRMSLevel", var(BufferMethods::getRMSLevel));
+	bufferMethods.set("copyFrom", var(BufferMethods::copyFrom));
+	bufferMethods.set("lookup", var(BufferMethods::lookup));
+	bufferMethods.set("applyWindow", var(BufferMethods::applyWindow));
 }
 
 VariantBuffer::Factory::~Factory()
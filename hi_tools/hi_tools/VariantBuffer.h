@@ -157,7 +157,55 @@ public:
 	var getSample(int sampleIndex);
 	void setSample(int sampleIndex, float newValue);
 
-	
+	// ================================================================================================================
+
+	enum class WindowType
+	{
+		Rectangle = 0,
+		Triangle,
+		Hann,
+		Hamming,
+		Blackman,
+		BlackmanHarris,
+		numWindowTypes
+	};
+
+	/** Returns the window type for the given name ("Hann", "Hamming", ...). */
+	static WindowType getWindowType(const String& name);
+
+	/** Adds the other buffer multiplied with the gain factor. */
+	void addWithMultiply(const VariantBuffer &source, float gain);
+
+	/** Adds the product of the other buffer and the gain buffer. */
+	void addWithMultiply(const VariantBuffer &source, const VariantBuffer &gain);
+
+	/** Multiplies the samples with a linear ramp from startGain to endGain. */
+	void applyGainRamp(float startGain, float endGain);
+
+	/** Fills the buffer with a linear ramp from startValue to endValue. */
+	void fillRamp(float startValue, float endValue);
+
+	/** Replaces every sample with its absolute value. */
+	void makeAbsolute();
+
+	/** Limits the samples to the given range. */
+	void clamp(float minValue, float maxValue);
+
+	/** Returns the highest absolute value in the given range (use -1 for the whole buffer). */
+	float getMagnitude(int startSample=0, int numSamples=-1) const;
+
+	/** Returns the RMS level in the given range (use -1 for the whole buffer). */
+	float getRMSLevel(int startSample=0, int numSamples=-1) const;
+
+	/** Copies a part of the other buffer into this buffer. */
+	void copyFrom(const VariantBuffer &source, int sourceOffset, int destinationOffset, int numSamples);
+
+	/** Uses the samples (0.0 ... 1.0) as index into the table buffer and replaces them with the interpolated table value. */
+	void applyTable(const VariantBuffer &table);
+
+	/** Multiplies the buffer with the given window function. */
+	void applyWindow(WindowType type);
+
 	class Factory : public DynamicObject
 	{
 	public:
@@ -168,8 +216,17 @@ public:
 		static var create(const var::NativeFunctionArgs &args);
 		static var referTo(const var::NativeFunctionArgs &args);
 
+		/** Returns the method that can be called on a buffer object or nullptr if there is no method with this name.
+		*
+		*	These methods are not part of the factory's API, so Buffer.add() is not a valid call. */
+		const var* getBufferMethod(const Identifier& methodName) const { return bufferMethods.getVarPointer(methodName); }
+
 	private:
 
+		struct BufferMethods;
+
+		NamedValueSet bufferMethods;
+
 		VariantBuffer *getFreeVariantBuffer();
 
 		const int stackSize;
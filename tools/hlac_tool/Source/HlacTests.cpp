@@ -2024,3 +2024,320 @@ private:
 };
 
 static FormatTest formatTest; 
+
+
+class SIMDDecodingTest : public UnitTest
+{
+public:
+
+	typedef BitCompressors::SIMD::InstructionSet InstructionSet;
+
+	SIMDDecodingTest() :
+		UnitTest("Testing SIMD decoding")
+	{}
+
+	void runTest() override
+	{
+		const uint8 bitDepths[] = { 1, 2, 4, 6, 8, 10, 12, 14, 16 };
+
+		for (auto bitDepth : bitDepths)
+			testBitDepth(bitDepth);
+
+		testDiffHelpers();
+
+		BitCompressors::SIMD::setInstructionSet(BitCompressors::SIMD::getAvailableInstructionSet());
+	}
+
+private:
+
+	void testBitDepth(uint8 bitDepth)
+	{
+		beginTest("Testing SIMD decoding with bit rate " + String(bitDepth));
+
+		BitCompressors::Collection collection;
+		auto compressor = collection.getSuitableCompressorForBitRate(bitDepth);
+
+		const int maxValue = bitDepth == 1 ? 1 : (1 << (bitDepth - 1)) - 1;
+		const int minValue = bitDepth == 1 ? 0 : -maxValue;
+
+		for (int i = 0; i < 50; i++)
+		{
+			// Use odd sizes so that the scalar code has to process the remaining values
+			const int numValues = i == 0 ? COMPRESSION_BLOCK_SIZE : r.nextInt(Range<int>(1, 600));
+
+			IntBuffer input(numValues);
+
+			for (int j = 0; j < numValues; j++)
+				input.getWritePointer()[j] = (int16)r.nextInt(Range<int>(minValue, maxValue + 1));
+
+			MemoryBlock mb((size_t)compressor->getByteAmount(numValues), true);
+			auto packedData = static_cast<uint8*>(mb.getData());
+
+			compressor->compress(packedData, input.getReadPointer(), numValues);
+
+			for (int s = 0; s <= (int)BitCompressors::SIMD::getAvailableInstructionSet(); s++)
+			{
+				BitCompressors::SIMD::setInstructionSet((InstructionSet)s);
+
+				IntBuffer output(numValues);
+				compressor->decompress(output.getWritePointer(), packedData, numValues);
+
+				const bool equal = memcmp(input.getReadPointer(), output.getReadPointer(), sizeof(int16) * numValues) == 0;
+
+				expect(equal, "Mismatch with " + BitCompressors::SIMD::getInstructionSetName((InstructionSet)s) + " for " + String(numValues) + " values");
+			}
+		}
+	}
+
+	void testDiffHelpers()
+	{
+		beginTest("Testing SIMD diff helpers");
+
+		for (int i = 3; i < 11; i++)
+		{
+			const int numFullValues = (1 << i) + 1;
+			const int numSamples = 4 * (numFullValues - 1);
+			const int numErrorValues = CompressionHelpers::Diff::getNumErrorValues(numSamples);
+
+			IntBuffer fullValues(numFullValues);
+			IntBuffer errorValues(numErrorValues);
+
+			for (int j = 0; j < numFullValues; j++)
+				fullValues.getWritePointer()[j] = (int16)r.nextInt(Range<int>(-32767, 32768));
+
+			for (int j = 0; j < numErrorValues; j++)
+				errorValues.getWritePointer()[j] = (int16)r.nextInt(Range<int>(-32767, 32768));
+
+			IntBuffer expected = decodeDiff(InstructionSet::Scalar, fullValues, errorValues, numSamples);
+
+			for (int s = 1; s <= (int)BitCompressors::SIMD::getAvailableInstructionSet(); s++)
+			{
+				IntBuffer actual = decodeDiff((InstructionSet)s, fullValues, errorValues, numSamples);
+
+				const bool equal = memcmp(expected.getReadPointer(), actual.getReadPointer(), sizeof(int16) * numSamples) == 0;
+
+				expect(equal, "Diff mismatch with " + BitCompressors::SIMD::getInstructionSetName((InstructionSet)s) + " for " + String(numSamples) + " samples");
+			}
+		}
+	}
+
+	IntBuffer decodeDiff(InstructionSet s, const IntBuffer& fullValues, const IntBuffer& errorValues, int numSamples)
+	{
+		BitCompressors::SIMD::setInstructionSet(s);
+
+		IntBuffer b(numSamples);
+
+		CompressionHelpers::Diff::distributeFullSamples(b, reinterpret_cast<const uint16*>(fullValues.getReadPointer()), fullValues.size);
+		CompressionHelpers::Diff::addErrorSignal(b, reinterpret_cast<const uint16*>(errorValues.getReadPointer()), errorValues.size);
+
+		return b;
+	}
+
+	Random r;
+};
+
+static SIMDDecodingTest simdDecodingTest;
+
+
+class ParallelEncodingTest : public UnitTest
+{
+public:
+
+	ParallelEncodingTest() :
+		UnitTest("Testing parallel HLAC encoding")
+	{}
+
+	void runTest() override
+	{
+		beginTest("Testing parallel encoding of multiple files");
+
+		OwnedArray<AudioSampleBuffer> files;
+
+		for (int i = 0; i < 8; i++)
+		{
+			const int numSamples = r.nextInt(Range<int>(1000, 60000));
+			const auto type = (CodecTest::SignalType)r.nextInt((int)CodecTest::SignalType::numSignalTypes);
+
+			files.add(new AudioSampleBuffer(CodecTest::createTestSignal(numSamples, 2, type, 0.8f)));
+		}
+
+		ThreadPool pool(4);
+
+		auto serialData = encode(files, nullptr);
+		auto parallelData = encode(files, &pool);
+
+		expectEquals<int>((int)parallelData.getSize(), (int)serialData.getSize(), "Size mismatch");
+
+		auto serialBuffer = decode(serialData);
+		auto parallelBuffer = decode(parallelData);
+
+		expectEquals<int>(parallelBuffer.getNumSamples(), serialBuffer.getNumSamples(), "Length mismatch");
+
+		for (int c = 0; c < 2; c++)
+		{
+			const bool equal = memcmp(serialBuffer.getReadPointer(c), parallelBuffer.getReadPointer(c), sizeof(float) * serialBuffer.getNumSamples()) == 0;
+			expect(equal, "Sample mismatch in channel " + String(c + 1));
+		}
+	}
+
+private:
+
+	MemoryBlock encode(OwnedArray<AudioSampleBuffer>& files, ThreadPool* pool)
+	{
+		auto mos = new MemoryOutputStream();
+
+		HiseLosslessAudioFormat hlac;
+		StringPairArray empty;
+
+		ScopedPointer<AudioFormatWriter> writer = hlac.createWriterFor(mos, 44100.0, 2, 16, empty, 5);
+
+		auto options = HlacEncoder::CompressorOptions::getPreset(HlacEncoder::CompressorOptions::Presets::Diff);
+
+		auto hlacWriter = dynamic_cast<HiseLosslessAudioFormatWriter*>(writer.get());
+		hlacWriter->setOptions(options);
+		hlacWriter->setThreadPool(pool);
+
+		for (auto f : files)
+			writer->writeFromAudioSampleBuffer(*f, 0, f->getNumSamples());
+
+		writer->flush();
+
+		MemoryBlock mb(mos->getData(), mos->getDataSize());
+
+		writer = nullptr;
+
+		return mb;
+	}
+
+	AudioSampleBuffer decode(const MemoryBlock& mb)
+	{
+		HiseLosslessAudioFormat hlac;
+
+		ScopedPointer<AudioFormatReader> reader = hlac.createReaderFor(new MemoryInputStream(mb, false), true);
+
+		AudioSampleBuffer b(2, (int)reader->lengthInSamples);
+		reader->read(&b, 0, b.getNumSamples(), 0, true, true);
+
+		return b;
+	}
+
+	Random r;
+};
+
+static ParallelEncodingTest parallelEncodingTest;
+
+#if HLAC_USE_DECODED_BLOCK_CACHE
+
+class DecodedBlockCacheTest : public UnitTest
+{
+public:
+
+	DecodedBlockCacheTest() :
+		UnitTest("Testing the decoded block cache")
+	{}
+
+	void runTest() override
+	{
+		auto& cache = DecodedBlockCache::getInstance();
+		const auto sizeBefore = cache.getMaximumSize();
+
+		testCachedReads(1);
+		testCachedReads(2);
+
+		cache.setMaximumSize(sizeBefore);
+	}
+
+private:
+
+	void testCachedReads(int numChannels)
+	{
+		beginTest("Testing cached reads with " + String(numChannels) + " channels");
+
+		auto& cache = DecodedBlockCache::getInstance();
+
+		// A quiet signal makes sure that the normalisation gets used
+		auto signal = CodecTest::createTestSignal(100000, numChannels, CodecTest::SignalType::MixedSine, 0.05f);
+		auto mb = encode(signal);
+
+		HiseLosslessAudioFormat hlac;
+		ScopedPointer<AudioFormatReader> reader = hlac.createReaderFor(new MemoryInputStream(mb, false), true);
+
+		Array<Range<int>> ranges;
+
+		for (int i = 0; i < 16; i++)
+		{
+			const int start = r.nextInt(signal.getNumSamples() - 8192);
+			ranges.add({ start, start + r.nextInt(Range<int>(1, 8192)) });
+		}
+
+		cache.setMaximumSize(0);
+
+		Array<AudioSampleBuffer> expected;
+
+		for (auto range : ranges)
+			expected.add(read(reader, range, numChannels));
+
+		cache.setMaximumSize(4 * 1024 * 1024);
+		cache.resetStatistics();
+
+		for (int pass = 0; pass < 2; pass++)
+		{
+			for (int i = 0; i < ranges.size(); i++)
+			{
+				auto result = read(reader, ranges[i], numChannels);
+				auto error = CompressionHelpers::checkBuffersEqual(result, expected.getReference(i));
+
+				expectEquals<int>(error, 0, "Mismatch at pass " + String(pass + 1) + ", range " + String(i));
+			}
+		}
+
+		auto stats = cache.getStatistics();
+
+		expect(stats.numHits > 0, "No cache hits");
+		expect(stats.numUsedSlots > 0, "No used slots");
+		expect(stats.numBytesUsed <= stats.numBytesAllocated, "Memory statistics are wrong");
+	}
+
+	AudioSampleBuffer read(AudioFormatReader* reader, Range<int> range, int numChannels)
+	{
+		HlacSubSectionReader sub(reader, range.getStart(), range.getLength());
+
+		HiseSampleBuffer b(false, numChannels, range.getLength());
+		sub.readIntoFixedBuffer(b, 0, range.getLength(), 0);
+
+		AudioSampleBuffer result(numChannels, range.getLength());
+		b.convertToFloatWithNormalisation(result.getArrayOfWritePointers(), numChannels, 0, range.getLength());
+
+		return result;
+	}
+
+	MemoryBlock encode(AudioSampleBuffer& signal)
+	{
+		auto mos = new MemoryOutputStream();
+
+		HiseLosslessAudioFormat hlac;
+		StringPairArray empty;
+
+		ScopedPointer<AudioFormatWriter> writer = hlac.createWriterFor(mos, 44100.0, signal.getNumChannels(), 16, empty, 5);
+
+		auto options = HlacEncoder::CompressorOptions::getPreset(HlacEncoder::CompressorOptions::Presets::Diff);
+		options.normalisationMode = CompressionHelpers::NormaliseMap::RangeBasedNormalisation;
+
+		dynamic_cast<HiseLosslessAudioFormatWriter*>(writer.get())->setOptions(options);
+
+		writer->writeFromAudioSampleBuffer(signal, 0, signal.getNumSamples());
+		writer->flush();
+
+		MemoryBlock mb(mos->getData(), mos->getDataSize());
+
+		writer = nullptr;
+
+		return mb;
+	}
+
+	Random r;
+};
+
+static DecodedBlockCacheTest decodedBlockCacheTest;
+
+#endif
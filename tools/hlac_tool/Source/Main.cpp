@@ -37,7 +37,7 @@ void printHelp()
 	Logger::writeToLog("Usage: hlac_tool [MODE] [INPUT] [OUTPUT]");
 	Logger::writeToLog("");
 	Logger::writeToLog("modes: 'encode' / 'decode'");
-	Logger::writeToLog("test-modes: 'unit_test' / 'test_directory', 'memory_map_directory'");
+	Logger::writeToLog("test-modes: 'unit_test' / 'test_directory', 'memory_map_directory', 'decode_benchmark'");
 	Logger::writeToLog("(put '_' before filename to skip samples)");
 	Logger::setCurrentLogger(nullptr);
 }
@@ -97,6 +97,78 @@ void testMemoryMapPerformance(Array<File>& files)
 	}
 }
 
+/** Measures the throughput of the bit decompressors for every instruction set that is supported by this CPU. */
+int decodeBenchmark()
+{
+	typedef BitCompressors::SIMD::InstructionSet InstructionSet;
+
+	const int bitDepths[] = { 1, 2, 4, 6, 8, 10, 12, 14, 16 };
+	const int numValues = COMPRESSION_BLOCK_SIZE;
+	const double testDuration = 0.2;
+
+	Random r;
+	BitCompressors::Collection collection;
+
+	auto availableSet = BitCompressors::SIMD::getAvailableInstructionSet();
+	bool ok = true;
+
+	CompressionHelpers::AudioBufferInt16 input(numValues);
+	CompressionHelpers::AudioBufferInt16 output(numValues);
+
+	for (auto bitDepth : bitDepths)
+	{
+		auto compressor = collection.getSuitableCompressorForBitRate((uint8)bitDepth);
+
+		const int maxValue = bitDepth == 1 ? 1 : (1 << (bitDepth - 1)) - 1;
+		const int minValue = bitDepth == 1 ? 0 : -maxValue;
+
+		for (int i = 0; i < numValues; i++)
+			input.getWritePointer()[i] = (int16)(minValue + r.nextInt(maxValue - minValue + 1));
+
+		MemoryBlock mb((size_t)compressor->getByteAmount(numValues) + 16, true);
+		auto packedData = static_cast<uint8*>(mb.getData());
+
+		compressor->compress(packedData, input.getReadPointer(), numValues);
+
+		String line = String(bitDepth).paddedLeft(' ', 2) + " bit:";
+
+		for (int i = 0; i <= (int)availableSet; i++)
+		{
+			BitCompressors::SIMD::setInstructionSet((InstructionSet)i);
+
+			int numIterations = 0;
+			const auto start = Time::getHighResolutionTicks();
+			double elapsed = 0.0;
+
+			while (elapsed < testDuration)
+			{
+				for (int j = 0; j < 100; j++)
+					compressor->decompress(output.getWritePointer(), packedData, numValues);
+
+				numIterations += 100;
+				elapsed = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start);
+			}
+
+			const bool equal = memcmp(input.getReadPointer(), output.getReadPointer(), sizeof(int16) * numValues) == 0;
+			ok &= equal;
+
+			const double megaBytesPerSecond = (double)numIterations * numValues * sizeof(int16) / elapsed / 1024.0 / 1024.0;
+
+			line << "  " << BitCompressors::SIMD::getInstructionSetName((InstructionSet)i) << ": " << String((int)megaBytesPerSecond) << " MB/s";
+
+			if (!equal)
+				line << " (MISMATCH)";
+		}
+
+		Logger::writeToLog(line);
+	}
+
+	BitCompressors::SIMD::setInstructionSet(availableSet);
+
+	Logger::setCurrentLogger(nullptr);
+	return ok ? 0 : 1;
+}
+
 int decode(File input, File output)
 {
 
@@ -245,6 +317,9 @@ int main(int argc, char **argv)
 	}
 
 
+	if (mode == "decode_benchmark")
+		return decodeBenchmark();
+
 	if (mode == "memory_map_directory")
 	{
 		File root(argv[2]);